@@ -24,17 +24,24 @@
 
 #define GLM_FORCE_RADIANS
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <fstream>
 #include <iostream>
 #include <iterator>
 #include <mutex>
+#include <set>
 #include <sstream>
+#include <thread>
 #include <utility>
 
 #include <wx/datetime.h>
+#include <wx/ffile.h>
 #include <wx/filename.h>
 #include <wx/log.h>
 #include <wx/stdpaths.h>
+#include <wx/tokenzr.h>
 
 #include <boost/version.hpp>
 
@@ -63,8 +70,16 @@
 
 #define MASK_3D_CACHE "3D_CACHE"
 
+// file name of the stat index, in the cache directory
+#define STAT_INDEX_FILENAME "stat_index.txt"
+
 static std::mutex mutex3D_cache;
 static std::mutex mutex3D_cacheManager;
+static std::mutex mutex3D_statIndex;
+
+// the scene cache writer renumbers the node names with global counters, and several
+// models with the same content share their cache files
+static std::mutex mutex3D_cacheWrite;
 
 
 static bool isSHA1Same( const unsigned char* shaA, const unsigned char* shaB ) noexcept
@@ -122,6 +137,301 @@ static const wxString sha1ToWXString( const unsigned char* aSHA1Sum )
 }
 
 
+static bool sha1FromString( const wxString& aString, unsigned char* aSHA1Sum )
+{
+    if( aString.length() != 40 )
+        return false;
+
+    for( int i = 0; i < 20; ++i )
+    {
+        unsigned long byte;
+
+        if( !aString.Mid( i * 2, 2 ).ToULong( &byte, 16 ) )
+            return false;
+
+        aSHA1Sum[i] = (unsigned char) byte;
+    }
+
+    return true;
+}
+
+
+static FILE* openCacheFile( const wxString& aFileName, bool aWrite )
+{
+#ifdef _WIN32
+    return _wfopen( aFileName.wc_str(), aWrite ? L"wb" : L"rb" );
+#else
+    return fopen( aFileName.ToUTF8(), aWrite ? "wb" : "rb" );
+#endif
+}
+
+
+/*
+ * Mesh cache files (.3dm) hold the render data of a model (S3DMODEL) as flat arrays, in the
+ * native layout and byte order of the writer, so they are read without any parsing:
+ *
+ *   MESH_CACHE_HEADER
+ *   plugin tag (tagLength chars, no terminator)
+ *   SMATERIAL[materialsCount]
+ *   for each mesh:
+ *      MESH_CACHE_MESH
+ *      SFVEC3F positions[vertexSize]
+ *      SFVEC3F normals[vertexSize]      if MESH_HAS_NORMALS
+ *      SFVEC2F texcoords[vertexSize]    if MESH_HAS_TEXCOORDS
+ *      SFVEC3F colors[vertexSize]       if MESH_HAS_COLORS
+ *      unsigned int faceIdx[faceIdxSize]
+ *
+ * Files written on a machine with another layout are rejected by the header check.
+ */
+#define MESH_CACHE_VERSION  1
+#define MESH_HAS_NORMALS    0x01
+#define MESH_HAS_TEXCOORDS  0x02
+#define MESH_HAS_COLORS     0x04
+
+static const char meshCacheMagic[8] = { 'K', 'I', 'C', 'A', 'D', '3', 'D', 'M' };
+
+struct MESH_CACHE_HEADER
+{
+    char     magic[8];
+    uint32_t version;
+    uint32_t byteOrder;         // 0x01020304 in the byte order of the writer
+    uint32_t materialSize;      // sizeof( SMATERIAL ) of the writer
+    uint32_t materialsCount;
+    uint32_t meshesCount;
+    uint32_t tagLength;
+};
+
+struct MESH_CACHE_MESH
+{
+    uint32_t vertexSize;
+    uint32_t faceIdxSize;
+    uint32_t materialIdx;
+    uint32_t flags;
+};
+
+
+static bool writeMeshCache( const wxString& aFileName, const S3DMODEL& aModel,
+                            const std::string& aPluginInfo )
+{
+    FILE* fp = openCacheFile( aFileName, true );
+
+    if( NULL == fp )
+        return false;
+
+    MESH_CACHE_HEADER header;
+    memcpy( header.magic, meshCacheMagic, sizeof( header.magic ) );
+    header.version = MESH_CACHE_VERSION;
+    header.byteOrder = 0x01020304;
+    header.materialSize = sizeof( SMATERIAL );
+    header.materialsCount = aModel.m_MaterialsSize;
+    header.meshesCount = aModel.m_MeshesSize;
+    header.tagLength = aPluginInfo.size();
+
+    bool ok = fwrite( &header, sizeof( header ), 1, fp ) == 1;
+
+    ok = ok && fwrite( aPluginInfo.data(), 1, aPluginInfo.size(), fp ) == aPluginInfo.size();
+
+    ok = ok && fwrite( aModel.m_Materials, sizeof( SMATERIAL ), aModel.m_MaterialsSize, fp )
+                       == aModel.m_MaterialsSize;
+
+    for( unsigned int i = 0; ok && i < aModel.m_MeshesSize; ++i )
+    {
+        const SMESH&    mesh = aModel.m_Meshes[i];
+        MESH_CACHE_MESH meshHeader;
+
+        meshHeader.vertexSize = mesh.m_VertexSize;
+        meshHeader.faceIdxSize = mesh.m_FaceIdxSize;
+        meshHeader.materialIdx = mesh.m_MaterialIdx;
+        meshHeader.flags = ( mesh.m_Normals ? MESH_HAS_NORMALS : 0 )
+                           | ( mesh.m_Texcoords ? MESH_HAS_TEXCOORDS : 0 )
+                           | ( mesh.m_Color ? MESH_HAS_COLORS : 0 );
+
+        const size_t n = mesh.m_VertexSize;
+
+        ok = fwrite( &meshHeader, sizeof( meshHeader ), 1, fp ) == 1
+             && fwrite( mesh.m_Positions, sizeof( SFVEC3F ), n, fp ) == n
+             && ( !mesh.m_Normals || fwrite( mesh.m_Normals, sizeof( SFVEC3F ), n, fp ) == n )
+             && ( !mesh.m_Texcoords
+                  || fwrite( mesh.m_Texcoords, sizeof( SFVEC2F ), n, fp ) == n )
+             && ( !mesh.m_Color || fwrite( mesh.m_Color, sizeof( SFVEC3F ), n, fp ) == n )
+             && fwrite( mesh.m_FaceIdx, sizeof( unsigned int ), mesh.m_FaceIdxSize, fp )
+                        == mesh.m_FaceIdxSize;
+    }
+
+    if( fclose( fp ) != 0 )
+        ok = false;
+
+    if( !ok )
+        wxRemoveFile( aFileName );
+
+    return ok;
+}
+
+
+static S3DMODEL* readMeshCache( const wxString& aFileName, std::string& aPluginInfo )
+{
+    FILE* fp = openCacheFile( aFileName, false );
+
+    if( NULL == fp )
+        return NULL;
+
+    // Read the whole file at once, the arrays are then copied without conversion
+    std::vector<char> data;
+
+    if( fseek( fp, 0, SEEK_END ) == 0 )
+    {
+        long fileSize = ftell( fp );
+
+        if( fileSize > 0 && fseek( fp, 0, SEEK_SET ) == 0 )
+        {
+            data.resize( fileSize );
+
+            if( fread( data.data(), 1, data.size(), fp ) != data.size() )
+                data.clear();
+        }
+    }
+
+    fclose( fp );
+
+    size_t pos = 0;
+
+    auto take = [&]( void* aDst, size_t aSize ) -> bool
+                {
+                    if( aSize > data.size() - pos )
+                        return false;
+
+                    if( aSize )
+                        memcpy( aDst, data.data() + pos, aSize );
+
+                    pos += aSize;
+                    return true;
+                };
+
+    MESH_CACHE_HEADER header;
+
+    if( !take( &header, sizeof( header ) )
+            || memcmp( header.magic, meshCacheMagic, sizeof( header.magic ) ) != 0
+            || header.version != MESH_CACHE_VERSION || header.byteOrder != 0x01020304
+            || header.materialSize != sizeof( SMATERIAL )
+            || header.tagLength > data.size() - pos )
+    {
+        return NULL;
+    }
+
+    aPluginInfo.assign( data.data() + pos, header.tagLength );
+    pos += header.tagLength;
+
+    S3DMODEL* model = S3D::New3DModel();
+    bool      ok = true;
+
+    if( header.materialsCount )
+    {
+        model->m_Materials = new SMATERIAL[header.materialsCount];
+        model->m_MaterialsSize = header.materialsCount;
+        ok = take( model->m_Materials, sizeof( SMATERIAL ) * header.materialsCount );
+    }
+
+    if( ok && header.meshesCount )
+    {
+        model->m_Meshes = new SMESH[header.meshesCount];
+        model->m_MeshesSize = header.meshesCount;
+
+        for( unsigned int i = 0; i < header.meshesCount; ++i )
+            S3D::Init3DMesh( model->m_Meshes[i] );
+    }
+
+    for( unsigned int i = 0; ok && i < header.meshesCount; ++i )
+    {
+        SMESH&          mesh = model->m_Meshes[i];
+        MESH_CACHE_MESH meshHeader;
+
+        if( !take( &meshHeader, sizeof( meshHeader ) )
+                || meshHeader.materialIdx >= header.materialsCount )
+        {
+            ok = false;
+            break;
+        }
+
+        const size_t n = meshHeader.vertexSize;
+
+        mesh.m_VertexSize = meshHeader.vertexSize;
+        mesh.m_FaceIdxSize = meshHeader.faceIdxSize;
+        mesh.m_MaterialIdx = meshHeader.materialIdx;
+
+        // Check the mesh size before allocating anything for a truncated file
+        size_t meshBytes = n * sizeof( SFVEC3F ) + meshHeader.faceIdxSize * sizeof( unsigned int );
+
+        if( meshHeader.flags & MESH_HAS_NORMALS )
+            meshBytes += n * sizeof( SFVEC3F );
+
+        if( meshHeader.flags & MESH_HAS_TEXCOORDS )
+            meshBytes += n * sizeof( SFVEC2F );
+
+        if( meshHeader.flags & MESH_HAS_COLORS )
+            meshBytes += n * sizeof( SFVEC3F );
+
+        if( meshBytes > data.size() - pos )
+        {
+            ok = false;
+            break;
+        }
+
+        mesh.m_Positions = new SFVEC3F[n];
+        take( mesh.m_Positions, n * sizeof( SFVEC3F ) );
+
+        if( meshHeader.flags & MESH_HAS_NORMALS )
+        {
+            mesh.m_Normals = new SFVEC3F[n];
+            take( mesh.m_Normals, n * sizeof( SFVEC3F ) );
+        }
+
+        if( meshHeader.flags & MESH_HAS_TEXCOORDS )
+        {
+            mesh.m_Texcoords = new SFVEC2F[n];
+            take( mesh.m_Texcoords, n * sizeof( SFVEC2F ) );
+        }
+
+        if( meshHeader.flags & MESH_HAS_COLORS )
+        {
+            mesh.m_Color = new SFVEC3F[n];
+            take( mesh.m_Color, n * sizeof( SFVEC3F ) );
+        }
+
+        mesh.m_FaceIdx = new unsigned int[meshHeader.faceIdxSize];
+        take( mesh.m_FaceIdx, meshHeader.faceIdxSize * sizeof( unsigned int ) );
+    }
+
+    if( !ok )
+        S3D::Destroy3DModel( &model );
+
+    return model;
+}
+
+
+// Read the plugin tag of a scene cache file (.3dc), which starts with "(version)(tag)"
+static bool readSceneCacheTag( const wxString& aFileName, std::string& aTag )
+{
+    FILE* fp = openCacheFile( aFileName, false );
+
+    if( NULL == fp )
+        return false;
+
+    char   head[512];
+    size_t len = fread( head, 1, sizeof( head ), fp );
+    fclose( fp );
+
+    std::string text( head, len );
+    size_t      start = text.find( ")(" );
+    size_t      end = ( start == std::string::npos ) ? start : text.find( ')', start + 2 );
+
+    if( end == std::string::npos )
+        return false;
+
+    aTag = text.substr( start + 2, end - start - 2 );
+    return !aTag.empty();
+}
+
+
 class S3D_CACHE_ENTRY
 {
 private:
@@ -174,6 +484,7 @@ void S3D_CACHE_ENTRY::SetSHA1( const unsigned char* aSHA1Sum )
     }
 
     memcpy( sha1sum, aSHA1Sum, 20 );
+    m_CacheBaseName.clear();
 }
 
 
@@ -191,6 +502,7 @@ S3D_CACHE::S3D_CACHE()
     m_FNResolver = new FILENAME_RESOLVER;
     m_project = nullptr;
     m_Plugins = new S3D_PLUGIN_MANAGER;
+    m_StatIndexModified = false;
 }
 
 
@@ -198,6 +510,7 @@ S3D_CACHE::~S3D_CACHE()
 {
     COMMON_SETTINGS* commonSettings = Pgm().GetCommonSettings();
 
+    saveStatIndex();
     FlushCache();
 
     // We'll delete ".3dc" cache files older than this many days
@@ -213,7 +526,8 @@ S3D_CACHE::~S3D_CACHE()
 }
 
 
-SCENEGRAPH* S3D_CACHE::load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCachePtr )
+SCENEGRAPH* S3D_CACHE::load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCachePtr,
+                             bool aRenderDataOnly )
 {
     if( aCachePtr )
         *aCachePtr = NULL;
@@ -246,7 +560,7 @@ SCENEGRAPH* S3D_CACHE::load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCach
             if( fmdate != mi->second->modTime )
             {
                 unsigned char hashSum[20];
-                getSHA1( full3Dpath, hashSum );
+                getIndexedSHA1( full3Dpath, hashSum );
                 mi->second->modTime = fmdate;
 
                 if( !isSHA1Same( hashSum, mi->second->sha1sum ) )
@@ -267,7 +581,25 @@ SCENEGRAPH* S3D_CACHE::load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCach
                 if( NULL != mi->second->renderData )
                     S3D::Destroy3DModel( &mi->second->renderData );
 
-                mi->second->sceneData = m_Plugins->Load3DModel( full3Dpath, mi->second->pluginInfo );
+                if( !aRenderDataOnly || !loadMeshData( mi->second ) )
+                {
+                    mi->second->sceneData = m_Plugins->Load3DModel( full3Dpath,
+                                                                    mi->second->pluginInfo );
+                }
+            }
+        }
+
+        // The entry may only hold the render data read from a mesh cache file
+        if( !aRenderDataOnly && NULL == mi->second->sceneData
+                && NULL != mi->second->renderData )
+        {
+            if( !loadCacheData( mi->second ) )
+            {
+                mi->second->sceneData = m_Plugins->Load3DModel( full3Dpath,
+                                                                mi->second->pluginInfo );
+
+                if( NULL != mi->second->sceneData )
+                    saveCacheData( mi->second );
             }
         }
 
@@ -278,7 +610,7 @@ SCENEGRAPH* S3D_CACHE::load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCach
     }
 
     // a cache item does not exist; search the Filename->Cachename map
-    return checkCache( full3Dpath, aCachePtr );
+    return checkCache( full3Dpath, aCachePtr, aRenderDataOnly );
 }
 
 
@@ -288,14 +620,15 @@ SCENEGRAPH* S3D_CACHE::Load( const wxString& aModelFile )
 }
 
 
-SCENEGRAPH* S3D_CACHE::checkCache( const wxString& aFileName, S3D_CACHE_ENTRY** aCachePtr )
+SCENEGRAPH* S3D_CACHE::checkCache( const wxString& aFileName, S3D_CACHE_ENTRY** aCachePtr,
+                                   bool aRenderDataOnly )
 {
     if( aCachePtr )
         *aCachePtr = NULL;
 
     unsigned char sha1sum[20];
 
-    if( !getSHA1( aFileName, sha1sum ) || m_CacheDir.empty() )
+    if( !getIndexedSHA1( aFileName, sha1sum ) || m_CacheDir.empty() )
     {
         // just in case we can't get a hash digest (for example, on access issues)
         // or we do not have a configured cache file directory, we create an
@@ -345,6 +678,10 @@ SCENEGRAPH* S3D_CACHE::checkCache( const wxString& aFileName, S3D_CACHE_ENTRY**
 
     ep->SetSHA1( sha1sum );
 
+    // the render data is read from the mesh cache without building the scene
+    if( aRenderDataOnly && loadMeshData( ep ) )
+        return NULL;
+
     wxString bname = ep->GetCacheBaseName();
     wxString cachename = m_CacheDir + bname + wxT( ".3dc" );
 
@@ -416,6 +753,110 @@ bool S3D_CACHE::getSHA1( const wxString& aFileName, unsigned char* aSHA1Sum )
 }
 
 
+bool S3D_CACHE::getIndexedSHA1( const wxString& aFileName, unsigned char* aSHA1Sum )
+{
+    wxFileName fname( aFileName );
+    wxULongLong size = fname.GetSize();
+    wxDateTime  modTime = fname.GetModificationTime();
+
+    if( size == wxInvalidSize || !modTime.IsValid() )
+        return getSHA1( aFileName, aSHA1Sum );
+
+    S3D_FILE_STAT stat;
+    stat.size = size.GetValue();
+    stat.modTime = modTime.GetValue().GetValue();
+
+    std::unique_lock<std::mutex> lock( mutex3D_statIndex );
+    auto it = m_StatIndex.find( aFileName );
+
+    if( it != m_StatIndex.end() && it->second.size == stat.size
+            && it->second.modTime == stat.modTime )
+    {
+        memcpy( aSHA1Sum, it->second.sha1sum, 20 );
+        return true;
+    }
+
+    // the file is hashed without holding the lock
+    lock.unlock();
+
+    if( !getSHA1( aFileName, aSHA1Sum ) )
+        return false;
+
+    memcpy( stat.sha1sum, aSHA1Sum, 20 );
+    lock.lock();
+    m_StatIndex[aFileName] = stat;
+    m_StatIndexModified = true;
+
+    return true;
+}
+
+
+void S3D_CACHE::loadStatIndex()
+{
+    m_StatIndex.clear();
+    m_StatIndexModified = false;
+
+    wxFFile file;
+    wxString fname = m_CacheDir + wxT( STAT_INDEX_FILENAME );
+    wxString content;
+
+    if( !wxFileName::FileExists( fname ) || !file.Open( fname, "rb" )
+            || !file.ReadAll( &content, wxConvUTF8 ) )
+    {
+        return;
+    }
+
+    // One model file per line: size, modification time, SHA1 and full path
+    wxStringTokenizer lines( content, wxT( "\n" ) );
+
+    while( lines.HasMoreTokens() )
+    {
+        wxStringTokenizer fields( lines.GetNextToken(), wxT( " " ) );
+        S3D_FILE_STAT     stat;
+        wxString          size = fields.GetNextToken();
+        wxString          modTime = fields.GetNextToken();
+        wxString          sha1 = fields.GetNextToken();
+        wxString          path = fields.GetString();
+
+        if( path.empty() || !size.ToULongLong( &stat.size )
+                || !modTime.ToLongLong( &stat.modTime ) || !sha1FromString( sha1, stat.sha1sum ) )
+        {
+            continue;
+        }
+
+        m_StatIndex[path] = stat;
+    }
+
+    wxLogTrace( MASK_3D_CACHE, " * [3D model] %zu entries in stat index", m_StatIndex.size() );
+}
+
+
+void S3D_CACHE::saveStatIndex()
+{
+    if( !m_StatIndexModified || m_CacheDir.empty() )
+        return;
+
+    wxFFile file;
+
+    if( !file.Open( m_CacheDir + wxT( STAT_INDEX_FILENAME ), "wb" ) )
+        return;
+
+    for( const std::pair<const wxString, S3D_FILE_STAT>& entry : m_StatIndex )
+    {
+        // Entries of deleted files are dropped
+        if( !wxFileName::FileExists( entry.first ) )
+            continue;
+
+        file.Write( wxString::Format( wxT( "%llu %lld %s %s\n" ), entry.second.size,
+                                      entry.second.modTime, sha1ToWXString( entry.second.sha1sum ),
+                                      entry.first ),
+                    wxConvUTF8 );
+    }
+
+    m_StatIndexModified = false;
+}
+
+
 bool S3D_CACHE::loadCacheData( S3D_CACHE_ENTRY* aCacheItem )
 {
     wxString bname = aCacheItem->GetCacheBaseName();
@@ -506,11 +947,77 @@ bool S3D_CACHE::saveCacheData( S3D_CACHE_ENTRY* aCacheItem )
         }
     }
 
+    std::lock_guard<std::mutex> lock( mutex3D_cacheWrite );
+
     return S3D::WriteCache( fname.ToUTF8(), true, (SGNODE*)aCacheItem->sceneData,
         aCacheItem->pluginInfo.c_str() );
 }
 
 
+bool S3D_CACHE::loadMeshData( S3D_CACHE_ENTRY* aCacheItem )
+{
+    wxString bname = aCacheItem->GetCacheBaseName();
+
+    if( bname.empty() || m_CacheDir.empty() )
+        return false;
+
+    wxString fname = m_CacheDir + bname + wxT( ".3dm" );
+
+    if( !wxFileName::FileExists( fname ) )
+        return false;
+
+    std::string pluginInfo;
+    S3DMODEL*   model = readMeshCache( fname, pluginInfo );
+
+    if( NULL == model )
+    {
+        wxLogTrace( MASK_3D_CACHE, " * [3D model] invalid mesh cache file '%s'", fname );
+        return false;
+    }
+
+    // the model plugin has changed since the file was written
+    if( !m_Plugins->CheckTag( pluginInfo.c_str() ) )
+    {
+        S3D::Destroy3DModel( &model );
+        return false;
+    }
+
+    if( NULL != aCacheItem->renderData )
+        S3D::Destroy3DModel( &aCacheItem->renderData );
+
+    aCacheItem->renderData = model;
+    aCacheItem->pluginInfo = pluginInfo;
+
+    return true;
+}
+
+
+bool S3D_CACHE::saveMeshData( S3D_CACHE_ENTRY* aCacheItem )
+{
+    if( NULL == aCacheItem || NULL == aCacheItem->renderData )
+        return false;
+
+    wxString bname = aCacheItem->GetCacheBaseName();
+
+    if( bname.empty() || m_CacheDir.empty() )
+        return false;
+
+    // the plugin tag is not known when the scene was read from the scene cache file
+    std::string pluginInfo = aCacheItem->pluginInfo;
+
+    if( pluginInfo.empty()
+            && !readSceneCacheTag( m_CacheDir + bname + wxT( ".3dc" ), pluginInfo ) )
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock( mutex3D_cacheWrite );
+
+    return writeMeshCache( m_CacheDir + bname + wxT( ".3dm" ), *aCacheItem->renderData,
+                           pluginInfo );
+}
+
+
 bool S3D_CACHE::Set3DConfigDir( const wxString& aConfigDir )
 {
     if( !m_ConfigDir.empty() )
@@ -586,6 +1093,8 @@ bool S3D_CACHE::Set3DConfigDir( const wxString& aConfigDir )
     }
 
     m_CacheDir = cfgdir.GetPathWithSep();
+    loadStatIndex();
+
     return true;
 }
 
@@ -665,7 +1174,11 @@ void S3D_CACHE::ClosePlugins()
 S3DMODEL* S3D_CACHE::GetModel( const wxString& aModelFileName )
 {
     S3D_CACHE_ENTRY* cp = NULL;
-    SCENEGRAPH* sp = load( aModelFileName, &cp );
+    SCENEGRAPH* sp = load( aModelFileName, &cp, true );
+
+    // already available, or read from the mesh cache
+    if( cp && cp->renderData )
+        return cp->renderData;
 
     if( !sp )
         return NULL;
@@ -685,14 +1198,131 @@ S3DMODEL* S3D_CACHE::GetModel( const wxString& aModelFileName )
     S3DMODEL* mp = S3D::GetModel( sp );
     cp->renderData = mp;
 
+    if( mp )
+        saveMeshData( cp );
+
     return mp;
 }
 
+void S3D_CACHE::PrefetchModels( const std::vector<wxString>& aModelFiles )
+{
+    std::vector<wxString> fullPaths;
+    std::set<wxString>    uniquePaths;
+
+    for( const wxString& modelFile : aModelFiles )
+    {
+        wxString full3Dpath = m_FNResolver->ResolvePath( modelFile );
+
+        if( !full3Dpath.empty() && uniquePaths.insert( full3Dpath ).second )
+            fullPaths.push_back( full3Dpath );
+    }
+
+    {
+        // models already in the cache are checked for changes by load()
+        std::lock_guard<std::mutex> lock( mutex3D_cache );
+
+        fullPaths.erase( std::remove_if( fullPaths.begin(), fullPaths.end(),
+                                         [&]( const wxString& aPath )
+                                         {
+                                             return m_CacheMap.count( aPath ) > 0;
+                                         } ),
+                         fullPaths.end() );
+    }
+
+    if( fullPaths.empty() )
+        return;
+
+    std::vector<S3D_CACHE_ENTRY*> entries( fullPaths.size(), nullptr );
+    std::atomic<size_t>           nextModel( 0 );
+    std::atomic<size_t>           threadsFinished( 0 );
+
+    size_t parallelThreadCount = std::min<size_t>(
+            std::max<size_t>( std::thread::hardware_concurrency(), 2 ), fullPaths.size() );
+
+    for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+    {
+        std::thread t = std::thread( [&]()
+        {
+            for( size_t i = nextModel.fetch_add( 1 ); i < fullPaths.size();
+                 i = nextModel.fetch_add( 1 ) )
+            {
+                entries[i] = prefetchEntry( fullPaths[i] );
+            }
+
+            threadsFinished++;
+        } );
+
+        t.detach();
+    }
+
+    while( threadsFinished < parallelThreadCount )
+        std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+
+    std::lock_guard<std::mutex> lock( mutex3D_cache );
+
+    for( size_t i = 0; i < fullPaths.size(); ++i )
+    {
+        if( NULL == entries[i] )
+            continue;
+
+        // the model may have been loaded by another thread in the meantime
+        if( m_CacheMap.insert( std::pair< wxString, S3D_CACHE_ENTRY* >
+                                       ( fullPaths[i], entries[i] ) ).second )
+        {
+            m_CacheList.push_back( entries[i] );
+        }
+        else
+        {
+            delete entries[i];
+        }
+    }
+
+    wxLogTrace( MASK_3D_CACHE, " * [3D model] prefetched %zu models", fullPaths.size() );
+}
+
+
+S3D_CACHE_ENTRY* S3D_CACHE::prefetchEntry( const wxString& aFileName )
+{
+    unsigned char sha1sum[20];
+
+    // load() creates the entries of the models which cannot be cached
+    if( m_CacheDir.empty() || !getIndexedSHA1( aFileName, sha1sum ) )
+        return NULL;
+
+    S3D_CACHE_ENTRY* ep = new S3D_CACHE_ENTRY;
+    wxFileName fname( aFileName );
+    ep->modTime = fname.GetModificationTime();
+    ep->SetSHA1( sha1sum );
+
+    if( loadMeshData( ep ) )
+        return ep;
+
+    wxString cachename = m_CacheDir + ep->GetCacheBaseName() + wxT( ".3dc" );
+
+    if( !wxFileName::FileExists( cachename ) || !loadCacheData( ep ) )
+    {
+        ep->sceneData = m_Plugins->Load3DModel( aFileName, ep->pluginInfo );
+
+        // like checkCache(), a model which cannot be read keeps an empty entry
+        if( NULL == ep->sceneData )
+            return ep;
+
+        saveCacheData( ep );
+    }
+
+    ep->renderData = S3D::GetModel( ep->sceneData );
+
+    if( ep->renderData )
+        saveMeshData( ep );
+
+    return ep;
+}
+
+
 void S3D_CACHE::CleanCacheDir( int aNumDaysOld )
 {
     wxDir         dir;
-    wxString      fileSpec = wxT( "*.3dc" );
-    wxArrayString fileList; // Holds list of ".3dc" files found in cache directory
+    wxArrayString fileList; // Holds list of ".3dc" and ".3dm" files found in cache directory
     size_t        numFilesFound = 0;
 
     wxFileName thisFile;
@@ -708,8 +1338,10 @@ void S3D_CACHE::CleanCacheDir( int aNumDaysOld )
     {
         thisFile.SetPath( m_CacheDir ); // Set the base path to the cache folder
 
-        // Get a list of all the ".3dc" files in the cache directory
-        numFilesFound = dir.GetAllFiles( m_CacheDir, &fileList, fileSpec );
+        // Get a list of all the ".3dc" and ".3dm" files in the cache directory
+        dir.GetAllFiles( m_CacheDir, &fileList, wxT( "*.3dc" ) );
+        dir.GetAllFiles( m_CacheDir, &fileList, wxT( "*.3dm" ) );
+        numFilesFound = fileList.GetCount();
 
         for( unsigned int i = 0; i < numFilesFound; i++ )
         {
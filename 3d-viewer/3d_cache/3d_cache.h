@@ -34,6 +34,7 @@
 #include "kicad_string.h"
 #include <list>
 #include <map>
+#include <vector>
 #include "plugins/3dapi/c3dmodel.h"
 #include <project.h>
 #include <wx/string.h>
@@ -45,6 +46,18 @@ class  FILENAME_RESOLVER;
 class  S3D_PLUGIN_MANAGER;
 
 
+/**
+ * File status and hash of a model file, used to find the cache files of a model
+ * without reading the whole model file to compute its hash.
+ */
+struct S3D_FILE_STAT
+{
+    unsigned long long size;            ///< file size in bytes
+    long long          modTime;         ///< modification time, in ms since the epoch
+    unsigned char      sha1sum[20];     ///< SHA1 hash of the file content
+};
+
+
 /**
  * S3D_CACHE
  *
@@ -68,6 +81,10 @@ private:
     wxString            m_CacheDir;
     wxString            m_ConfigDir;       /// base configuration path for 3D items
 
+    /// model file full path to file status and hash, saved in the cache directory
+    std::map< wxString, S3D_FILE_STAT > m_StatIndex;
+    bool                                m_StatIndexModified;
+
     /** Find or create cache entry for file name
      *
      * Searches the cache list for the given filename and retrieves
@@ -76,10 +93,13 @@ private:
      *
      * @param[in]   aFileName   file name (full or partial path)
      * @param[out]  aCachePtr   optional return address for cache entry pointer
+     * @param[in]   aRenderDataOnly  true if only the render data is needed; the scene data
+     *                               is then not loaded when a mesh cache file exists
      * @return      SCENEGRAPH object associated with file name
-     * @retval      NULL    on error
+     * @retval      NULL    on error, or when only the render data was loaded
      */
-    SCENEGRAPH* checkCache( const wxString& aFileName, S3D_CACHE_ENTRY** aCachePtr = NULL );
+    SCENEGRAPH* checkCache( const wxString& aFileName, S3D_CACHE_ENTRY** aCachePtr = NULL,
+                            bool aRenderDataOnly = false );
 
     /**
      * Function getSHA1
@@ -92,14 +112,42 @@ private:
      */
     bool getSHA1( const wxString& aFileName, unsigned char* aSHA1Sum );
 
+    /**
+     * Function getIndexedSHA1
+     * returns the SHA1 hash of the given file, from the stat index when the file size
+     * and modification time did not change, otherwise using getSHA1()
+     */
+    bool getIndexedSHA1( const wxString& aFileName, unsigned char* aSHA1Sum );
+
+    // load and save the stat index in the cache directory
+    void loadStatIndex();
+    void saveStatIndex();
+
     // load scene data from a cache file
     bool loadCacheData( S3D_CACHE_ENTRY* aCacheItem );
 
     // save scene data to a cache file
     bool saveCacheData( S3D_CACHE_ENTRY* aCacheItem );
 
+    // load render data from a mesh cache file
+    bool loadMeshData( S3D_CACHE_ENTRY* aCacheItem );
+
+    // save render data to a mesh cache file
+    bool saveMeshData( S3D_CACHE_ENTRY* aCacheItem );
+
+    /**
+     * Function prefetchEntry
+     * builds a cache entry with the render data of a model, without using the cache
+     * lists; this is called from the worker threads of PrefetchModels()
+     *
+     * @param[in]   aFileName   model file name (full path)
+     * @return      the new entry, or NULL if the model cannot be cached
+     */
+    S3D_CACHE_ENTRY* prefetchEntry( const wxString& aFileName );
+
     // the real load function (can supply a cache entry pointer to member functions)
-    SCENEGRAPH* load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCachePtr = NULL );
+    SCENEGRAPH* load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCachePtr = NULL,
+                      bool aRenderDataOnly = false );
 
 public:
     S3D_CACHE();
@@ -177,20 +225,34 @@ public:
     /**
      * Function GetModel
      * attempts to load the scene data for a model and to translate it
-     * into an S3D_MODEL structure for display by a renderer
+     * into an S3D_MODEL structure for display by a renderer. The render data
+     * is kept in a mesh cache file, and is read from this file when available
+     * without loading the scene data.
      *
      * @param aModelFileName is the full path to the model to be loaded
      * @return is a pointer to the render data or NULL if not available
      */
     S3DMODEL* GetModel( const wxString& aModelFileName );
 
+    /**
+     * Function PrefetchModels
+     * loads the render data of a set of models on several threads, so that the following
+     * calls to GetModel() find them in the cache. The models are read from the mesh and
+     * scene cache files when possible; the plugins are only called concurrently when
+     * they declare it with CanLoadConcurrently().
+     *
+     * @param aModelFiles is the list of model files (full or partial paths); duplicates
+     * and models already in the cache are skipped
+     */
+    void PrefetchModels( const std::vector<wxString>& aModelFiles );
+
     /**
      * Function Delete up old cache files in cache directory
      *
-     * Deletes ".3dc" files in the cache directory that are older than
+     * Deletes ".3dc" and ".3dm" files in the cache directory that are older than
      * "aNumDaysOld".
      *
-     * @param aNumDaysOld is age threshold to delete ".3dc" cache files
+     * @param aNumDaysOld is age threshold to delete cache files
      */
     void CleanCacheDir( int aNumDaysOld );
 };
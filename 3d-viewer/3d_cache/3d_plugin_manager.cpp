@@ -494,12 +494,21 @@ SCENEGRAPH* S3D_PLUGIN_MANAGER::Load3DModel( const wxString& aFileName, std::str
 
     while( sL != items.second )
     {
+        std::unique_lock<std::mutex> lock( m_pluginLock );
+
         if( sL->second->CanRender() )
         {
+            // plugins which do not use any global state may load several models at once
+            if( sL->second->CanLoadConcurrently() )
+                lock.unlock();
+
             SCENEGRAPH* sp = sL->second->Load( aFileName.ToUTF8() );
 
             if( NULL != sp )
             {
+                if( !lock.owns_lock() )
+                    lock.lock();
+
                 sL->second->GetPluginInfo( aPluginInfo );
                 return sp;
             }
@@ -526,6 +535,8 @@ void S3D_PLUGIN_MANAGER::ClosePlugins( void )
     } while( 0 );
     #endif
 
+    std::lock_guard<std::mutex> lock( m_pluginLock );
+
     while( sP != eP )
     {
         (*sP)->Close();
@@ -553,6 +564,8 @@ bool S3D_PLUGIN_MANAGER::CheckTag( const char* aTag )
     pname = tname.substr( 0, cpos );
     std::string ptag;   // tag from the plugin
 
+    std::lock_guard<std::mutex> lock( m_pluginLock );
+
     std::list< KICAD_PLUGIN_LDR_3D* >::iterator pS = m_Plugins.begin();
     std::list< KICAD_PLUGIN_LDR_3D* >::iterator pE = m_Plugins.end();
 
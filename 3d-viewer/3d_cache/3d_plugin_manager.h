@@ -31,6 +31,7 @@
 
 #include <map>
 #include <list>
+#include <mutex>
 #include <string>
 #include <wx/string.h>
 
@@ -50,6 +51,9 @@ private:
     /// list of file filters
     std::list< wxString > m_FileFilters;
 
+    /// serializes the plugin calls, except the loads of plugins which can load concurrently
+    std::mutex m_pluginLock;
+
     /// load plugins
     void loadPlugins( void );
 
@@ -22,6 +22,7 @@
  */
 
 #include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <cstring>
 #include <iostream>
@@ -45,7 +46,9 @@ static const std::string node_names[S3D::SGTYPE_END + 1] = {
 };
 
 
-static unsigned int node_counts[S3D::SGTYPE_END] = { 1, 1, 1, 1, 1, 1, 1, 1, 1 };
+// atomic since models may be read by several threads at once
+static std::atomic<unsigned int> node_counts[S3D::SGTYPE_END] = { { 1 }, { 1 }, { 1 }, { 1 }, { 1 },
+                                                                  { 1 }, { 1 }, { 1 }, { 1 } };
 
 
 char const* S3D::GetNodeTypeName( S3D::SGTYPES aType ) noexcept
@@ -62,8 +65,7 @@ static void getNodeName( S3D::SGTYPES nodeType, std::string& aName )
         return;
     }
 
-    unsigned int seqNum = node_counts[nodeType];
-    ++node_counts[nodeType];
+    unsigned int seqNum = node_counts[nodeType]++;
 
     std::ostringstream ostr;
     ostr << node_names[nodeType] << "_" << seqNum;
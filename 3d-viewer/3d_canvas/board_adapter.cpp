@@ -249,6 +249,29 @@ bool BOARD_ADAPTER::ShouldModuleBeDisplayed( MODULE_ATTR_T aModuleAttributs ) co
 }
 
 
+void BOARD_ADAPTER::Prefetch3DModels( bool aDisplayedOnly ) const
+{
+    if( !m_3d_model_manager || !m_board )
+        return;
+
+    std::vector<wxString> modelFiles;
+
+    for( MODULE* module : m_board->Modules() )
+    {
+        if( aDisplayedOnly && !ShouldModuleBeDisplayed( (MODULE_ATTR_T) module->GetAttributes() ) )
+            continue;
+
+        for( const MODULE_3D_SETTINGS& model : module->Models() )
+        {
+            if( model.m_Show && !model.m_Filename.empty() )
+                modelFiles.push_back( model.m_Filename );
+        }
+    }
+
+    m_3d_model_manager->PrefetchModels( modelFiles );
+}
+
+
 // !TODO: define the actual copper thickness by user
 #define COPPER_THICKNESS KiROUND( 0.035 * IU_PER_MM )   // for 35 um
 #define TECH_LAYER_THICKNESS KiROUND( 0.04 * IU_PER_MM )
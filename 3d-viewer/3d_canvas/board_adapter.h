@@ -91,6 +91,14 @@ class BOARD_ADAPTER
         return m_3d_model_manager;
     }
 
+    /**
+     * @brief Prefetch3DModels - Load the 3D models of the board footprints in the 3d
+     * cache manager on several threads, before the renderer gets them one by one
+     * @param aDisplayedOnly: only the models of the footprints that should be displayed
+     * with the current attribute flags
+     */
+    void Prefetch3DModels( bool aDisplayedOnly ) const;
+
     /**
      * @brief GetFlag - get a configuration status of a flag
      * @param aFlag: the flag to get the status
@@ -536,6 +544,30 @@ class BOARD_ADAPTER
     void createLayers( REPORTER* aStatusReporter );
     void destroyLayers();
 
+    /**
+     * Compute a hash of everything that goes into the 2D container and the polygons of a
+     * layer: the items on the layer, their geometry and the settings used to convert them.
+     * Layers with an unchanged hash are reused by createLayers instead of being rebuilt.
+     */
+    size_t layerContentHash( PCB_LAYER_ID aLayerId,
+                             const std::vector<const TRACK*>& aTrackList ) const;
+
+    /**
+     * Fill the container and the (optional) polygon set of a copper layer with its tracks,
+     * pads, footprint graphics, drawings and, for the polygon set, zones.
+     * Several layers can be built at the same time by different threads.
+     */
+    void createCopperLayer( PCB_LAYER_ID aLayerId, CBVHCONTAINER2D* aContainer,
+                            SHAPE_POLY_SET* aLayerPoly,
+                            const std::vector<const TRACK*>& aTrackList );
+
+    /**
+     * Fill the container and the polygon set of a technical layer.
+     * Several layers can be built at the same time by different threads.
+     */
+    void createTechLayer( PCB_LAYER_ID aLayerId, CBVHCONTAINER2D* aContainer,
+                          SHAPE_POLY_SET* aLayerPoly );
+
     // Helper functions to create the board
      void createNewTrack( const TRACK* aTrack, CGENERICCONTAINER2D *aDstContainer,
                           int aClearanceValue );
@@ -705,6 +737,9 @@ private:
     /// It contains the holes per each layer
     MAP_CONTAINER_2D  m_layers_holes2D;
 
+    /// Content hash of the layers in m_layers_container2D, see layerContentHash()
+    std::map< PCB_LAYER_ID, size_t > m_layerHashes;
+
     /// It contains the list of throughHoles of the board,
     /// the radius of the hole is inflated with the copper tickness
     CBVHCONTAINER2D   m_through_holes_outer;
@@ -56,27 +56,33 @@
 
 // These variables are parameters used in addTextSegmToContainer.
 // But addTextSegmToContainer is a call-back function,
-// so we cannot send them as arguments.
-static int s_textWidth;
-static CGENERICCONTAINER2D *s_dstcontainer = NULL;
-static float s_biuTo3Dunits;
-static const BOARD_ITEM *s_boardItem = NULL;
+// so they are sent through the aData pointer, and layers can be built from several threads.
+struct TSEGM_2_CONTAINER_PRMS
+{
+    int                  m_textWidth;
+    CGENERICCONTAINER2D* m_dstcontainer;
+    float                m_biuTo3Dunits;
+    const BOARD_ITEM*    m_boardItem;
+};
 
 // This is a call back function, used by GRText to draw the 3D text shape:
 void addTextSegmToContainer( int x0, int y0, int xf, int yf, void* aData )
 {
-    const SFVEC2F start3DU( x0 * s_biuTo3Dunits, -y0 * s_biuTo3Dunits );
-    const SFVEC2F end3DU  ( xf * s_biuTo3Dunits, -yf * s_biuTo3Dunits );
+    const TSEGM_2_CONTAINER_PRMS* prm = static_cast<const TSEGM_2_CONTAINER_PRMS*>( aData );
+    const float                   biuTo3Dunits = prm->m_biuTo3Dunits;
+
+    const SFVEC2F start3DU( x0 * biuTo3Dunits, -y0 * biuTo3Dunits );
+    const SFVEC2F end3DU  ( xf * biuTo3Dunits, -yf * biuTo3Dunits );
 
     if( Is_segment_a_circle( start3DU, end3DU ) )
-        s_dstcontainer->Add( new CFILLEDCIRCLE2D( start3DU,
-                                                  ( s_textWidth / 2 ) * s_biuTo3Dunits,
-                                                  *s_boardItem) );
+        prm->m_dstcontainer->Add( new CFILLEDCIRCLE2D( start3DU,
+                                                       ( prm->m_textWidth / 2 ) * biuTo3Dunits,
+                                                       *prm->m_boardItem) );
     else
-        s_dstcontainer->Add( new CROUNDSEGMENT2D( start3DU,
-                                                  end3DU,
-                                                  s_textWidth * s_biuTo3Dunits,
-                                                  *s_boardItem ) );
+        prm->m_dstcontainer->Add( new CROUNDSEGMENT2D( start3DU,
+                                                       end3DU,
+                                                       prm->m_textWidth * biuTo3Dunits,
+                                                       *prm->m_boardItem ) );
 }
 
 
@@ -93,10 +99,11 @@ void BOARD_ADAPTER::AddShapeWithClearanceToContainer( const PCB_TEXT* aText,
     if( aText->IsMirrored() )
         size.x = -size.x;
 
-    s_boardItem    = (const BOARD_ITEM *) &aText;
-    s_dstcontainer = aDstContainer;
-    s_textWidth    = aText->GetEffectiveTextPenWidth() + ( 2 * aClearanceValue );
-    s_biuTo3Dunits = m_biuTo3Dunits;
+    TSEGM_2_CONTAINER_PRMS prms;
+    prms.m_boardItem    = aText;
+    prms.m_dstcontainer = aDstContainer;
+    prms.m_textWidth    = aText->GetEffectiveTextPenWidth() + ( 2 * aClearanceValue );
+    prms.m_biuTo3Dunits = m_biuTo3Dunits;
 
     // not actually used, but needed by GRText
     const COLOR4D dummy_color = COLOR4D::BLACK;
@@ -117,14 +124,14 @@ void BOARD_ADAPTER::AddShapeWithClearanceToContainer( const PCB_TEXT* aText,
 
             GRText( nullptr, positions[ii], dummy_color, txt, aText->GetTextAngle(), size,
                     aText->GetHorizJustify(), aText->GetVertJustify(), penWidth,
-                    aText->IsItalic(), forceBold, addTextSegmToContainer );
+                    aText->IsItalic(), forceBold, addTextSegmToContainer, &prms );
         }
     }
     else
     {
         GRText( nullptr, aText->GetTextPos(), dummy_color, aText->GetShownText(),
                 aText->GetTextAngle(), size, aText->GetHorizJustify(), aText->GetVertJustify(),
-                penWidth, aText->IsItalic(), forceBold, addTextSegmToContainer );
+                penWidth, aText->IsItalic(), forceBold, addTextSegmToContainer, &prms );
     }
 }
 
@@ -231,13 +238,14 @@ void BOARD_ADAPTER::AddGraphicsShapesWithClearanceToContainer( const MODULE* aMo
     if( aModule->Value().GetLayer() == aLayerId && aModule->Value().IsVisible() )
         texts.push_back( &aModule->Value() );
 
-    s_boardItem    = (const BOARD_ITEM *)&aModule->Value();
-    s_dstcontainer = aDstContainer;
-    s_biuTo3Dunits = m_biuTo3Dunits;
+    TSEGM_2_CONTAINER_PRMS prms;
+    prms.m_boardItem    = &aModule->Value();
+    prms.m_dstcontainer = aDstContainer;
+    prms.m_biuTo3Dunits = m_biuTo3Dunits;
 
     for( FP_TEXT* text : texts )
     {
-        s_textWidth = text->GetEffectiveTextPenWidth() + ( 2 * aInflateValue );
+        prms.m_textWidth = text->GetEffectiveTextPenWidth() + ( 2 * aInflateValue );
         wxSize size = text->GetTextSize();
         bool   forceBold = true;
         int    penWidth = 0;        // force max width for bold
@@ -247,7 +255,7 @@ void BOARD_ADAPTER::AddGraphicsShapesWithClearanceToContainer( const MODULE* aMo
 
         GRText( NULL, text->GetTextPos(), BLACK, text->GetShownText(), text->GetDrawRotation(),
                 size, text->GetHorizJustify(), text->GetVertJustify(), penWidth, text->IsItalic(),
-                forceBold, addTextSegmToContainer );
+                forceBold, addTextSegmToContainer, &prms );
     }
 }
 
@@ -42,8 +42,10 @@
 #include <fp_shape.h>
 #include <class_zone.h>
 #include <convert_basic_shapes_to_polygon.h>
+#include <hash_eda.h>
 #include <trigo.h>
 #include <vector>
+#include <map>
 #include <thread>
 #include <algorithm>
 #include <atomic>
@@ -53,6 +55,39 @@
 #endif
 
 
+// Hash helpers for BOARD_ADAPTER::layerContentHash()
+static void hashPolySet( size_t& aSeed, const SHAPE_POLY_SET& aPolySet )
+{
+    hash_combine( aSeed, aPolySet.OutlineCount(), aPolySet.TotalVertices() );
+
+    for( auto iter = aPolySet.CIterateWithHoles(); iter; iter++ )
+        hash_combine( aSeed, iter->x, iter->y );
+}
+
+
+static void hashText( size_t& aSeed, const EDA_TEXT* aText )
+{
+    hash_combine( aSeed, aText->GetShownText().ToStdWstring(), aText->GetTextPos().x,
+                  aText->GetTextPos().y, aText->GetTextSize().x, aText->GetTextSize().y,
+                  aText->GetEffectiveTextPenWidth(), aText->GetDrawRotation(),
+                  aText->IsItalic(), aText->IsBold(), aText->IsMirrored(), aText->IsVisible(),
+                  aText->IsMultilineAllowed(), aText->GetHorizJustify(),
+                  aText->GetVertJustify() );
+}
+
+
+static void hashShape( size_t& aSeed, const PCB_SHAPE* aShape )
+{
+    hash_combine( aSeed, aShape->GetShape(), aShape->GetStart().x, aShape->GetStart().y,
+                  aShape->GetEnd().x, aShape->GetEnd().y, aShape->GetWidth(),
+                  aShape->GetAngle(), aShape->GetBezControl1().x, aShape->GetBezControl1().y,
+                  aShape->GetBezControl2().x, aShape->GetBezControl2().y );
+
+    if( aShape->GetShape() == S_POLYGON )
+        hashPolySet( aSeed, aShape->GetPolyShape() );
+}
+
+
 void BOARD_ADAPTER::destroyLayers()
 {
     if( !m_layers_poly.empty() )
@@ -117,13 +152,371 @@ void BOARD_ADAPTER::destroyLayers()
 
     m_through_outer_holes_vias_poly.RemoveAllContours();
     m_through_outer_ring_holes_poly.RemoveAllContours();
+
+    m_layerHashes.clear();
 }
 
 
-void BOARD_ADAPTER::createLayers( REPORTER* aStatusReporter )
+size_t BOARD_ADAPTER::layerContentHash( PCB_LAYER_ID aLayerId,
+                                        const std::vector<const TRACK*>& aTrackList ) const
 {
-    destroyLayers();
+    size_t seed = hash_val( aLayerId, m_board, m_biuTo3Dunits, m_render_engine,
+                            GetFlag( FL_RENDER_OPENGL_COPPER_THICKNESS ),
+                            GetFlag( FL_RENDER_PLATED_PADS_AS_PLATED ), GetFlag( FL_ZONE ),
+                            g_DrawDefaultLineThickness );
+
+    if( IsCopperLayer( aLayerId ) )
+    {
+        for( const TRACK* track : aTrackList )
+        {
+            if( !track->IsOnLayer( aLayerId ) )
+                continue;
+
+            hash_combine( seed, track, track->Type(), track->GetStart().x, track->GetStart().y,
+                          track->GetEnd().x, track->GetEnd().y, track->GetWidth() );
+
+            if( track->Type() == PCB_VIA_T )
+                hash_combine( seed, static_cast<const VIA*>( track )->FlashLayer( aLayerId ) );
+            else if( track->Type() == PCB_ARC_T )
+                hash_combine( seed, static_cast<const ARC*>( track )->GetMid().x,
+                              static_cast<const ARC*>( track )->GetMid().y );
+        }
+    }
+
+    for( const MODULE* module : m_board->Modules() )
+    {
+        size_t moduleSeed = 0;
+
+        for( const D_PAD* pad : module->Pads() )
+        {
+            if( !pad->IsOnLayer( aLayerId ) )
+                continue;
+
+            hash_combine( moduleSeed, pad, pad->GetPosition().x, pad->GetPosition().y,
+                          pad->GetOrientation(), pad->GetAttribute(), pad->GetShape(),
+                          pad->GetDrillShape(), pad->GetDrillSize().x, pad->GetDrillSize().y,
+                          pad->GetOffset().x, pad->GetOffset().y, pad->FlashLayer( aLayerId ),
+                          pad->FlashLayer( F_Mask ), pad->FlashLayer( B_Mask ),
+                          pad->GetSolderMaskMargin(), pad->GetSolderPasteMargin().x,
+                          pad->GetSolderPasteMargin().y );
+
+            // This also builds the pad effective shapes, before they are used from threads
+            hashPolySet( moduleSeed, *pad->GetEffectivePolygon() );
+        }
+
+        for( const BOARD_ITEM* item : module->GraphicalItems() )
+        {
+            if( item->GetLayer() != aLayerId )
+                continue;
+
+            if( item->Type() == PCB_FP_SHAPE_T )
+            {
+                hash_combine( moduleSeed, item );
+                hashShape( moduleSeed, static_cast<const FP_SHAPE*>( item ) );
+            }
+            else if( item->Type() == PCB_FP_TEXT_T )
+            {
+                hash_combine( moduleSeed, item );
+                hashText( moduleSeed, static_cast<const FP_TEXT*>( item ) );
+            }
+        }
+
+        for( const FP_TEXT* text : { &module->Reference(), &module->Value() } )
+        {
+            if( text->GetLayer() == aLayerId )
+            {
+                hash_combine( moduleSeed, text );
+                hashText( moduleSeed, text );
+            }
+        }
+
+        if( moduleSeed )
+        {
+            hash_combine( seed, module, module->GetPosition().x, module->GetPosition().y,
+                          module->GetOrientation(), moduleSeed );
+        }
+    }
+
+    for( const BOARD_ITEM* item : m_board->Drawings() )
+    {
+        if( !item->IsOnLayer( aLayerId ) )
+            continue;
+
+        hash_combine( seed, item, item->Type() );
+
+        switch( item->Type() )
+        {
+        case PCB_SHAPE_T:
+            hashShape( seed, static_cast<const PCB_SHAPE*>( item ) );
+            break;
+
+        case PCB_TEXT_T:
+            hashText( seed, static_cast<const PCB_TEXT*>( item ) );
+            break;
+
+        case PCB_DIM_ALIGNED_T:
+        case PCB_DIM_CENTER_T:
+        case PCB_DIM_ORTHOGONAL_T:
+        case PCB_DIM_LEADER_T:
+        {
+            const DIMENSION* dimension = static_cast<const DIMENSION*>( item );
 
+            hashText( seed, &dimension->Text() );
+            hash_combine( seed, dimension->GetLineThickness() );
+
+            for( const std::shared_ptr<SHAPE>& shape : dimension->GetShapes() )
+            {
+                BOX2I bbox = shape->BBox();
+                hash_combine( seed, shape->Type(), bbox.GetX(), bbox.GetY(), bbox.GetWidth(),
+                              bbox.GetHeight() );
+            }
+        }
+        break;
+
+        default:
+            break;
+        }
+    }
+
+    if( GetFlag( FL_ZONE ) )
+    {
+        for( const ZONE_CONTAINER* zone : m_board->Zones() )
+        {
+            if( !zone->IsOnLayer( aLayerId ) )
+                continue;
+
+            hash_combine( seed, zone );
+            hashPolySet( seed, zone->GetFilledPolysList( aLayerId ) );
+        }
+    }
+
+    return seed;
+}
+
+
+void BOARD_ADAPTER::createCopperLayer( PCB_LAYER_ID aLayerId, CBVHCONTAINER2D* aContainer,
+                                       SHAPE_POLY_SET* aLayerPoly,
+                                       const std::vector<const TRACK*>& aTrackList )
+{
+    const bool renderPlatedPadsAsPlated = GetFlag( FL_RENDER_PLATED_PADS_AS_PLATED );
+
+    // Add track segments shapes and via annulus shapes
+    for( const TRACK* track : aTrackList )
+    {
+        // NOTE: Vias can be on multiple layers
+        if( !track->IsOnLayer( aLayerId ) )
+            continue;
+
+        // Skip vias annulus when not connected on this layer (if removing is enabled)
+        const VIA *via = dyn_cast< const VIA*>( track );
+
+        if( via && !via->FlashLayer( aLayerId ) )
+            continue;
+
+        // Add object item to layer container
+        createNewTrack( track, aContainer, 0.0f );
+
+        // Add the track/via contour
+        if( aLayerPoly )
+        {
+            track->TransformShapeWithClearanceToPolygon( *aLayerPoly, aLayerId, 0,
+                                                         ARC_HIGH_DEF, ERROR_INSIDE );
+        }
+    }
+
+    // Add modules PADs objects and contours
+    for( MODULE* module : m_board->Modules() )
+    {
+        // Note: NPTH pads are not drawn on copper layers when the pad
+        // has same shape as its hole
+        AddPadsShapesWithClearanceToContainer( module, aContainer, aLayerId, 0,
+                                               true, renderPlatedPadsAsPlated, false );
+
+        // Micro-wave modules may have items on copper layers
+        AddGraphicsShapesWithClearanceToContainer( module, aContainer, aLayerId, 0 );
+
+        if( aLayerPoly )
+        {
+            module->TransformPadsShapesWithClearanceToPolygon( *aLayerPoly, aLayerId,
+                                                               0, ARC_HIGH_DEF, ERROR_INSIDE,
+                                                               true, renderPlatedPadsAsPlated,
+                                                               false );
+
+            transformGraphicModuleEdgeToPolygonSet( module, aLayerId, *aLayerPoly );
+        }
+    }
+
+    // Add graphic items on copper layers (texts and other graphics)
+    for( BOARD_ITEM* item : m_board->Drawings() )
+    {
+        if( !item->IsOnLayer( aLayerId ) )
+            continue;
+
+        switch( item->Type() )
+        {
+        case PCB_SHAPE_T:
+            AddShapeWithClearanceToContainer( (PCB_SHAPE*) item, aContainer, aLayerId, 0 );
+
+            if( aLayerPoly )
+            {
+                ( (PCB_SHAPE*) item )->TransformShapeWithClearanceToPolygon( *aLayerPoly,
+                                                                             aLayerId, 0,
+                                                                             ARC_HIGH_DEF,
+                                                                             ERROR_INSIDE );
+            }
+            break;
+
+        case PCB_TEXT_T:
+            AddShapeWithClearanceToContainer( (PCB_TEXT*) item, aContainer, aLayerId, 0 );
+
+            if( aLayerPoly )
+            {
+                ( (PCB_TEXT*) item )->TransformShapeWithClearanceToPolygonSet( *aLayerPoly, 0,
+                                                                               ARC_HIGH_DEF,
+                                                                               ERROR_INSIDE );
+            }
+            break;
+
+        case PCB_DIM_ALIGNED_T:
+        case PCB_DIM_CENTER_T:
+        case PCB_DIM_ORTHOGONAL_T:
+        case PCB_DIM_LEADER_T:
+            AddShapeWithClearanceToContainer( (DIMENSION*) item, aContainer, aLayerId, 0 );
+            break;
+
+        default:
+            wxLogTrace( m_logTrace, wxT( "createLayers: item type: %d not implemented" ),
+                        item->Type() );
+            break;
+        }
+    }
+
+    if( !aLayerPoly )
+        return;
+
+    // Add copper zones contours. Zone objects are added to the container by createLayers,
+    // per zone and per layer.
+    if( GetFlag( FL_ZONE ) )
+    {
+        for( ZONE_CONTAINER* zone : m_board->Zones() )
+        {
+            if( zone->IsOnLayer( aLayerId ) )
+                zone->TransformSolidAreasShapesToPolygon( aLayerId, *aLayerPoly );
+        }
+    }
+
+    if( renderPlatedPadsAsPlated && ( aLayerId == F_Cu || aLayerId == B_Cu ) )
+    {
+        SHAPE_POLY_SET* platedPadsPoly = ( aLayerId == F_Cu ) ? m_F_Cu_PlatedPads_poly
+                                                              : m_B_Cu_PlatedPads_poly;
+
+        aLayerPoly->BooleanSubtract( *platedPadsPoly, SHAPE_POLY_SET::POLYGON_MODE::PM_FAST );
+    }
+    else
+    {
+        // This will make a union of all added contours
+        aLayerPoly->Simplify( SHAPE_POLY_SET::PM_FAST );
+    }
+}
+
+
+void BOARD_ADAPTER::createTechLayer( PCB_LAYER_ID aLayerId, CBVHCONTAINER2D* aContainer,
+                                     SHAPE_POLY_SET* aLayerPoly )
+{
+    // Add drawing objects and contours
+    for( BOARD_ITEM* item : m_board->Drawings() )
+    {
+        if( !item->IsOnLayer( aLayerId ) )
+            continue;
+
+        switch( item->Type() )
+        {
+        case PCB_SHAPE_T:
+            AddShapeWithClearanceToContainer( (PCB_SHAPE*) item, aContainer, aLayerId, 0 );
+
+            ( (PCB_SHAPE*) item )->TransformShapeWithClearanceToPolygon( *aLayerPoly,
+                                                                         aLayerId, 0,
+                                                                         ARC_HIGH_DEF,
+                                                                         ERROR_INSIDE );
+            break;
+
+        case PCB_TEXT_T:
+            AddShapeWithClearanceToContainer( (PCB_TEXT*) item, aContainer, aLayerId, 0 );
+
+            ( (PCB_TEXT*) item )->TransformShapeWithClearanceToPolygonSet( *aLayerPoly, 0,
+                                                                           ARC_HIGH_DEF,
+                                                                           ERROR_INSIDE );
+            break;
+
+        case PCB_DIM_ALIGNED_T:
+        case PCB_DIM_CENTER_T:
+        case PCB_DIM_ORTHOGONAL_T:
+        case PCB_DIM_LEADER_T:
+            AddShapeWithClearanceToContainer( (DIMENSION*) item, aContainer, aLayerId, 0 );
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    // Add modules tech layers - objects and contours
+    for( MODULE* module : m_board->Modules() )
+    {
+        if( ( aLayerId == F_SilkS ) || ( aLayerId == B_SilkS ) )
+        {
+            const int linewidth = g_DrawDefaultLineThickness;
+
+            for( D_PAD* pad : module->Pads() )
+            {
+                if( !pad->IsOnLayer( aLayerId ) )
+                    continue;
+
+                buildPadShapeThickOutlineAsSegments( pad, aContainer, linewidth );
+                buildPadShapeThickOutlineAsPolygon( pad, *aLayerPoly, linewidth );
+            }
+        }
+        else
+        {
+            AddPadsShapesWithClearanceToContainer( module, aContainer, aLayerId, 0,
+                                                   false,
+                                                   false,
+                                                   false );
+
+            module->TransformPadsShapesWithClearanceToPolygon( *aLayerPoly, aLayerId, 0,
+                                                               ARC_HIGH_DEF, ERROR_INSIDE );
+        }
+
+        AddGraphicsShapesWithClearanceToContainer( module, aContainer, aLayerId, 0 );
+
+        // On tech layers, use a poor circle approximation, only for texts (stroke font)
+        module->TransformGraphicTextWithClearanceToPolygonSet( *aLayerPoly, aLayerId, 0,
+                                                               ARC_HIGH_DEF, ERROR_INSIDE );
+
+        // Add the remaining things with dynamic seg count for circles
+        transformGraphicModuleEdgeToPolygonSet( module, aLayerId, *aLayerPoly );
+    }
+
+    // Draw non copper zones
+    if( GetFlag( FL_ZONE ) )
+    {
+        for( ZONE_CONTAINER* zone : m_board->Zones() )
+        {
+            if( !zone->IsOnLayer( aLayerId ) )
+                continue;
+
+            AddSolidAreasShapesToContainer( zone, aContainer, aLayerId );
+            zone->TransformSolidAreasShapesToPolygon( aLayerId, *aLayerPoly );
+        }
+    }
+
+    // This will make a union of all added contours
+    aLayerPoly->Simplify( SHAPE_POLY_SET::PM_FAST );
+}
+
+
+void BOARD_ADAPTER::createLayers( REPORTER* aStatusReporter )
+{
     // Build Copper layers
     // Based on: https://github.com/KiCad/kicad-source-mirror/blob/master/3d-viewer/3d_draw.cpp#L692
     // /////////////////////////////////////////////////////////////////////////
@@ -179,7 +572,7 @@ void BOARD_ADAPTER::createLayers( REPORTER* aStatusReporter )
     if( m_stats_nr_vias )
         m_stats_via_med_hole_diameter /= (float)m_stats_nr_vias;
 
-    // Prepare copper layers index and containers
+    // Prepare copper and tech layers index
     // /////////////////////////////////////////////////////////////////////////
     std::vector< PCB_LAYER_ID > layer_id;
     layer_id.clear();
@@ -196,61 +589,128 @@ void BOARD_ADAPTER::createLayers( REPORTER* aStatusReporter )
             continue;
 
         layer_id.push_back( curr_layer_id );
+    }
 
-        CBVHCONTAINER2D *layerContainer = new CBVHCONTAINER2D;
-        m_layers_container2D[curr_layer_id] = layerContainer;
+    // draw graphic items, on technical layers
+    static const PCB_LAYER_ID teckLayerList[] = {
+            B_Adhes,
+            F_Adhes,
+            B_Paste,
+            F_Paste,
+            B_SilkS,
+            F_SilkS,
+            B_Mask,
+            F_Mask,
 
-        if( GetFlag( FL_RENDER_OPENGL_COPPER_THICKNESS )
-                && ( m_render_engine == RENDER_ENGINE::OPENGL_LEGACY ) )
-        {
-            SHAPE_POLY_SET* layerPoly    = new SHAPE_POLY_SET;
-            m_layers_poly[curr_layer_id] = layerPoly;
-        }
+            // Aux Layers
+            Dwgs_User,
+            Cmts_User,
+            Eco1_User,
+            Eco2_User,
+            Edge_Cuts,
+            Margin
+        };
+
+    std::vector< PCB_LAYER_ID > tech_layer_id;
+
+    // User layers are not drawn here, only technical layers
+    for( LSEQ seq = LSET::AllNonCuMask().Seq( teckLayerList, arrayDim( teckLayerList ) );
+         seq;
+         ++seq )
+    {
+        if( Is3DLayerEnabled( *seq ) )
+            tech_layer_id.push_back( *seq );
     }
 
-    if( GetFlag( FL_RENDER_PLATED_PADS_AS_PLATED ) )
+    // Find the layers which are unchanged since the last build, and keep them.
+    // The hash pass also builds the pads effective shapes, which are not thread safe.
+    // /////////////////////////////////////////////////////////////////////////
+    std::map< PCB_LAYER_ID, size_t > layerHashes;
+    MAP_CONTAINER_2D                 reusedContainers;
+    MAP_POLY                         reusedPolys;
+
+    for( const std::vector< PCB_LAYER_ID >* layers : { &layer_id, &tech_layer_id } )
     {
-        m_F_Cu_PlatedPads_poly = new SHAPE_POLY_SET;
-        m_B_Cu_PlatedPads_poly = new SHAPE_POLY_SET;
+        for( PCB_LAYER_ID layer : *layers )
+        {
+            const size_t hash = layerContentHash( layer, trackList );
+            layerHashes[layer] = hash;
 
-        m_platedpads_container2D_F_Cu = new CBVHCONTAINER2D;
-        m_platedpads_container2D_B_Cu = new CBVHCONTAINER2D;
+            auto prevHash = m_layerHashes.find( layer );
+            auto prevContainer = m_layers_container2D.find( layer );
 
+            if( prevHash == m_layerHashes.end() || prevHash->second != hash
+                    || prevContainer == m_layers_container2D.end() || !prevContainer->second )
+            {
+                continue;
+            }
+
+            reusedContainers[layer] = prevContainer->second;
+            m_layers_container2D.erase( prevContainer );
+
+            auto prevPoly = m_layers_poly.find( layer );
+
+            if( prevPoly != m_layers_poly.end() )
+            {
+                reusedPolys[layer] = prevPoly->second;
+                m_layers_poly.erase( prevPoly );
+            }
+        }
     }
 
-    if( aStatusReporter )
-        aStatusReporter->Report( _( "Create tracks and vias" ) );
+    destroyLayers();
+
+    m_layerHashes = std::move( layerHashes );
+    m_layers_container2D.insert( reusedContainers.begin(), reusedContainers.end() );
+    m_layers_poly.insert( reusedPolys.begin(), reusedPolys.end() );
+
+    wxLogTrace( m_logTrace, wxT( "createLayers: %zu of %zu layers reused" ),
+                reusedContainers.size(), m_layerHashes.size() );
 
-    // Create tracks as objects and add it to container
+    // Prepare the containers of the layers to build
     // /////////////////////////////////////////////////////////////////////////
+    const bool copperPolys = GetFlag( FL_RENDER_OPENGL_COPPER_THICKNESS )
+                             && ( m_render_engine == RENDER_ENGINE::OPENGL_LEGACY );
+
+    std::vector< PCB_LAYER_ID > layers_to_build;
+
     for( PCB_LAYER_ID curr_layer_id : layer_id )
     {
-        wxASSERT( m_layers_container2D.find( curr_layer_id ) != m_layers_container2D.end() );
+        if( reusedContainers.count( curr_layer_id ) )
+            continue;
 
-        CBVHCONTAINER2D *layerContainer = m_layers_container2D[curr_layer_id];
+        layers_to_build.push_back( curr_layer_id );
+        m_layers_container2D[curr_layer_id] = new CBVHCONTAINER2D;
 
-        // Add track segments shapes and via annulus shapes
-        unsigned int nTracks = trackList.size();
+        if( copperPolys )
+            m_layers_poly[curr_layer_id] = new SHAPE_POLY_SET;
+    }
 
-        for( unsigned int trackIdx = 0; trackIdx < nTracks; ++trackIdx )
-        {
-            const TRACK *track = trackList[trackIdx];
+    const size_t nr_copper_layers_to_build = layers_to_build.size();
 
-            // NOTE: Vias can be on multiple layers
-            if( !track->IsOnLayer( curr_layer_id ) )
-                continue;
+    for( PCB_LAYER_ID curr_layer_id : tech_layer_id )
+    {
+        if( reusedContainers.count( curr_layer_id ) )
+            continue;
 
-            // Skip vias annulus when not connected on this layer (if removing is enabled)
-            const VIA *via = dyn_cast< const VIA*>( track );
+        layers_to_build.push_back( curr_layer_id );
+        m_layers_container2D[curr_layer_id] = new CBVHCONTAINER2D;
+        m_layers_poly[curr_layer_id] = new SHAPE_POLY_SET;
+    }
 
-            if( via && !via->FlashLayer( curr_layer_id ) && IsCopperLayer( curr_layer_id ) )
-                continue;
+    if( GetFlag( FL_RENDER_PLATED_PADS_AS_PLATED ) )
+    {
+        m_F_Cu_PlatedPads_poly = new SHAPE_POLY_SET;
+        m_B_Cu_PlatedPads_poly = new SHAPE_POLY_SET;
+
+        m_platedpads_container2D_F_Cu = new CBVHCONTAINER2D;
+        m_platedpads_container2D_B_Cu = new CBVHCONTAINER2D;
 
-            // Add object item to layer container
-            createNewTrack( track, layerContainer, 0.0f );
-        }
     }
 
+    if( aStatusReporter )
+        aStatusReporter->Report( _( "Create tracks and vias" ) );
+
     // Create VIAS and THTs objects and add it to holes containers
     // /////////////////////////////////////////////////////////////////////////
     for( PCB_LAYER_ID curr_layer_id : layer_id )
@@ -424,40 +884,6 @@ void BOARD_ADAPTER::createLayers( REPORTER* aStatusReporter )
         }
     }
 
-    // Creates vertical outline contours of the tracks and add it to the poly of the layer
-    // /////////////////////////////////////////////////////////////////////////
-    if( GetFlag( FL_RENDER_OPENGL_COPPER_THICKNESS )
-            && ( m_render_engine == RENDER_ENGINE::OPENGL_LEGACY ) )
-    {
-        for( PCB_LAYER_ID curr_layer_id : layer_id )
-        {
-            wxASSERT( m_layers_poly.find( curr_layer_id ) != m_layers_poly.end() );
-
-            SHAPE_POLY_SET *layerPoly = m_layers_poly[curr_layer_id];
-
-            // ADD TRACKS
-            unsigned int nTracks = trackList.size();
-
-            for( unsigned int trackIdx = 0; trackIdx < nTracks; ++trackIdx )
-            {
-                const TRACK *track = trackList[trackIdx];
-
-                if( !track->IsOnLayer( curr_layer_id ) )
-                    continue;
-
-                // Skip vias annulus when not connected on this layer (if removing is enabled)
-                const VIA *via = dyn_cast< const VIA*>( track );
-
-                if( via && !via->FlashLayer( curr_layer_id ) && IsCopperLayer( curr_layer_id ) )
-                    continue;
-
-                // Add the track/via contour
-                track->TransformShapeWithClearanceToPolygon( *layerPoly, curr_layer_id, 0,
-                                                             ARC_HIGH_DEF, ERROR_INSIDE );
-            }
-        }
-    }
-
     // Add holes of modules
     // /////////////////////////////////////////////////////////////////////////
     for( MODULE* module : m_board->Modules() )
@@ -532,29 +958,7 @@ void BOARD_ADAPTER::createLayers( REPORTER* aStatusReporter )
         }
     }
 
-    const bool renderPlatedPadsAsPlated = GetFlag( FL_RENDER_PLATED_PADS_AS_PLATED );
-
-    // Add modules PADs objects to containers
-    for( PCB_LAYER_ID curr_layer_id : layer_id )
-    {
-        wxASSERT( m_layers_container2D.find( curr_layer_id ) != m_layers_container2D.end() );
-
-        CBVHCONTAINER2D *layerContainer = m_layers_container2D[curr_layer_id];
-
-        // ADD PADS
-        for( MODULE* module : m_board->Modules() )
-        {
-            // Note: NPTH pads are not drawn on copper layers when the pad
-            // has same shape as its hole
-            AddPadsShapesWithClearanceToContainer( module, layerContainer, curr_layer_id, 0,
-                                                   true, renderPlatedPadsAsPlated, false );
-
-            // Micro-wave modules may have items on copper layers
-            AddGraphicsShapesWithClearanceToContainer( module, layerContainer, curr_layer_id, 0 );
-        }
-    }
-
-    if( renderPlatedPadsAsPlated )
+    if( GetFlag( FL_RENDER_PLATED_PADS_AS_PLATED ) )
     {
         // ADD PLATED PADS
         for( MODULE* module : m_board->Modules() )
@@ -565,133 +969,19 @@ void BOARD_ADAPTER::createLayers( REPORTER* aStatusReporter )
             AddPadsShapesWithClearanceToContainer( module, m_platedpads_container2D_B_Cu, B_Cu, 0,
                                                    true, false, true );
         }
-    }
-
-    // Add modules PADs poly contourns (vertical outlines)
-    if( GetFlag( FL_RENDER_OPENGL_COPPER_THICKNESS )
-            && ( m_render_engine == RENDER_ENGINE::OPENGL_LEGACY ) )
-    {
-        for( PCB_LAYER_ID curr_layer_id : layer_id )
-        {
-            wxASSERT( m_layers_poly.find( curr_layer_id ) != m_layers_poly.end() );
-
-            SHAPE_POLY_SET *layerPoly = m_layers_poly[curr_layer_id];
-
-            // Add pads to polygon list
-            for( auto module : m_board->Modules() )
-            {
-                // Note: NPTH pads are not drawn on copper layers when the pad
-                // has same shape as its hole
-                module->TransformPadsShapesWithClearanceToPolygon( *layerPoly, curr_layer_id,
-                                                                   0, ARC_HIGH_DEF, ERROR_INSIDE,
-                                                                   true, renderPlatedPadsAsPlated,
-                                                                   false );
-
-                transformGraphicModuleEdgeToPolygonSet( module, curr_layer_id, *layerPoly );
-            }
-        }
 
-        if( renderPlatedPadsAsPlated )
+        // ADD PLATED PADS contourns (vertical outlines)
+        if( copperPolys )
         {
-            // ADD PLATED PADS contourns
-            for( auto module : m_board->Modules() )
+            for( MODULE* module : m_board->Modules() )
             {
                 module->TransformPadsShapesWithClearanceToPolygon( *m_F_Cu_PlatedPads_poly, F_Cu,
                                                                    0, ARC_HIGH_DEF, ERROR_INSIDE,
                                                                    true, false, true );
 
-                //transformGraphicModuleEdgeToPolygonSet( module, F_Cu, *m_F_Cu_PlatedPads_poly );
-
                 module->TransformPadsShapesWithClearanceToPolygon( *m_B_Cu_PlatedPads_poly, B_Cu,
                                                                    0, ARC_HIGH_DEF, ERROR_INSIDE,
                                                                    true, false, true );
-
-                //transformGraphicModuleEdgeToPolygonSet( module, B_Cu, *m_B_Cu_PlatedPads_poly );
-            }
-        }
-    }
-
-
-    // Add graphic item on copper layers to object containers
-    for( PCB_LAYER_ID curr_layer_id : layer_id )
-    {
-        wxASSERT( m_layers_container2D.find( curr_layer_id ) != m_layers_container2D.end() );
-
-        CBVHCONTAINER2D *layerContainer = m_layers_container2D[curr_layer_id];
-
-        // Add graphic items on copper layers (texts and other graphics)
-        for( auto item : m_board->Drawings() )
-        {
-            if( !item->IsOnLayer( curr_layer_id ) )
-                continue;
-
-            switch( item->Type() )
-            {
-            case PCB_SHAPE_T:
-            {
-                AddShapeWithClearanceToContainer( (PCB_SHAPE*)item, layerContainer, curr_layer_id,
-                                                  0 );
-            }
-            break;
-
-            case PCB_TEXT_T:
-                AddShapeWithClearanceToContainer( (PCB_TEXT*) item, layerContainer, curr_layer_id,
-                                                  0 );
-            break;
-
-            case PCB_DIM_ALIGNED_T:
-            case PCB_DIM_CENTER_T:
-            case PCB_DIM_ORTHOGONAL_T:
-            case PCB_DIM_LEADER_T:
-                AddShapeWithClearanceToContainer( (DIMENSION*) item, layerContainer, curr_layer_id,
-                                                  0 );
-            break;
-
-            default:
-                wxLogTrace( m_logTrace,
-                            wxT( "createLayers: item type: %d not implemented" ),
-                            item->Type() );
-            break;
-            }
-        }
-    }
-
-    // Add graphic item on copper layers to poly contourns (vertical outlines)
-    if( GetFlag( FL_RENDER_OPENGL_COPPER_THICKNESS )
-            && ( m_render_engine == RENDER_ENGINE::OPENGL_LEGACY ) )
-    {
-        for( PCB_LAYER_ID cur_layer_id : layer_id )
-        {
-            wxASSERT( m_layers_poly.find( cur_layer_id ) != m_layers_poly.end() );
-
-            SHAPE_POLY_SET *layerPoly = m_layers_poly[cur_layer_id];
-
-            // Add graphic items on copper layers (texts and other )
-            for( BOARD_ITEM* item : m_board->Drawings() )
-            {
-                if( !item->IsOnLayer( cur_layer_id ) )
-                    continue;
-
-                switch( item->Type() )
-                {
-                case PCB_SHAPE_T:
-                    ( (PCB_SHAPE*) item )->TransformShapeWithClearanceToPolygon( *layerPoly,
-                                                                                 cur_layer_id, 0,
-                                                                                 ARC_HIGH_DEF,
-                                                                                 ERROR_INSIDE );
-                    break;
-
-                case PCB_TEXT_T:
-                    ( (PCB_TEXT*) item )->TransformShapeWithClearanceToPolygonSet( *layerPoly, 0,
-                                                                                   ARC_HIGH_DEF,
-                                                                                   ERROR_INSIDE );
-                    break;
-
-                default:
-                    wxLogTrace( m_logTrace, wxT( "createLayers: item type: %d not implemented" ),
-                                item->Type() );
-                    break;
-                }
             }
         }
     }
@@ -702,11 +992,17 @@ void BOARD_ADAPTER::createLayers( REPORTER* aStatusReporter )
             aStatusReporter->Report( _( "Create zones" ) );
 
         std::vector<std::pair<const ZONE_CONTAINER*, PCB_LAYER_ID>> zones;
+        const auto copperLayersBegin = layers_to_build.begin();
+        const auto copperLayersEnd = copperLayersBegin + nr_copper_layers_to_build;
 
         for( ZONE_CONTAINER* zone : m_board->Zones() )
         {
+            // Only the copper layers to build: tech layers add their zones themselves
             for( PCB_LAYER_ID layer : zone->GetLayerSet().Seq() )
-                zones.emplace_back( std::make_pair( zone, layer ) );
+            {
+                if( std::find( copperLayersBegin, copperLayersEnd, layer ) != copperLayersEnd )
+                    zones.emplace_back( std::make_pair( zone, layer ) );
+            }
         }
 
         // Add zones objects
@@ -747,104 +1043,57 @@ void BOARD_ADAPTER::createLayers( REPORTER* aStatusReporter )
 
     }
 
-    if( GetFlag( FL_ZONE ) && GetFlag( FL_RENDER_OPENGL_COPPER_THICKNESS )
-            && ( m_render_engine == RENDER_ENGINE::OPENGL_LEGACY ) )
-    {
-        // Add copper zones
-        for( ZONE_CONTAINER* zone : m_board->Zones() )
-        {
-            if( zone == nullptr )
-                break;
-
-            for( PCB_LAYER_ID layer : zone->GetLayerSet().Seq() )
-            {
-                auto layerContainer = m_layers_poly.find( layer );
-
-                if( layerContainer != m_layers_poly.end() )
-                    zone->TransformSolidAreasShapesToPolygon( layer, *layerContainer->second );
-            }
-        }
-    }
-
-    // Simplify layer polygons
-
+    // Build the content of the layers, one layer per task
+    // /////////////////////////////////////////////////////////////////////////
     if( aStatusReporter )
-        aStatusReporter->Report( _( "Simplifying copper layers polygons" ) );
+        aStatusReporter->Report( _( "Build layers" ) );
 
-    if( GetFlag( FL_RENDER_OPENGL_COPPER_THICKNESS )
-            && ( m_render_engine == RENDER_ENGINE::OPENGL_LEGACY ) )
+    if( !layers_to_build.empty() )
     {
-        if( GetFlag( FL_RENDER_PLATED_PADS_AS_PLATED ) )
-        {
-            if( m_F_Cu_PlatedPads_poly && ( m_layers_poly.find( F_Cu ) != m_layers_poly.end() ) )
-            {
-                SHAPE_POLY_SET *layerPoly_F_Cu = m_layers_poly[F_Cu];
-                layerPoly_F_Cu->BooleanSubtract( *m_F_Cu_PlatedPads_poly, SHAPE_POLY_SET::POLYGON_MODE::PM_FAST );
-
-                m_F_Cu_PlatedPads_poly->Simplify( SHAPE_POLY_SET::PM_FAST );
-            }
-
-            if( m_B_Cu_PlatedPads_poly && ( m_layers_poly.find( B_Cu ) != m_layers_poly.end() ) )
-            {
-                SHAPE_POLY_SET *layerPoly_B_Cu = m_layers_poly[B_Cu];
-                layerPoly_B_Cu->BooleanSubtract( *m_B_Cu_PlatedPads_poly, SHAPE_POLY_SET::POLYGON_MODE::PM_FAST );
-
-                m_B_Cu_PlatedPads_poly->Simplify( SHAPE_POLY_SET::PM_FAST );
-            }
-        }
-
-        std::vector< PCB_LAYER_ID > &selected_layer_id = layer_id;
-        std::vector< PCB_LAYER_ID > layer_id_without_F_and_B;
-
-        if( GetFlag( FL_RENDER_PLATED_PADS_AS_PLATED ) )
-        {
-            layer_id_without_F_and_B.clear();
-            layer_id_without_F_and_B.reserve( layer_id.size() );
-
-            for( size_t i = 0; i < layer_id.size(); ++i )
-            {
-                if( ( layer_id[i] != F_Cu ) &&
-                    ( layer_id[i] != B_Cu ) )
-                    layer_id_without_F_and_B.push_back( layer_id[i] );
-            }
+        std::atomic<size_t> nextLayer( 0 );
+        std::atomic<size_t> threadsFinished( 0 );
 
-            selected_layer_id = layer_id_without_F_and_B;
-        }
+        size_t parallelThreadCount = std::min<size_t>(
+                std::max<size_t>( std::thread::hardware_concurrency(), 2 ),
+                layers_to_build.size() );
 
-        if( selected_layer_id.size() > 0 )
+        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
         {
-            std::atomic<size_t> nextItem( 0 );
-            std::atomic<size_t> threadsFinished( 0 );
-
-            size_t parallelThreadCount = std::min<size_t>(
-                    std::max<size_t>( std::thread::hardware_concurrency(), 2 ),
-                    selected_layer_id.size() );
-            for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+            std::thread t = std::thread( [&]()
             {
-                std::thread t = std::thread( [&nextItem, &threadsFinished, &selected_layer_id, this]()
+                for( size_t i = nextLayer.fetch_add( 1 );
+                            i < layers_to_build.size();
+                            i = nextLayer.fetch_add( 1 ) )
                 {
-                    for( size_t i = nextItem.fetch_add( 1 );
-                                i < selected_layer_id.size();
-                                i = nextItem.fetch_add( 1 ) )
-                    {
-                        auto layerPoly = m_layers_poly.find( selected_layer_id[i] );
-
-                        if( layerPoly != m_layers_poly.end() )
-                            // This will make a union of all added contours
-                            layerPoly->second->Simplify( SHAPE_POLY_SET::PM_FAST );
-                    }
-
-                    threadsFinished++;
-                } );
+                    const PCB_LAYER_ID layer = layers_to_build[i];
+                    CBVHCONTAINER2D*   layerContainer = m_layers_container2D.find( layer )->second;
+                    auto               layerPoly = m_layers_poly.find( layer );
+                    SHAPE_POLY_SET*    poly = ( layerPoly != m_layers_poly.end() )
+                                                      ? layerPoly->second
+                                                      : nullptr;
+
+                    if( i < nr_copper_layers_to_build )
+                        createCopperLayer( layer, layerContainer, poly, trackList );
+                    else
+                        createTechLayer( layer, layerContainer, poly );
+                }
 
-                t.detach();
-            }
+                threadsFinished++;
+            } );
 
-            while( threadsFinished < parallelThreadCount )
-                std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+            t.detach();
         }
+
+        while( threadsFinished < parallelThreadCount )
+            std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
     }
 
+    if( m_F_Cu_PlatedPads_poly && ( m_layers_poly.find( F_Cu ) != m_layers_poly.end() ) )
+        m_F_Cu_PlatedPads_poly->Simplify( SHAPE_POLY_SET::PM_FAST );
+
+    if( m_B_Cu_PlatedPads_poly && ( m_layers_poly.find( B_Cu ) != m_layers_poly.end() ) )
+        m_B_Cu_PlatedPads_poly->Simplify( SHAPE_POLY_SET::PM_FAST );
+
     // Simplify holes polygon contours
     // /////////////////////////////////////////////////////////////////////////
     if( aStatusReporter )
@@ -865,200 +1114,12 @@ void BOARD_ADAPTER::createLayers( REPORTER* aStatusReporter )
         }
     }
 
-    // End Build Copper layers
-
     // This will make a union of all added contourns
     m_through_outer_holes_poly.Simplify( SHAPE_POLY_SET::PM_FAST );
     m_through_outer_holes_poly_NPTH.Simplify( SHAPE_POLY_SET::PM_FAST );
     m_through_outer_holes_vias_poly.Simplify( SHAPE_POLY_SET::PM_FAST );
     m_through_outer_ring_holes_poly.Simplify( SHAPE_POLY_SET::PM_FAST );
 
-    // Build Tech layers
-    // Based on: https://github.com/KiCad/kicad-source-mirror/blob/master/3d-viewer/3d_draw.cpp#L1059
-    // /////////////////////////////////////////////////////////////////////////
-    if( aStatusReporter )
-        aStatusReporter->Report( _( "Build Tech layers" ) );
-
-    // draw graphic items, on technical layers
-    static const PCB_LAYER_ID teckLayerList[] = {
-            B_Adhes,
-            F_Adhes,
-            B_Paste,
-            F_Paste,
-            B_SilkS,
-            F_SilkS,
-            B_Mask,
-            F_Mask,
-
-            // Aux Layers
-            Dwgs_User,
-            Cmts_User,
-            Eco1_User,
-            Eco2_User,
-            Edge_Cuts,
-            Margin
-        };
-
-    // User layers are not drawn here, only technical layers
-    for( LSEQ seq = LSET::AllNonCuMask().Seq( teckLayerList, arrayDim( teckLayerList ) );
-         seq;
-         ++seq )
-    {
-        const PCB_LAYER_ID curr_layer_id = *seq;
-
-        if( !Is3DLayerEnabled( curr_layer_id ) )
-            continue;
-
-        CBVHCONTAINER2D *layerContainer = new CBVHCONTAINER2D;
-        m_layers_container2D[curr_layer_id] = layerContainer;
-
-        SHAPE_POLY_SET *layerPoly = new SHAPE_POLY_SET;
-        m_layers_poly[curr_layer_id] = layerPoly;
-
-        // Add drawing objects
-        for( BOARD_ITEM* item : m_board->Drawings() )
-        {
-            if( !item->IsOnLayer( curr_layer_id ) )
-                continue;
-
-            switch( item->Type() )
-            {
-            case PCB_SHAPE_T:
-                AddShapeWithClearanceToContainer( (PCB_SHAPE*) item,
-                                                  layerContainer,
-                                                  curr_layer_id,
-                                                  0 );
-                break;
-
-            case PCB_TEXT_T:
-                AddShapeWithClearanceToContainer( (PCB_TEXT*) item,
-                                                  layerContainer,
-                                                  curr_layer_id,
-                                                  0 );
-                break;
-
-            case PCB_DIM_ALIGNED_T:
-            case PCB_DIM_CENTER_T:
-            case PCB_DIM_ORTHOGONAL_T:
-            case PCB_DIM_LEADER_T:
-                AddShapeWithClearanceToContainer( (DIMENSION*) item,
-                                                  layerContainer,
-                                                  curr_layer_id,
-                                                  0 );
-                break;
-
-            default:
-                break;
-            }
-        }
-
-
-        // Add drawing contours
-        for( BOARD_ITEM* item : m_board->Drawings() )
-        {
-            if( !item->IsOnLayer( curr_layer_id ) )
-                continue;
-
-            switch( item->Type() )
-            {
-            case PCB_SHAPE_T:
-                ( (PCB_SHAPE*) item )->TransformShapeWithClearanceToPolygon( *layerPoly,
-                                                                             curr_layer_id, 0,
-                                                                             ARC_HIGH_DEF,
-                                                                             ERROR_INSIDE );
-                break;
-
-            case PCB_TEXT_T:
-                ( (PCB_TEXT*) item )->TransformShapeWithClearanceToPolygonSet( *layerPoly, 0,
-                                                                               ARC_HIGH_DEF,
-                                                                               ERROR_INSIDE );
-                break;
-
-            default:
-                break;
-            }
-        }
-
-
-        // Add modules tech layers - objects
-        // /////////////////////////////////////////////////////////////////////
-        for( MODULE* module : m_board->Modules() )
-        {
-            if( (curr_layer_id == F_SilkS) || (curr_layer_id == B_SilkS) )
-            {
-                int     linewidth = g_DrawDefaultLineThickness;
-
-                for( D_PAD* pad : module->Pads() )
-                {
-                    if( !pad->IsOnLayer( curr_layer_id ) )
-                        continue;
-
-                    buildPadShapeThickOutlineAsSegments( pad, layerContainer, linewidth );
-                }
-            }
-            else
-            {
-                AddPadsShapesWithClearanceToContainer( module, layerContainer, curr_layer_id, 0,
-                                                       false,
-                                                       false,
-                                                       false );
-            }
-
-            AddGraphicsShapesWithClearanceToContainer( module, layerContainer, curr_layer_id, 0 );
-        }
-
-
-        // Add modules tech layers - contours
-        for( MODULE* module : m_board->Modules() )
-        {
-            if( (curr_layer_id == F_SilkS) || (curr_layer_id == B_SilkS) )
-            {
-                const int linewidth = g_DrawDefaultLineThickness;
-
-                for( D_PAD* pad : module->Pads() )
-                {
-                    if( !pad->IsOnLayer( curr_layer_id ) )
-                        continue;
-
-                    buildPadShapeThickOutlineAsPolygon( pad, *layerPoly, linewidth );
-                }
-            }
-            else
-            {
-                module->TransformPadsShapesWithClearanceToPolygon( *layerPoly, curr_layer_id, 0,
-                                                                   ARC_HIGH_DEF, ERROR_INSIDE );
-            }
-
-            // On tech layers, use a poor circle approximation, only for texts (stroke font)
-            module->TransformGraphicTextWithClearanceToPolygonSet( *layerPoly, curr_layer_id, 0,
-                                                                   ARC_HIGH_DEF, ERROR_INSIDE );
-
-            // Add the remaining things with dynamic seg count for circles
-            transformGraphicModuleEdgeToPolygonSet( module, curr_layer_id, *layerPoly );
-        }
-
-
-        // Draw non copper zones
-        if( GetFlag( FL_ZONE ) )
-        {
-            for( ZONE_CONTAINER* zone : m_board->Zones() )
-            {
-                if( zone->IsOnLayer( curr_layer_id ) )
-                    AddSolidAreasShapesToContainer( zone, layerContainer, curr_layer_id );
-            }
-
-            for( ZONE_CONTAINER* zone : m_board->Zones() )
-            {
-                if( zone->IsOnLayer( curr_layer_id ) )
-                    zone->TransformSolidAreasShapesToPolygon( curr_layer_id, *layerPoly );
-            }
-        }
-
-        // This will make a union of all added contours
-        layerPoly->Simplify( SHAPE_POLY_SET::PM_FAST );
-    }
-    // End Build Tech layers
-
     // Build BVH (Bounding volume hierarchy) for holes and vias
 
     if( aStatusReporter )
@@ -908,6 +908,10 @@ void C3D_RENDER_OGL_LEGACY::load_3D_models( REPORTER* aStatusReporter )
        (!m_boardAdapter.GetFlag( FL_MODULE_ATTRIBUTES_VIRTUAL )) )
         return;
 
+    // Fill the cache on several threads; all the models are kept since the
+    // footprints shown depend on flags that do not reload the scene
+    m_boardAdapter.Prefetch3DModels( false );
+
     // Go for all modules
     for( MODULE* module : m_boardAdapter.GetBoard()->Modules() )
     {
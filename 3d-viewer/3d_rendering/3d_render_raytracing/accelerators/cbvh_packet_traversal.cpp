@@ -28,6 +28,8 @@
  */
 
 #include "cbvh_pbrt.h"
+#include <algorithm>
+#include <cmath>
 #include <wx/debug.h>
 
 
@@ -72,21 +74,210 @@ static inline unsigned int getFirstHit( const RAYPACKET &aRayPacket,
 
 #ifdef BVH_RANGED_TRAVERSAL
 
-static inline unsigned int getLastHit( const RAYPACKET &aRayPacket,
+// Node tests of the ranged traversal are done on several rays at once, using the widest
+// vector instructions enabled at compile time
+#if defined( __AVX2__ )
+#include <immintrin.h>
+#define PACKET_LANES 8
+#elif defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#include <emmintrin.h>
+#define PACKET_LANES 4
+#else
+#define PACKET_LANES 4
+#define PACKET_SCALAR
+#endif
+
+
+/**
+ * Ray packet data laid out for the vector kernels: one array per component.
+ */
+struct PACKET_SOA
+{
+    alignas( 32 ) float ox[RAYPACKET_RAYS_PER_PACKET];
+    alignas( 32 ) float oy[RAYPACKET_RAYS_PER_PACKET];
+    alignas( 32 ) float oz[RAYPACKET_RAYS_PER_PACKET];
+    alignas( 32 ) float ix[RAYPACKET_RAYS_PER_PACKET];
+    alignas( 32 ) float iy[RAYPACKET_RAYS_PER_PACKET];
+    alignas( 32 ) float iz[RAYPACKET_RAYS_PER_PACKET];
+    alignas( 32 ) float tHit[RAYPACKET_RAYS_PER_PACKET];
+
+    PACKET_SOA( const RAYPACKET &aRayPacket, const HITINFO_PACKET *aHitInfoPacket )
+    {
+        for( unsigned int i = 0; i < RAYPACKET_RAYS_PER_PACKET; ++i )
+        {
+            const RAY &ray = aRayPacket.m_ray[i];
+
+            ox[i] = ray.m_Origin.x;
+            oy[i] = ray.m_Origin.y;
+            oz[i] = ray.m_Origin.z;
+            ix[i] = ray.m_InvDir.x;
+            iy[i] = ray.m_InvDir.y;
+            iz[i] = ray.m_InvDir.z;
+            tHit[i] = aHitInfoPacket[i].m_HitInfo.m_tHit;
+        }
+    }
+};
+
+
+/**
+ * Slab test of the PACKET_LANES rays starting at aFirst against a box.
+ * @return a bit mask of the rays that enter the box before their current hit.  Lanes with
+ * undefined results (a ray parallel to and lying on a box plane) are reported as hits, the
+ * primitive tests decide for them.
+ */
+static inline unsigned int hitLanes( const PACKET_SOA &aPacket, const CBBOX &aBBox,
+                                     unsigned int aFirst )
+{
+#if defined( __AVX2__ )
+    const __m256 ix = _mm256_load_ps( &aPacket.ix[aFirst] );
+    const __m256 iy = _mm256_load_ps( &aPacket.iy[aFirst] );
+    const __m256 iz = _mm256_load_ps( &aPacket.iz[aFirst] );
+    const __m256 ox = _mm256_load_ps( &aPacket.ox[aFirst] );
+    const __m256 oy = _mm256_load_ps( &aPacket.oy[aFirst] );
+    const __m256 oz = _mm256_load_ps( &aPacket.oz[aFirst] );
+
+    const __m256 x0 = _mm256_mul_ps( _mm256_sub_ps( _mm256_set1_ps( aBBox.Min().x ), ox ), ix );
+    const __m256 x1 = _mm256_mul_ps( _mm256_sub_ps( _mm256_set1_ps( aBBox.Max().x ), ox ), ix );
+    const __m256 y0 = _mm256_mul_ps( _mm256_sub_ps( _mm256_set1_ps( aBBox.Min().y ), oy ), iy );
+    const __m256 y1 = _mm256_mul_ps( _mm256_sub_ps( _mm256_set1_ps( aBBox.Max().y ), oy ), iy );
+    const __m256 z0 = _mm256_mul_ps( _mm256_sub_ps( _mm256_set1_ps( aBBox.Min().z ), oz ), iz );
+    const __m256 z1 = _mm256_mul_ps( _mm256_sub_ps( _mm256_set1_ps( aBBox.Max().z ), oz ), iz );
+
+    const __m256 tNear = _mm256_max_ps( _mm256_max_ps( _mm256_min_ps( x0, x1 ),
+                                                       _mm256_min_ps( y0, y1 ) ),
+                                        _mm256_min_ps( z0, z1 ) );
+    const __m256 tFar  = _mm256_min_ps( _mm256_min_ps( _mm256_max_ps( x0, x1 ),
+                                                       _mm256_max_ps( y0, y1 ) ),
+                                        _mm256_max_ps( z0, z1 ) );
+
+    const __m256 hit = _mm256_and_ps(
+            _mm256_cmp_ps( tFar, _mm256_max_ps( tNear, _mm256_setzero_ps() ), _CMP_GE_OQ ),
+            _mm256_cmp_ps( tNear, _mm256_load_ps( &aPacket.tHit[aFirst] ), _CMP_LT_OQ ) );
+    const __m256 undefined = _mm256_cmp_ps( tNear, tFar, _CMP_UNORD_Q );
+
+    return _mm256_movemask_ps( _mm256_or_ps( hit, undefined ) );
+#elif !defined( PACKET_SCALAR )
+    const __m128 ix = _mm_load_ps( &aPacket.ix[aFirst] );
+    const __m128 iy = _mm_load_ps( &aPacket.iy[aFirst] );
+    const __m128 iz = _mm_load_ps( &aPacket.iz[aFirst] );
+    const __m128 ox = _mm_load_ps( &aPacket.ox[aFirst] );
+    const __m128 oy = _mm_load_ps( &aPacket.oy[aFirst] );
+    const __m128 oz = _mm_load_ps( &aPacket.oz[aFirst] );
+
+    const __m128 x0 = _mm_mul_ps( _mm_sub_ps( _mm_set1_ps( aBBox.Min().x ), ox ), ix );
+    const __m128 x1 = _mm_mul_ps( _mm_sub_ps( _mm_set1_ps( aBBox.Max().x ), ox ), ix );
+    const __m128 y0 = _mm_mul_ps( _mm_sub_ps( _mm_set1_ps( aBBox.Min().y ), oy ), iy );
+    const __m128 y1 = _mm_mul_ps( _mm_sub_ps( _mm_set1_ps( aBBox.Max().y ), oy ), iy );
+    const __m128 z0 = _mm_mul_ps( _mm_sub_ps( _mm_set1_ps( aBBox.Min().z ), oz ), iz );
+    const __m128 z1 = _mm_mul_ps( _mm_sub_ps( _mm_set1_ps( aBBox.Max().z ), oz ), iz );
+
+    const __m128 tNear = _mm_max_ps( _mm_max_ps( _mm_min_ps( x0, x1 ), _mm_min_ps( y0, y1 ) ),
+                                     _mm_min_ps( z0, z1 ) );
+    const __m128 tFar  = _mm_min_ps( _mm_min_ps( _mm_max_ps( x0, x1 ), _mm_max_ps( y0, y1 ) ),
+                                     _mm_max_ps( z0, z1 ) );
+
+    const __m128 hit = _mm_and_ps( _mm_cmpge_ps( tFar, _mm_max_ps( tNear, _mm_setzero_ps() ) ),
+                                   _mm_cmplt_ps( tNear, _mm_load_ps( &aPacket.tHit[aFirst] ) ) );
+    const __m128 undefined = _mm_cmpunord_ps( tNear, tFar );
+
+    return _mm_movemask_ps( _mm_or_ps( hit, undefined ) );
+#else
+    unsigned int mask = 0;
+
+    for( unsigned int lane = 0; lane < PACKET_LANES; ++lane )
+    {
+        const unsigned int i = aFirst + lane;
+
+        const float x0 = ( aBBox.Min().x - aPacket.ox[i] ) * aPacket.ix[i];
+        const float x1 = ( aBBox.Max().x - aPacket.ox[i] ) * aPacket.ix[i];
+        const float y0 = ( aBBox.Min().y - aPacket.oy[i] ) * aPacket.iy[i];
+        const float y1 = ( aBBox.Max().y - aPacket.oy[i] ) * aPacket.iy[i];
+        const float z0 = ( aBBox.Min().z - aPacket.oz[i] ) * aPacket.iz[i];
+        const float z1 = ( aBBox.Max().z - aPacket.oz[i] ) * aPacket.iz[i];
+
+        const float tNear = std::max( std::max( std::min( x0, x1 ), std::min( y0, y1 ) ),
+                                      std::min( z0, z1 ) );
+        const float tFar  = std::min( std::min( std::max( x0, x1 ), std::max( y0, y1 ) ),
+                                      std::max( z0, z1 ) );
+
+        if( std::isnan( tNear ) || std::isnan( tFar )
+                || ( tFar >= std::max( tNear, 0.0f ) && tNear < aPacket.tHit[i] ) )
+        {
+            mask |= 1 << lane;
+        }
+    }
+
+    return mask;
+#endif
+}
+
+
+static inline unsigned int getFirstHit( const RAYPACKET &aRayPacket,
+                                        const PACKET_SOA &aPacket,
+                                        const CBBOX &aBBox,
+                                        unsigned int ia )
+{
+    unsigned int first = ia - ( ia % PACKET_LANES );
+
+    // The first group may contain rays that are already out of the range
+    unsigned int mask = hitLanes( aPacket, aBBox, first ) & ( ~0u << ( ia - first ) );
+
+    if( !mask )
+    {
+        if( !aRayPacket.m_Frustum.Intersect( aBBox ) )
+            return RAYPACKET_RAYS_PER_PACKET;
+
+        for( first += PACKET_LANES; first < RAYPACKET_RAYS_PER_PACKET; first += PACKET_LANES )
+        {
+            mask = hitLanes( aPacket, aBBox, first );
+
+            if( mask )
+                break;
+        }
+
+        if( !mask )
+            return RAYPACKET_RAYS_PER_PACKET;
+    }
+
+    unsigned int lane = 0;
+
+    while( !( mask & ( 1u << lane ) ) )
+        lane++;
+
+    return first + lane;
+}
+
+
+static inline unsigned int getLastHit( const PACKET_SOA &aPacket,
                                        const CBBOX &aBBox,
-                                       unsigned int ia,
-                                       HITINFO_PACKET *aHitInfoPacket )
+                                       unsigned int ia )
 {
-    for( unsigned int ie = (RAYPACKET_RAYS_PER_PACKET - 1); ie > ia; --ie )
+    const unsigned int firstGroup = ia - ( ia % PACKET_LANES );
+
+    for( unsigned int first = RAYPACKET_RAYS_PER_PACKET - PACKET_LANES; first > firstGroup;
+         first -= PACKET_LANES )
     {
-        float hitT;
+        const unsigned int mask = hitLanes( aPacket, aBBox, first );
 
-        if( aBBox.Intersect( aRayPacket.m_ray[ie], &hitT ) )
-            if( hitT < aHitInfoPacket[ie].m_HitInfo.m_tHit )
-                return ie + 1;
+        if( mask )
+        {
+            unsigned int lane = PACKET_LANES - 1;
+
+            while( !( mask & ( 1u << lane ) ) )
+                lane--;
+
+            return first + lane + 1;
+        }
     }
 
-    return ia + 1;
+    // ia itself is known to be a hit
+    const unsigned int mask = hitLanes( aPacket, aBBox, firstGroup );
+    unsigned int       lane = PACKET_LANES - 1;
+
+    while( lane > ia - firstGroup && !( mask & ( 1u << lane ) ) )
+        lane--;
+
+    return firstGroup + lane + 1;
 }
 
 
@@ -107,13 +298,15 @@ bool CBVH_PBRT::Intersect( const RAYPACKET &aRayPacket,
     int todoOffset = 0, nodeNum = 0;
     StackNode todo[MAX_TODOS];
 
+    PACKET_SOA packet( aRayPacket, aHitInfoPacket );
+
     unsigned int ia = 0;
 
     while( true )
     {
         const LinearBVHNode *curCell = &m_nodes[nodeNum];
 
-        ia = getFirstHit( aRayPacket, curCell->bounds, ia, aHitInfoPacket );
+        ia = getFirstHit( aRayPacket, packet, curCell->bounds, ia );
 
         if( ia < RAYPACKET_RAYS_PER_PACKET )
         {
@@ -127,10 +320,7 @@ bool CBVH_PBRT::Intersect( const RAYPACKET &aRayPacket,
             }
             else
             {
-                const unsigned int ie = getLastHit( aRayPacket,
-                                                    curCell->bounds,
-                                                    ia,
-                                                    aHitInfoPacket );
+                const unsigned int ie = getLastHit( packet, curCell->bounds, ia );
 
                 for( int j = 0; j < curCell->nPrimitives; ++j )
                 {
@@ -148,6 +338,7 @@ bool CBVH_PBRT::Intersect( const RAYPACKET &aRayPacket,
                                 anyHitted |= hitted;
                                 aHitInfoPacket[i].m_hitresult |= hitted;
                                 aHitInfoPacket[i].m_HitInfo.m_acc_node_info = nodeNum;
+                                packet.tHit[i] = aHitInfoPacket[i].m_HitInfo.m_tHit;
                             }
                         }
                     }
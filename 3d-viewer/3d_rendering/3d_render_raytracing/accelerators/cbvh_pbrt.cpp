@@ -75,7 +75,9 @@
 #include <cstdlib>
 #include <vector>
 
+#include <future>
 #include <stack>
+#include <thread>
 #include <wx/debug.h>
 
 #ifdef PRINT_STATISTICS_3D_VIEWER
@@ -278,10 +280,27 @@ CBVH_PBRT::CBVH_PBRT( const CGENERICCONTAINER &aObjectContainer,
     BVHBuildNode *root;
 
     if( m_splitMethod == SPLITMETHOD::HLBVH )
+    {
         root = HLBVHBuild( primitiveInfo, &totalNodes, orderedPrims);
+    }
     else
-        root = recursiveBuild( primitiveInfo, 0, m_primitives.size(),
-                               &totalNodes, orderedPrims);
+    {
+        // Spawn a build thread at each of the top levels, enough to keep all cores busy
+        int parallelDepth = 0;
+
+        while( ( 1u << parallelDepth ) < std::thread::hardware_concurrency() )
+            parallelDepth++;
+
+        std::atomic<int> nodeCount( 0 );
+
+        root = recursiveBuild( primitiveInfo, 0, m_primitives.size(), nodeCount,
+                               parallelDepth );
+
+        totalNodes = nodeCount;
+
+        for( const BVHPrimitiveInfo& info : primitiveInfo )
+            orderedPrims.push_back( m_primitives[ info.primitiveNumber ] );
+    }
 
     wxASSERT( m_primitives.size() == orderedPrims.size() );
 
@@ -423,13 +442,27 @@ struct BucketInfo
 };
 
 
+/// Ranges with fewer primitives than this are always built on the current thread
+#define BVH_PARALLEL_BUILD_THRESHOLD 4096
+
+
+BVHBuildNode* CBVH_PBRT::allocBuildNode()
+{
+    BVHBuildNode *node = static_cast<BVHBuildNode *>( malloc( sizeof( BVHBuildNode ) ) );
+
+    std::lock_guard<std::mutex> lock( m_addressesMutex );
+    m_addresses_pointer_to_mm_free.push_back( node );
+
+    return node;
+}
+
+
 BVHBuildNode *CBVH_PBRT::recursiveBuild ( std::vector<BVHPrimitiveInfo> &primitiveInfo,
                                           int start,
                                           int end,
-                                          int *totalNodes,
-                                          CONST_VECTOR_OBJECT &orderedPrims )
+                                          std::atomic<int> &totalNodes,
+                                          int aParallelDepth )
 {
-    wxASSERT( totalNodes != NULL );
     wxASSERT( start >= 0 );
     wxASSERT( end   >= 0 );
     wxASSERT( start != end );
@@ -437,11 +470,9 @@ BVHBuildNode *CBVH_PBRT::recursiveBuild ( std::vector<BVHPrimitiveInfo> &primiti
     wxASSERT( start <= (int)primitiveInfo.size() );
     wxASSERT( end   <= (int)primitiveInfo.size() );
 
-    (*totalNodes)++;
+    totalNodes++;
 
-    // !TODO: implement an memory Arena
-    BVHBuildNode *node = static_cast<BVHBuildNode *>( malloc( sizeof( BVHBuildNode ) ) );
-    m_addresses_pointer_to_mm_free.push_back( node );
+    BVHBuildNode *node = allocBuildNode();
 
     node->bounds.Reset();
     node->firstPrimOffset = 0;
@@ -459,240 +490,219 @@ BVHBuildNode *CBVH_PBRT::recursiveBuild ( std::vector<BVHPrimitiveInfo> &primiti
 
     int nPrimitives = end - start;
 
+    // Primitives are partitioned in place, so the primitives of a leaf are always the
+    // range [start, end) of the final order of primitiveInfo
     if( nPrimitives == 1 )
     {
-        // Create leaf _BVHBuildNode_
-        int firstPrimOffset = orderedPrims.size();
+        node->InitLeaf( start, nPrimitives, bounds );
 
-        for( int i = start; i < end; ++i )
-        {
-            int primitiveNr = primitiveInfo[i].primitiveNumber;
-            wxASSERT( primitiveNr < (int)m_primitives.size() );
-            orderedPrims.push_back( m_primitives[ primitiveNr ] );
-        }
-
-        node->InitLeaf( firstPrimOffset, nPrimitives, bounds );
+        return node;
     }
-    else
+
+    // Compute bound of primitive centroids, choose split dimension _dim_
+    CBBOX centroidBounds;
+    centroidBounds.Reset();
+
+    for( int i = start; i < end; ++i )
+        centroidBounds.Union( primitiveInfo[i].centroid );
+
+    const int dim = centroidBounds.MaxDimension();
+
+    // Partition primitives into two sets and build children
+    int mid = (start + end) / 2;
+
+    if( fabs( centroidBounds.Max()[dim] -
+              centroidBounds.Min()[dim] ) < (FLT_EPSILON + FLT_EPSILON) )
     {
-        // Compute bound of primitive centroids, choose split dimension _dim_
-        CBBOX centroidBounds;
-        centroidBounds.Reset();
+        node->InitLeaf( start, nPrimitives, bounds );
 
-        for( int i = start; i < end; ++i )
-            centroidBounds.Union( primitiveInfo[i].centroid );
+        return node;
+    }
+
+    // Partition primitives based on _splitMethod_
+    switch( m_splitMethod )
+    {
+    case SPLITMETHOD::MIDDLE:
+    {
+        // Partition primitives through node's midpoint
+        float pmid = centroidBounds.GetCenter( dim );
 
-        const int dim = centroidBounds.MaxDimension();
+        BVHPrimitiveInfo *midPtr = std::partition( &primitiveInfo[start],
+                                                   &primitiveInfo[end - 1] + 1,
+                                                   CompareToMid( dim, pmid ) );
+        mid = midPtr - &primitiveInfo[0];
 
-        // Partition primitives into two sets and build children
-        int mid = (start + end) / 2;
+        wxASSERT( (mid >= start) &&
+                  (mid <= end) );
 
-        if( fabs( centroidBounds.Max()[dim] -
-                  centroidBounds.Min()[dim] ) < (FLT_EPSILON + FLT_EPSILON) )
-        {
-            // Create leaf _BVHBuildNode_
-            const int firstPrimOffset = orderedPrims.size();
+        if( (mid != start) && (mid != end) )
+            break;
+    }
 
-            for( int i = start; i < end; ++i )
-            {
-                int primitiveNr = primitiveInfo[i].primitiveNumber;
+    // Intentionally fall through to SPLITMETHOD::EQUAL_COUNTS since prims
+    // with large overlapping bounding boxes may fail to partition
+    KI_FALLTHROUGH;
 
-                wxASSERT( (primitiveNr >= 0) &&
-                          (primitiveNr < (int)m_primitives.size()) );
+    case SPLITMETHOD::EQUALCOUNTS:
+    {
+        // Partition primitives into equally-sized subsets
+        mid = (start + end) / 2;
 
-                const COBJECT *obj = static_cast<const COBJECT *>( m_primitives[ primitiveNr ] );
+        std::nth_element( &primitiveInfo[start],
+                          &primitiveInfo[mid],
+                          &primitiveInfo[end - 1] + 1,
+                          ComparePoints( dim ) );
 
-                wxASSERT( obj != NULL );
+        break;
+    }
 
-                orderedPrims.push_back( obj );
-            }
+    case SPLITMETHOD::SAH:
+    default:
+    {
+        // Partition primitives using approximate SAH
+        if( nPrimitives <= 2 )
+        {
+            // Partition primitives into equally-sized subsets
+            mid = (start + end) / 2;
 
-            node->InitLeaf( firstPrimOffset, nPrimitives, bounds );
+            std::nth_element( &primitiveInfo[start],
+                              &primitiveInfo[mid],
+                              &primitiveInfo[end - 1] + 1,
+                              ComparePoints( dim ) );
         }
         else
         {
-            // Partition primitives based on _splitMethod_
-            switch( m_splitMethod )
-            {
-            case SPLITMETHOD::MIDDLE:
-            {
-                // Partition primitives through node's midpoint
-                float pmid = centroidBounds.GetCenter( dim );
-
-                BVHPrimitiveInfo *midPtr = std::partition( &primitiveInfo[start],
-                                                           &primitiveInfo[end - 1] + 1,
-                                                           CompareToMid( dim, pmid ) );
-                mid = midPtr - &primitiveInfo[0];
+            // Allocate _BucketInfo_ for SAH partition buckets
+            const int nBuckets = 12;
 
-                wxASSERT( (mid >= start) &&
-                          (mid <= end) );
+            BucketInfo buckets[nBuckets];
 
-                if( (mid != start) && (mid != end) )
-                    break;
+            for( int i = 0; i < nBuckets; ++i )
+            {
+                buckets[i].count = 0;
+                buckets[i].bounds.Reset();
             }
 
-            // Intentionally fall through to SPLITMETHOD::EQUAL_COUNTS since prims
-            // with large overlapping bounding boxes may fail to partition
-            KI_FALLTHROUGH;
-
-            case SPLITMETHOD::EQUALCOUNTS:
+            // Initialize _BucketInfo_ for SAH partition buckets
+            for( int i = start; i < end; ++i )
             {
-                // Partition primitives into equally-sized subsets
-                mid = (start + end) / 2;
+                int b = nBuckets *
+                        centroidBounds.Offset( primitiveInfo[i].centroid )[dim];
+
+                if( b == nBuckets )
+                    b = nBuckets - 1;
 
-                std::nth_element( &primitiveInfo[start],
-                                  &primitiveInfo[mid],
-                                  &primitiveInfo[end - 1] + 1,
-                                  ComparePoints( dim ) );
+                wxASSERT( b >= 0 && b < nBuckets );
 
-                break;
+                buckets[b].count++;
+                buckets[b].bounds.Union( primitiveInfo[i].bounds );
             }
 
-            case SPLITMETHOD::SAH:
-            default:
+            // Compute costs for splitting after each bucket, sweeping the buckets once
+            // from each side
+            float areaBelow[nBuckets - 1];
+            int   countBelow[nBuckets - 1];
+
+            CBBOX b0;
+            b0.Reset();
+            int count0 = 0;
+
+            for( int i = 0; i < (nBuckets - 1); ++i )
             {
-                // Partition primitives using approximate SAH
-                if( nPrimitives <= 2 )
+                if( buckets[i].count )
                 {
-                    // Partition primitives into equally-sized subsets
-                    mid = (start + end) / 2;
-
-                    std::nth_element( &primitiveInfo[start],
-                                      &primitiveInfo[mid],
-                                      &primitiveInfo[end - 1] + 1,
-                                      ComparePoints( dim ) );
+                    count0 += buckets[i].count;
+                    b0.Union( buckets[i].bounds );
                 }
-                else
-                {
-                    // Allocate _BucketInfo_ for SAH partition buckets
-                    const int nBuckets = 12;
-
-                    BucketInfo buckets[nBuckets];
-
-                    for( int i = 0; i < nBuckets; ++i )
-                    {
-                        buckets[i].count = 0;
-                        buckets[i].bounds.Reset();
-                    }
 
-                    // Initialize _BucketInfo_ for SAH partition buckets
-                    for( int i = start; i < end; ++i )
-                    {
-                        int b = nBuckets *
-                                centroidBounds.Offset( primitiveInfo[i].centroid )[dim];
-
-                        if( b == nBuckets )
-                            b = nBuckets - 1;
+                areaBelow[i]  = count0 ? b0.SurfaceArea() : 0.0f;
+                countBelow[i] = count0;
+            }
 
-                        wxASSERT( b >= 0 && b < nBuckets );
+            float cost[nBuckets - 1];
 
-                        buckets[b].count++;
-                        buckets[b].bounds.Union( primitiveInfo[i].bounds );
-                    }
+            CBBOX b1;
+            b1.Reset();
+            int count1 = 0;
 
-                    // Compute costs for splitting after each bucket
-                    float cost[nBuckets - 1];
-
-                    for( int i = 0; i < (nBuckets - 1); ++i )
-                    {
-                        CBBOX b0, b1;
-
-                        b0.Reset();
-                        b1.Reset();
-
-                        int count0 = 0;
-                        int count1 = 0;
-
-                        for( int j = 0; j <= i; ++j )
-                        {
-                            if( buckets[j].count )
-                            {
-                                count0 += buckets[j].count;
-                                b0.Union( buckets[j].bounds );
-                            }
-                        }
-
-                        for( int j = i + 1; j < nBuckets; ++j )
-                        {
-                            if( buckets[j].count )
-                            {
-                                count1 += buckets[j].count;
-                                b1.Union( buckets[j].bounds );
-                            }
-                        }
-
-                        cost[i] = 1.0f +
-                                  ( count0 * b0.SurfaceArea() +
-                                    count1 * b1.SurfaceArea() ) /
-                                  bounds.SurfaceArea();
-                    }
+            for( int i = nBuckets - 2; i >= 0; --i )
+            {
+                if( buckets[i + 1].count )
+                {
+                    count1 += buckets[i + 1].count;
+                    b1.Union( buckets[i + 1].bounds );
+                }
 
-                    // Find bucket to split at that minimizes SAH metric
-                    float minCost = cost[0];
-                    int minCostSplitBucket = 0;
+                cost[i] = 1.0f +
+                          ( countBelow[i] * areaBelow[i] +
+                            count1 * ( count1 ? b1.SurfaceArea() : 0.0f ) ) /
+                          bounds.SurfaceArea();
+            }
 
-                    for( int i = 1; i < (nBuckets - 1); ++i )
-                    {
-                        if( cost[i] < minCost )
-                        {
-                            minCost = cost[i];
-                            minCostSplitBucket = i;
-                        }
-                    }
+            // Find bucket to split at that minimizes SAH metric
+            float minCost = cost[0];
+            int minCostSplitBucket = 0;
 
-                    // Either create leaf or split primitives at selected SAH
-                    // bucket
-                    if( (nPrimitives > m_maxPrimsInNode) ||
-                        (minCost < (float)nPrimitives) )
-                    {
-                        BVHPrimitiveInfo *pmid =
-                            std::partition( &primitiveInfo[start],
-                                            &primitiveInfo[end - 1] + 1,
-                                            CompareToBucket( minCostSplitBucket,
-                                                             nBuckets,
-                                                             dim,
-                                                             centroidBounds ) );
-                        mid = pmid - &primitiveInfo[0];
-
-                        wxASSERT( (mid >= start) &&
-                                  (mid <= end) );
-                    }
-                    else
-                    {
-                        // Create leaf _BVHBuildNode_
-                        const int firstPrimOffset = orderedPrims.size();
+            for( int i = 1; i < (nBuckets - 1); ++i )
+            {
+                if( cost[i] < minCost )
+                {
+                    minCost = cost[i];
+                    minCostSplitBucket = i;
+                }
+            }
 
-                        for( int i = start; i < end; ++i )
-                        {
-                            const int primitiveNr = primitiveInfo[i].primitiveNumber;
+            // Either create leaf or split primitives at selected SAH
+            // bucket
+            if( (nPrimitives > m_maxPrimsInNode) ||
+                (minCost < (float)nPrimitives) )
+            {
+                BVHPrimitiveInfo *pmid =
+                    std::partition( &primitiveInfo[start],
+                                    &primitiveInfo[end - 1] + 1,
+                                    CompareToBucket( minCostSplitBucket,
+                                                     nBuckets,
+                                                     dim,
+                                                     centroidBounds ) );
+                mid = pmid - &primitiveInfo[0];
 
-                            wxASSERT( primitiveNr < (int)m_primitives.size() );
+                wxASSERT( (mid >= start) &&
+                          (mid <= end) );
+            }
+            else
+            {
+                node->InitLeaf( start, nPrimitives, bounds );
 
-                            orderedPrims.push_back( m_primitives[ primitiveNr ] );
-                        }
+                return node;
+            }
+        }
+        break;
+    }
+    }
 
-                        node->InitLeaf( firstPrimOffset, nPrimitives, bounds );
+    // The two halves are independent, so build the first one on another thread while the
+    // tree is still shallow and the ranges are large
+    BVHBuildNode *children[2];
 
-                        return node;
-                    }
-                }
-                break;
-            }
-            }
+    if( aParallelDepth > 0 && nPrimitives >= BVH_PARALLEL_BUILD_THRESHOLD )
+    {
+        std::future<BVHBuildNode *> first = std::async( std::launch::async,
+                [&]()
+                {
+                    return recursiveBuild( primitiveInfo, start, mid, totalNodes,
+                                           aParallelDepth - 1 );
+                } );
 
-            node->InitInterior( dim,
-                                recursiveBuild( primitiveInfo,
-                                                start,
-                                                mid,
-                                                totalNodes,
-                                                orderedPrims ),
-                                recursiveBuild( primitiveInfo,
-                                                mid,
-                                                end,
-                                                totalNodes,
-                                                orderedPrims) );
-        }
+        children[1] = recursiveBuild( primitiveInfo, mid, end, totalNodes, aParallelDepth - 1 );
+        children[0] = first.get();
     }
+    else
+    {
+        children[0] = recursiveBuild( primitiveInfo, start, mid, totalNodes, 0 );
+        children[1] = recursiveBuild( primitiveInfo, mid, end, totalNodes, 0 );
+    }
+
+    node->InitInterior( dim, children[0], children[1] );
 
     return node;
 }
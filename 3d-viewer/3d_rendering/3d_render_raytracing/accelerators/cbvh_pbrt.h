@@ -71,8 +71,10 @@
 #define _CBVH_PBRT_H_
 
 #include "caccelerator.h"
+#include <atomic>
 #include <cstdint>
 #include <list>
+#include <mutex>
 
 // Forward Declarations
 struct BVHBuildNode;
@@ -123,11 +125,20 @@ public:
 
 private:
 
+    /**
+     * Builds the tree for the primitives in the range [start, end) of primitiveInfo, which
+     * is reordered in place so leaves refer to ranges of it.
+     * @param aParallelDepth is the number of tree levels below this node at which the
+     * children are built on separate threads.
+     */
     BVHBuildNode *recursiveBuild( std::vector<BVHPrimitiveInfo> &primitiveInfo,
                                   int start,
                                   int end,
-                                  int *totalNodes,
-                                  CONST_VECTOR_OBJECT &orderedPrims );
+                                  std::atomic<int> &totalNodes,
+                                  int aParallelDepth );
+
+    /// Allocates a build node, safe to call from the build threads
+    BVHBuildNode *allocBuildNode();
 
     BVHBuildNode *HLBVHBuild( const std::vector<BVHPrimitiveInfo> &primitiveInfo,
                               int *totalNodes,
@@ -158,6 +169,7 @@ private:
     LinearBVHNode       *m_nodes;
 
     std::list<void *> m_addresses_pointer_to_mm_free;
+    std::mutex        m_addressesMutex;
 
     // Partition traversal
     unsigned int m_I[RAYPACKET_RAYS_PER_PACKET];
@@ -1025,7 +1025,7 @@ void C3D_RENDER_RAYTRACING::Reload( REPORTER* aStatusReporter,
     }
     m_accelerator = 0;
 
-    m_accelerator = new CBVH_PBRT( m_object_container, 8, SPLITMETHOD::MIDDLE );
+    m_accelerator = new CBVH_PBRT( m_object_container, 8, SPLITMETHOD::SAH );
 
     if( aStatusReporter )
     {
@@ -1267,6 +1267,9 @@ void C3D_RENDER_RAYTRACING::add_3D_vias_and_pads_to_container()
 
 void C3D_RENDER_RAYTRACING::load_3D_models( CCONTAINER &aDstContainer, bool aSkipMaterialInformation )
 {
+    // Fill the cache on several threads; the loop below then only gets the models
+    m_boardAdapter.Prefetch3DModels( true );
+
     // Go for all modules
     for( auto module : m_boardAdapter.GetBoard()->Modules() )
     {
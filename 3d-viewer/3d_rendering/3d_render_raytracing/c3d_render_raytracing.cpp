@@ -72,6 +72,7 @@ C3D_RENDER_RAYTRACING::C3D_RENDER_RAYTRACING( BOARD_ADAPTER& aAdapter, CCAMERA&
     m_rt_render_state = RT_RENDER_STATE_MAX; // Set to an initial invalid state
     m_stats_start_rendering_time = 0;
     m_nrBlocksRenderProgress = 0;
+    m_blockPositionsFocus = SFVEC2UI( 0 );
 }
 
 
@@ -123,6 +124,21 @@ void C3D_RENDER_RAYTRACING::SetCurWindowSize( const wxSize &aSize )
 }
 
 
+static float distance( const SFVEC2UI& a, const SFVEC2UI& b )
+{
+    const float dx = (float) a.x - (float) b.x;
+    const float dy = (float) a.y - (float) b.y;
+    return hypotf( dx, dy );
+}
+
+
+/**
+ * Minimum difference (on any of the 8 bits channels) between two adjacent pixels of the first
+ * pass, that makes their blocks be traced again by the refining pass.
+ */
+#define REFINE_CONTRAST_THRESHOLD 12
+
+
 void C3D_RENDER_RAYTRACING::restart_render_state()
 {
     m_stats_start_rendering_time = GetRunningMicroSecs();
@@ -138,6 +154,94 @@ void C3D_RENDER_RAYTRACING::restart_render_state()
     std::fill( m_blockPositionsWasProcessed.begin(),
                m_blockPositionsWasProcessed.end(),
                0 );
+
+    m_blockNeedsRefinement.assign( m_blockPositions.size(), 0 );
+
+    // Render first what the user is looking at: the blocks under the mouse cursor when it is
+    // over the image, otherwise the ones in the center
+    SFVEC2UI focus( m_realBufferSize.x / 2, m_realBufferSize.y / 2 );
+
+    const wxPoint& mousePos = m_camera.GetCurMousePosition();
+    const int      mouseX = mousePos.x - (int) m_xoffset;
+    const int      mouseY = ( m_windowSize.y - 1 - mousePos.y ) - (int) m_yoffset; // Y up
+
+    if( ( mouseX >= 0 ) && ( mouseX < (int) m_realBufferSize.x ) &&
+        ( mouseY >= 0 ) && ( mouseY < (int) m_realBufferSize.y ) )
+        focus = SFVEC2UI( mouseX, mouseY );
+
+    if( focus != m_blockPositionsFocus )
+    {
+        m_blockPositionsFocus = focus;
+
+        const SFVEC2UI halfBlock( RAYPACKET_DIM / 2, RAYPACKET_DIM / 2 );
+
+        std::sort( m_blockPositions.begin(), m_blockPositions.end(),
+                [&]( const SFVEC2UI& a, const SFVEC2UI& b ) {
+                    return distance( a + halfBlock, focus ) < distance( b + halfBlock, focus );
+                } );
+    }
+}
+
+
+bool C3D_RENDER_RAYTRACING::rt_refinement_needed() const
+{
+    // The first pass is final if it has nothing to spare: no anti-aliasing and hard shadows
+    if( m_boardAdapter.GetFlag( FL_RENDER_RAYTRACING_ANTI_ALIASING ) )
+        return true;
+
+    return m_boardAdapter.GetFlag( FL_RENDER_RAYTRACING_SHADOWS ) &&
+           ( m_boardAdapter.m_raytrace_nrsamples_shadows > 1 );
+}
+
+
+void C3D_RENDER_RAYTRACING::rt_prepare_refinement( const GLubyte* ptrPBO )
+{
+    // Use the contrast between adjacent pixels of the first pass as an estimation of the
+    // variance: object edges, textures and shadow boundaries need the extra samples, flat
+    // areas (most of a board) and the background do not.
+    // Pixels are compared across the block borders too, so edges lying on a border are found.
+    const unsigned int blocksX = m_realBufferSize.x / RAYPACKET_DIM;
+
+    auto contrast = []( const GLubyte* a, const GLubyte* b )
+    {
+        return std::max( { std::abs( a[0] - b[0] ),
+                           std::abs( a[1] - b[1] ),
+                           std::abs( a[2] - b[2] ) } );
+    };
+
+    auto flag = [&]( unsigned int x, unsigned int y )
+    {
+        m_blockNeedsRefinement[x / RAYPACKET_DIM + ( y / RAYPACKET_DIM ) * blocksX] = 1;
+    };
+
+    for( unsigned int y = 0; y < m_realBufferSize.y; ++y )
+    {
+        const GLubyte* row = &ptrPBO[y * m_realBufferSize.x * 4];
+
+        for( unsigned int x = 0; x < m_realBufferSize.x; ++x )
+        {
+            const GLubyte* p = &row[x * 4];
+
+            if( ( x + 1 < m_realBufferSize.x ) && contrast( p, p + 4 ) > REFINE_CONTRAST_THRESHOLD )
+            {
+                flag( x, y );
+                flag( x + 1, y );
+            }
+
+            if( ( y + 1 < m_realBufferSize.y )
+                    && contrast( p, p + m_realBufferSize.x * 4 ) > REFINE_CONTRAST_THRESHOLD )
+            {
+                flag( x, y );
+                flag( x, y + 1 );
+            }
+        }
+    }
+
+    m_nrBlocksRenderProgress = 0;
+
+    std::fill( m_blockPositionsWasProcessed.begin(),
+               m_blockPositionsWasProcessed.end(),
+               0 );
 }
 
 
@@ -166,6 +270,7 @@ bool C3D_RENDER_RAYTRACING::Redraw(
         // revert to preview mode the first time the Redraw is called
         m_oldWindowsSize = m_windowSize;
         initialize_block_positions();
+        opengl_init_pbo();
     }
 
     std::unique_ptr<BUSY_INDICATOR> busy = CreateBusyIndicator();
@@ -192,6 +297,7 @@ bool C3D_RENDER_RAYTRACING::Redraw(
         requestRedraw = true;
 
         initialize_block_positions();
+        opengl_init_pbo();
     }
 
 
@@ -299,6 +405,39 @@ bool C3D_RENDER_RAYTRACING::Redraw(
 }
 
 
+SFVEC2UI C3D_RENDER_RAYTRACING::RenderToBuffer( const wxSize& aSize,
+                                                std::vector<unsigned char>& aBuffer,
+                                                REPORTER* aStatusReporter,
+                                                REPORTER* aWarningReporter )
+{
+    m_camera.SetCurWindowSize( aSize );
+
+    // Same as SetCurWindowSize() but without the GL viewport and PBO
+    if( m_windowSize != aSize || m_blockPositions.empty() )
+    {
+        m_windowSize = aSize;
+        m_oldWindowsSize = aSize;
+        initialize_block_positions();
+    }
+
+    if( m_reloadRequested )
+        Reload( aStatusReporter, aWarningReporter, false );
+
+    // Start a new frame, and run all the render states to the end in one go
+    m_camera.ParametersChanged();
+    m_rt_render_state = RT_RENDER_STATE_MAX;
+
+    aBuffer.assign( m_realBufferSize.x * m_realBufferSize.y * 4, 0 );
+
+    do
+    {
+        render( aBuffer.data(), aStatusReporter );
+    } while( m_rt_render_state != RT_RENDER_STATE_FINISH );
+
+    return m_realBufferSize;
+}
+
+
 void C3D_RENDER_RAYTRACING::render( GLubyte* ptrPBO, REPORTER* aStatusReporter )
 {
     if( (m_rt_render_state == RT_RENDER_STATE_FINISH) ||
@@ -332,6 +471,7 @@ void C3D_RENDER_RAYTRACING::render( GLubyte* ptrPBO, REPORTER* aStatusReporter )
     switch( m_rt_render_state )
     {
     case RT_RENDER_STATE_TRACING:
+    case RT_RENDER_STATE_REFINING:
         rt_render_tracing( ptrPBO, aStatusReporter );
         break;
 
@@ -366,6 +506,9 @@ void C3D_RENDER_RAYTRACING::rt_render_tracing( GLubyte* ptrPBO ,
 {
     m_isPreview = false;
 
+    const bool isRefining = ( m_rt_render_state == RT_RENDER_STATE_REFINING );
+    const unsigned int blocksX = m_realBufferSize.x / RAYPACKET_DIM;
+
     auto startTime = std::chrono::steady_clock::now();
     bool breakLoop = false;
 
@@ -386,7 +529,14 @@ void C3D_RENDER_RAYTRACING::rt_render_tracing( GLubyte* ptrPBO ,
             {
                 if( !m_blockPositionsWasProcessed[iBlock] )
                 {
-                    rt_render_trace_block( ptrPBO, iBlock );
+                    const SFVEC2UI& blockPos = m_blockPositions[iBlock];
+
+                    // The refining pass only traces again the blocks that need it
+                    if( !isRefining
+                            || m_blockNeedsRefinement[blockPos.x / RAYPACKET_DIM
+                                                      + ( blockPos.y / RAYPACKET_DIM ) * blocksX] )
+                        rt_render_trace_block( ptrPBO, iBlock );
+
                     numBlocksRendered++;
                     m_blockPositionsWasProcessed[iBlock] = 1;
 
@@ -410,15 +560,21 @@ void C3D_RENDER_RAYTRACING::rt_render_tracing( GLubyte* ptrPBO ,
     m_nrBlocksRenderProgress += numBlocksRendered;
 
     if( aStatusReporter )
-        aStatusReporter->Report( wxString::Format( _( "Rendering: %.0f %%" ),
-                                                       (float)(m_nrBlocksRenderProgress * 100) /
-                                                       (float)m_blockPositions.size() ) );
+        aStatusReporter->Report( wxString::Format( isRefining ? _( "Refining: %.0f %%" )
+                                                              : _( "Rendering: %.0f %%" ),
+                                                   (float)(m_nrBlocksRenderProgress * 100) /
+                                                   (float)m_blockPositions.size() ) );
 
-    // Check if it finish the rendering and if should continue to a post processing
-    // or mark it as finished
+    // Check if it finish the rendering and if should continue to a refining pass, to
+    // a post processing or mark it as finished
     if( m_nrBlocksRenderProgress >= m_blockPositions.size() )
     {
-        if( m_boardAdapter.GetFlag( FL_RENDER_RAYTRACING_POST_PROCESSING ) )
+        if( !isRefining && rt_refinement_needed() )
+        {
+            rt_prepare_refinement( ptrPBO );
+            m_rt_render_state = RT_RENDER_STATE_REFINING;
+        }
+        else if( m_boardAdapter.GetFlag( FL_RENDER_RAYTRACING_POST_PROCESSING ) )
             m_rt_render_state = RT_RENDER_STATE_POST_PROCESS_SHADE;
         else
             m_rt_render_state = RT_RENDER_STATE_FINISH;
@@ -746,7 +902,10 @@ void C3D_RENDER_RAYTRACING::rt_render_trace_block( GLubyte *ptrPBO ,
                       m_boardAdapter.GetFlag( FL_RENDER_RAYTRACING_SHADOWS ),
                       hitColor_X0Y0 );
 
-    if( m_boardAdapter.GetFlag( FL_RENDER_RAYTRACING_ANTI_ALIASING ) )
+    // The first pass only takes one sample per pixel, the blocks that need anti-aliasing are
+    // traced again by the refining pass
+    if( m_boardAdapter.GetFlag( FL_RENDER_RAYTRACING_ANTI_ALIASING ) &&
+        ( m_rt_render_state == RT_RENDER_STATE_REFINING ) )
     {
         SFVEC3F hitColor_AA_X1Y1[RAYPACKET_RAYS_PER_PACKET];
 
@@ -1737,7 +1896,10 @@ SFVEC3F C3D_RENDER_RAYTRACING::shadeHit( const SFVEC3F &aBgColor,
                 else
                 {
 
-                    const unsigned int shadow_number_of_samples = m_boardAdapter.m_raytrace_nrsamples_shadows;
+                    // Soft shadows are left to the refining pass
+                    const unsigned int shadow_number_of_samples =
+                            ( m_rt_render_state == RT_RENDER_STATE_TRACING ) ?
+                            1 : m_boardAdapter.m_raytrace_nrsamples_shadows;
                     const float shadow_inc_factor = 1.0f / (float)(shadow_number_of_samples);
 
                     for( unsigned int i = 0; i < shadow_number_of_samples; ++i )
@@ -1998,13 +2160,6 @@ bool C3D_RENDER_RAYTRACING::initializeOpenGL()
 }
 
 
-static float distance( const SFVEC2UI& a, const SFVEC2UI& b )
-{
-    const float dx = (float) a.x - (float) b.x;
-    const float dy = (float) a.y - (float) b.y;
-    return hypotf( dx, dy );
-}
-
 void C3D_RENDER_RAYTRACING::initialize_block_positions()
 {
 
@@ -2067,6 +2222,8 @@ void C3D_RENDER_RAYTRACING::initialize_block_positions()
             m_blockPositions.emplace_back( x * RAYPACKET_DIM, y * RAYPACKET_DIM );
 
     const SFVEC2UI center( m_realBufferSize.x / 2, m_realBufferSize.y / 2 );
+    m_blockPositionsFocus = center;
+
     std::sort( m_blockPositions.begin(), m_blockPositions.end(),
             [&]( const SFVEC2UI& a, const SFVEC2UI& b ) {
                 // Sort order: inside out.
@@ -2076,8 +2233,6 @@ void C3D_RENDER_RAYTRACING::initialize_block_positions()
     // Create m_shader buffer
     delete[] m_shaderBuffer;
     m_shaderBuffer = new SFVEC3F[m_realBufferSize.x * m_realBufferSize.y];
-
-    opengl_init_pbo();
 }
 
 BOARD_ITEM *C3D_RENDER_RAYTRACING::IntersectBoardItem( const RAY &aRay )
@@ -40,6 +40,7 @@
 #include <plugins/3dapi/c3dmodel.h>
 
 #include <map>
+#include <vector>
 
 /// Vector of materials
 typedef std::vector< CBLINN_PHONG_MATERIAL > MODEL_MATERIALS;
@@ -49,7 +50,8 @@ typedef std::map< const S3DMODEL * , MODEL_MATERIALS > MAP_MODEL_MATERIALS;
 
 typedef enum
 {
-    RT_RENDER_STATE_TRACING = 0,
+    RT_RENDER_STATE_TRACING = 0,        ///< First pass, one sample per pixel and hard shadows
+    RT_RENDER_STATE_REFINING,           ///< Traces again the blocks with visible variance
     RT_RENDER_STATE_POST_PROCESS_SHADE,
     RT_RENDER_STATE_POST_PROCESS_BLUR_AND_FINISH,
     RT_RENDER_STATE_FINISH,
@@ -73,6 +75,21 @@ public:
 
     BOARD_ITEM *IntersectBoardItem( const RAY &aRay );
 
+    /**
+     * Render a complete frame into a RGBA buffer, without using OpenGL.
+     *
+     * This is the entry point for snapshots made with no window (batch rendering); the
+     * interactive path keeps rendering progressively into the PBO from #Redraw.
+     * The board is (re)loaded first if a reload is pending.
+     *
+     * @param aSize is the size of the view, it is also applied to the camera.
+     * @param aBuffer receives the pixels, 4 bytes (RGBA) each and bottom row first.
+     * @return the size of the rendered image. It is slightly smaller than aSize because the
+     *         image is made of whole ray packet blocks, centered in the view.
+     */
+    SFVEC2UI RenderToBuffer( const wxSize& aSize, std::vector<unsigned char>& aBuffer,
+                             REPORTER* aStatusReporter, REPORTER* aWarningReporter );
+
 private:
     bool initializeOpenGL();
     void initializeNewWindowSize();
@@ -85,6 +102,8 @@ private:
                                    float aLayerZOffset );
 
     void restart_render_state();
+    bool rt_refinement_needed() const;
+    void rt_prepare_refinement( const GLubyte* ptrPBO );
     void rt_render_tracing( GLubyte* ptrPBO, REPORTER* aStatusReporter );
     void rt_render_post_process_shade( GLubyte* ptrPBO, REPORTER* aStatusReporter );
     void rt_render_post_process_blur_finish( GLubyte* ptrPBO, REPORTER* aStatusReporter );
@@ -174,9 +193,16 @@ private:
     /// this encodes the Morton code positions
     std::vector< SFVEC2UI > m_blockPositions;
 
-    /// this flags if a position was already processed (cleared each new render)
+    /// this flags if a position was already processed (cleared each new render pass)
     std::vector< int > m_blockPositionsWasProcessed;
 
+    /// this flags the blocks that the refining pass must trace again. It is indexed by the
+    /// block grid position, (x + y * blocks_x), not by the order in m_blockPositions
+    std::vector< int > m_blockNeedsRefinement;
+
+    /// the point the blocks in m_blockPositions are sorted around (closest first)
+    SFVEC2UI m_blockPositionsFocus;
+
     /// this encodes the Morton code positions (on fast preview mode)
     std::vector< SFVEC2UI > m_blockPositionsFast;
 
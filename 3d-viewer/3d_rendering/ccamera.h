@@ -160,6 +160,8 @@ class CCAMERA
      */
     void SetCurMousePosition( const wxPoint &aPosition );
 
+    const wxPoint& GetCurMousePosition() const { return m_lastPosition; }
+
     void ToggleProjection();
     PROJECTION_TYPE GetProjection() { return m_projectionType; }
 
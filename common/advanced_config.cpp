@@ -142,6 +142,11 @@ static const wxChar DebugZoneFiller[] = wxT( "DebugZoneFiller" );
 
 static const wxChar SkipBoundingBoxFpLoad[] = wxT( "SkipBoundingBoxFpLoad" );
 
+/**
+ * When true, the Cairo canvas rasterizes cached layers in horizontal tiles on several threads.
+ */
+static const wxChar CairoTiledRendering[] = wxT( "CairoTiledRendering" );
+
 } // namespace KEYS
 
 
@@ -241,6 +246,8 @@ ADVANCED_CFG::ADVANCED_CFG()
 
     m_SkipBoundingBoxOnFpLoad   = false;
 
+    m_CairoTiledRendering       = false;
+
     loadFromConfigFile();
 }
 
@@ -321,6 +328,9 @@ void ADVANCED_CFG::loadSettings( wxConfigBase& aCfg )
     configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::SkipBoundingBoxFpLoad, 
                                                 &m_SkipBoundingBoxOnFpLoad, false ) );
 
+    configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::CairoTiledRendering,
+                                                &m_CairoTiledRendering, false ) );
+
     wxConfigLoadSetups( &aCfg, configParams );
 
     for( PARAM_CFG* param : configParams )
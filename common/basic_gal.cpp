@@ -39,10 +39,12 @@
 
 using namespace KIGFX;
 
-KIGFX::GAL_DISPLAY_OPTIONS basic_displayOptions;
+// Each thread gets its own basic GAL (and display options it subscribes to), so texts can
+// be converted concurrently without sharing the GAL state or the stroke font caches
+thread_local KIGFX::GAL_DISPLAY_OPTIONS basic_displayOptions;
 
 // the basic GAL doesn't get an external display option object
-BASIC_GAL basic_gal( basic_displayOptions );
+thread_local BASIC_GAL basic_gal( basic_displayOptions );
 
 const VECTOR2D BASIC_GAL::transform( const VECTOR2D& aPoint ) const
 {
@@ -65,39 +67,67 @@ void BASIC_GAL::DrawPolyline( const std::deque<VECTOR2D>& aPointList )
         polyline_corners.emplace_back( corner.x, corner.y );
     }
 
+    doDrawPolyline( polyline_corners );
+}
+
+
+void BASIC_GAL::DrawPolylines( const std::vector<std::vector<VECTOR2D>>& aPointLists )
+{
+    std::vector <wxPoint> polyline_corners;
+
+    for( const std::vector<VECTOR2D>& pointList : aPointLists )
+    {
+        if( pointList.empty() )
+            continue;
+
+        polyline_corners.clear();
+
+        for( const VECTOR2D& pt : pointList )
+        {
+            VECTOR2D corner = transform( pt );
+            polyline_corners.emplace_back( corner.x, corner.y );
+        }
+
+        doDrawPolyline( polyline_corners );
+    }
+}
+
+
+void BASIC_GAL::doDrawPolyline( const std::vector<wxPoint>& aCorners )
+{
     if( m_DC )
     {
         if( isFillEnabled )
         {
-            GRPoly( m_isClipped ? &m_clipBox : NULL, m_DC, polyline_corners.size(),
-                    &polyline_corners[0], 0, GetLineWidth(), m_Color, m_Color );
+            GRPoly( m_isClipped ? &m_clipBox : NULL, m_DC, aCorners.size(),
+                    &aCorners[0], 0, GetLineWidth(), m_Color, m_Color );
         }
         else
         {
-            for( unsigned ii = 1; ii < polyline_corners.size(); ++ii )
+            for( unsigned ii = 1; ii < aCorners.size(); ++ii )
             {
-                GRCSegm( m_isClipped ? &m_clipBox : NULL, m_DC, polyline_corners[ii-1],
-                         polyline_corners[ii], GetLineWidth(), m_Color );
+                GRCSegm( m_isClipped ? &m_clipBox : NULL, m_DC, aCorners[ii-1],
+                         aCorners[ii], GetLineWidth(), m_Color );
             }
         }
     }
     else if( m_plotter )
     {
-        m_plotter->MoveTo( polyline_corners[0] );
+        m_plotter->MoveTo( aCorners[0] );
 
-        for( unsigned ii = 1; ii < polyline_corners.size(); ii++ )
+        for( unsigned ii = 1; ii < aCorners.size(); ii++ )
         {
-            m_plotter->LineTo( polyline_corners[ii] );
+            m_plotter->LineTo( aCorners[ii] );
         }
 
         m_plotter->PenFinish();
     }
     else if( m_callback )
     {
-        for( unsigned ii = 1; ii < polyline_corners.size(); ii++ )
+        for( unsigned ii = 1; ii < aCorners.size(); ii++ )
         {
-            m_callback( polyline_corners[ii-1].x, polyline_corners[ii-1].y,
-                        polyline_corners[ii].x, polyline_corners[ii].y, m_callbackData );
+            m_callback( aCorners[ii-1].x, aCorners[ii-1].y,
+                        aCorners[ii].x, aCorners[ii].y, m_callbackData );
         }
     }
 }
@@ -42,6 +42,10 @@
 // Create only once, as seeding is *very* expensive
 static boost::uuids::random_generator randomGenerator;
 
+// The generator is not thread safe, and items are also created by file readers running
+// on worker threads
+static std::mutex randomGeneratorMutex;
+
 // These don't have the same performance penalty, but might as well be consistent
 static boost::uuids::string_generator stringGenerator;
 static boost::uuids::nil_generator nilGenerator;
@@ -50,6 +54,13 @@ static boost::uuids::nil_generator nilGenerator;
 KIID niluuid( 0 );
 
 
+static boost::uuids::uuid newRandomUuid()
+{
+    std::lock_guard<std::mutex> lock( randomGeneratorMutex );
+    return randomGenerator();
+}
+
+
 // For static initialization
 KIID& NilUuid()
 {
@@ -59,7 +70,7 @@ KIID& NilUuid()
 
 
 KIID::KIID() :
-        m_uuid( randomGenerator() ),
+        m_uuid( newRandomUuid() ),
         m_cached_timestamp( 0 )
 {
 }
@@ -103,7 +114,7 @@ KIID::KIID( const wxString& aString ) :
         {
             // Failed to parse string representation; best we can do is assign a new
             // random one.
-            m_uuid = randomGenerator();
+            m_uuid = newRandomUuid();
         }
     }
 }
@@ -177,7 +188,7 @@ void KIID::ConvertTimestampToUuid()
         return;
 
     m_cached_timestamp = 0;
-    m_uuid = randomGenerator();
+    m_uuid = newRandomUuid();
 }
 
 
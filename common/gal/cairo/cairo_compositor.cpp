@@ -136,6 +136,40 @@ void CAIRO_COMPOSITOR::SetBuffer( unsigned int aBufferHandle )
     cairo_set_matrix( *m_currentContext, &m_matrix );
 }
 
+cairo_t* CAIRO_COMPOSITOR::CreateTileContext( unsigned int aTop, unsigned int aHeight )
+{
+    wxASSERT_MSG( aTop + aHeight <= m_height, wxT( "Tile exceeds the buffer" ) );
+
+    unsigned char* rows = (unsigned char*) m_buffers[m_current].bitmap + aTop * m_stride;
+
+    cairo_surface_t* surface = cairo_image_surface_create_for_data( rows, CAIRO_FORMAT_ARGB32,
+                                                                    m_width, aHeight, m_stride );
+    cairo_t* context = cairo_create( surface );
+
+    // The context keeps its own reference to the surface
+    cairo_surface_destroy( surface );
+
+    cairo_set_antialias( context, m_currentAntialiasingMode );
+
+    // Use the current transformation, moved up by the tile offset
+    cairo_matrix_t matrix;
+    cairo_matrix_t offset;
+    cairo_get_matrix( *m_currentContext, &matrix );
+    cairo_matrix_init_translate( &offset, 0.0, -(double) aTop );
+    cairo_matrix_multiply( &matrix, &matrix, &offset );
+    cairo_set_matrix( context, &matrix );
+
+    // Copy the remaining drawing state used by cached groups
+    cairo_set_line_width( context, cairo_get_line_width( *m_currentContext ) );
+    cairo_set_line_cap( context, cairo_get_line_cap( *m_currentContext ) );
+    cairo_set_line_join( context, cairo_get_line_join( *m_currentContext ) );
+    cairo_set_fill_rule( context, cairo_get_fill_rule( *m_currentContext ) );
+    cairo_set_operator( context, cairo_get_operator( *m_currentContext ) );
+
+    return context;
+}
+
+
 void CAIRO_COMPOSITOR::Begin()
 {
 }
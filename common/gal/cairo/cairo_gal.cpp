@@ -35,9 +35,13 @@
 #include <geometry/shape_poly_set.h>
 #include <math/util.h>      // for KiROUND
 #include <bitmap_base.h>
+#include <advanced_config.h>
 
 #include <algorithm>
+#include <atomic>
+#include <future>
 #include <limits>
+#include <thread>
 
 #include <pixman.h>
 
@@ -209,6 +213,8 @@ void CAIRO_GAL_BASE::DrawLine( const VECTOR2D& aStartPoint, const VECTOR2D& aEnd
 
 void CAIRO_GAL_BASE::syncLineWidth( bool aForceWidth, double aWidth )
 {
+    drawPendingGroups();
+
     auto w =  floor( xform( aForceWidth ? aWidth : lineWidth ) + 0.5 );
 
     if (w <= 1.0)
@@ -456,6 +462,7 @@ void CAIRO_GAL_BASE::DrawCurve( const VECTOR2D& aStartPoint, const VECTOR2D& aCo
 
 void CAIRO_GAL_BASE::DrawBitmap( const BITMAP_BASE& aBitmap )
 {
+    drawPendingGroups();
     cairo_save( currentContext );
 
     // We have to calculate the pixel size in users units to draw the image.
@@ -536,6 +543,7 @@ void CAIRO_GAL_BASE::Flush()
 
 void CAIRO_GAL_BASE::ClearScreen()
 {
+    drawPendingGroups();
     cairo_set_source_rgb( currentContext, m_clearColor.r, m_clearColor.g, m_clearColor.b );
     cairo_rectangle( currentContext, 0.0, 0.0, screenSize.x, screenSize.y );
     cairo_fill( currentContext );
@@ -775,56 +783,76 @@ void CAIRO_GAL_BASE::EndGroup()
 
 
 void CAIRO_GAL_BASE::DrawGroup( int aGroupNumber )
+{
+    storePath();
+
+    GROUP_STATE state = { isFillEnabled, isStrokeEnabled, fillColor, strokeColor };
+
+    replayGroup( currentContext, state, aGroupNumber );
+
+    isFillEnabled   = state.isFill;
+    isStrokeEnabled = state.isStroke;
+    fillColor       = state.fillColor;
+    strokeColor     = state.strokeColor;
+}
+
+
+void CAIRO_GAL_BASE::replayGroup( cairo_t* aContext, GROUP_STATE& aState,
+                                  int aGroupNumber ) const
 {
     // This method implements a small Virtual Machine - all stored commands
     // are executed; nested calling is also possible
 
-    storePath();
+    auto group = groups.find( aGroupNumber );
 
-    for( GROUP::iterator it = groups[aGroupNumber].begin();
-         it != groups[aGroupNumber].end(); ++it )
+    if( group == groups.end() )
+        return;
+
+    for( GROUP::const_iterator it = group->second.begin(); it != group->second.end(); ++it )
     {
         switch( it->command )
         {
         case CMD_SET_FILL:
-            isFillEnabled = it->argument.boolArg;
+            aState.isFill = it->argument.boolArg;
             break;
 
         case CMD_SET_STROKE:
-            isStrokeEnabled = it->argument.boolArg;
+            aState.isStroke = it->argument.boolArg;
             break;
 
         case CMD_SET_FILLCOLOR:
-            fillColor = COLOR4D( it->argument.dblArg[0], it->argument.dblArg[1], it->argument.dblArg[2],
-                                 it->argument.dblArg[3] );
+            aState.fillColor = COLOR4D( it->argument.dblArg[0], it->argument.dblArg[1],
+                                        it->argument.dblArg[2], it->argument.dblArg[3] );
             break;
 
         case CMD_SET_STROKECOLOR:
-            strokeColor = COLOR4D( it->argument.dblArg[0], it->argument.dblArg[1], it->argument.dblArg[2],
-                                   it->argument.dblArg[3] );
+            aState.strokeColor = COLOR4D( it->argument.dblArg[0], it->argument.dblArg[1],
+                                          it->argument.dblArg[2], it->argument.dblArg[3] );
             break;
 
         case CMD_SET_LINE_WIDTH:
             {
                 // Make lines appear at least 1 pixel wide, no matter of zoom
                 double x = 1.0, y = 1.0;
-                cairo_device_to_user_distance( currentContext, &x, &y );
+                cairo_device_to_user_distance( aContext, &x, &y );
                 double minWidth = std::min( fabs( x ), fabs( y ) );
-                cairo_set_line_width( currentContext, std::max( it->argument.dblArg[0], minWidth ) );
+                cairo_set_line_width( aContext, std::max( it->argument.dblArg[0], minWidth ) );
             }
             break;
 
 
         case CMD_STROKE_PATH:
-            cairo_set_source_rgba( currentContext, strokeColor.r, strokeColor.g, strokeColor.b, strokeColor.a );
-            cairo_append_path( currentContext, it->cairoPath );
-            cairo_stroke( currentContext );
+            cairo_set_source_rgba( aContext, aState.strokeColor.r, aState.strokeColor.g,
+                                   aState.strokeColor.b, aState.strokeColor.a );
+            cairo_append_path( aContext, it->cairoPath );
+            cairo_stroke( aContext );
             break;
 
         case CMD_FILL_PATH:
-            cairo_set_source_rgba( currentContext, fillColor.r, fillColor.g, fillColor.b, strokeColor.a );
-            cairo_append_path( currentContext, it->cairoPath );
-            cairo_fill( currentContext );
+            cairo_set_source_rgba( aContext, aState.fillColor.r, aState.fillColor.g,
+                                   aState.fillColor.b, aState.strokeColor.a );
+            cairo_append_path( aContext, it->cairoPath );
+            cairo_fill( aContext );
             break;
 
             /*
@@ -832,32 +860,130 @@ void CAIRO_GAL_BASE::DrawGroup( int aGroupNumber )
             cairo_matrix_t matrix;
             cairo_matrix_init( &matrix, it->argument.dblArg[0], it->argument.dblArg[1], it->argument.dblArg[2],
                                it->argument.dblArg[3], it->argument.dblArg[4], it->argument.dblArg[5] );
-            cairo_transform( currentContext, &matrix );
+            cairo_transform( aContext, &matrix );
             break;
             */
 
         case CMD_ROTATE:
-            cairo_rotate( currentContext, it->argument.dblArg[0] );
+            cairo_rotate( aContext, it->argument.dblArg[0] );
             break;
 
         case CMD_TRANSLATE:
-            cairo_translate( currentContext, it->argument.dblArg[0], it->argument.dblArg[1] );
+            cairo_translate( aContext, it->argument.dblArg[0], it->argument.dblArg[1] );
             break;
 
         case CMD_SCALE:
-            cairo_scale( currentContext, it->argument.dblArg[0], it->argument.dblArg[1] );
+            cairo_scale( aContext, it->argument.dblArg[0], it->argument.dblArg[1] );
             break;
 
         case CMD_SAVE:
-            cairo_save( currentContext );
+            cairo_save( aContext );
             break;
 
         case CMD_RESTORE:
-            cairo_restore( currentContext );
+            cairo_restore( aContext );
             break;
 
         case CMD_CALL_GROUP:
-            DrawGroup( it->argument.intArg );
+            replayGroup( aContext, aState, it->argument.intArg );
+            break;
+        }
+    }
+}
+
+
+void CAIRO_GAL_BASE::groupExtents( cairo_t* aContext, GROUP_STATE& aState, int aGroupNumber,
+                                   double& aTop, double& aBottom ) const
+{
+    auto group = groups.find( aGroupNumber );
+
+    if( group == groups.end() )
+        return;
+
+    auto addExtents =
+            [&]( double x1, double y1, double x2, double y2 )
+            {
+                double xs[4] = { x1, x2, x1, x2 };
+                double ys[4] = { y1, y1, y2, y2 };
+
+                for( int i = 0; i < 4; ++i )
+                {
+                    cairo_user_to_device( aContext, &xs[i], &ys[i] );
+                    aTop    = std::min( aTop, ys[i] );
+                    aBottom = std::max( aBottom, ys[i] );
+                }
+            };
+
+    for( GROUP::const_iterator it = group->second.begin(); it != group->second.end(); ++it )
+    {
+        double x1, y1, x2, y2;
+
+        switch( it->command )
+        {
+        case CMD_SET_FILL:
+            aState.isFill = it->argument.boolArg;
+            break;
+
+        case CMD_SET_STROKE:
+            aState.isStroke = it->argument.boolArg;
+            break;
+
+        case CMD_SET_FILLCOLOR:
+            aState.fillColor = COLOR4D( it->argument.dblArg[0], it->argument.dblArg[1],
+                                        it->argument.dblArg[2], it->argument.dblArg[3] );
+            break;
+
+        case CMD_SET_STROKECOLOR:
+            aState.strokeColor = COLOR4D( it->argument.dblArg[0], it->argument.dblArg[1],
+                                          it->argument.dblArg[2], it->argument.dblArg[3] );
+            break;
+
+        case CMD_SET_LINE_WIDTH:
+            {
+                // Same minimal width as in replayGroup()
+                double x = 1.0, y = 1.0;
+                cairo_device_to_user_distance( aContext, &x, &y );
+                double minWidth = std::min( fabs( x ), fabs( y ) );
+                cairo_set_line_width( aContext, std::max( it->argument.dblArg[0], minWidth ) );
+            }
+            break;
+
+        case CMD_STROKE_PATH:
+            cairo_append_path( aContext, it->cairoPath );
+            cairo_stroke_extents( aContext, &x1, &y1, &x2, &y2 );
+            cairo_new_path( aContext );
+            addExtents( x1, y1, x2, y2 );
+            break;
+
+        case CMD_FILL_PATH:
+            cairo_append_path( aContext, it->cairoPath );
+            cairo_fill_extents( aContext, &x1, &y1, &x2, &y2 );
+            cairo_new_path( aContext );
+            addExtents( x1, y1, x2, y2 );
+            break;
+
+        case CMD_ROTATE:
+            cairo_rotate( aContext, it->argument.dblArg[0] );
+            break;
+
+        case CMD_TRANSLATE:
+            cairo_translate( aContext, it->argument.dblArg[0], it->argument.dblArg[1] );
+            break;
+
+        case CMD_SCALE:
+            cairo_scale( aContext, it->argument.dblArg[0], it->argument.dblArg[1] );
+            break;
+
+        case CMD_SAVE:
+            cairo_save( aContext );
+            break;
+
+        case CMD_RESTORE:
+            cairo_restore( aContext );
+            break;
+
+        case CMD_CALL_GROUP:
+            groupExtents( aContext, aState, it->argument.intArg, aTop, aBottom );
             break;
         }
     }
@@ -1017,6 +1143,8 @@ void CAIRO_GAL_BASE::drawGridCross( const VECTOR2D& aPoint )
 
 void CAIRO_GAL_BASE::drawGridPoint( const VECTOR2D& aPoint, double aSize )
 {
+    drawPendingGroups();
+
     auto p = roundp( xform( aPoint ) );
     auto s = std::max( 1.0, xform( aSize / 2.0 ) );
 
@@ -1214,6 +1342,8 @@ CAIRO_GAL::CAIRO_GAL( GAL_DISPLAY_OPTIONS& aDisplayOptions,
     mainBuffer          = 0;
     overlayBuffer       = 0;
     validCompositor     = false;
+    currentTarget       = TARGET_NONCACHED;
+    tiledRendering      = ADVANCED_CFG::GetCfg().m_CairoTiledRendering;
     SetTarget( TARGET_NONCACHED );
 
     parentWindow  = aParent;
@@ -1271,6 +1401,8 @@ void CAIRO_GAL::beginDrawing()
 
 void CAIRO_GAL::endDrawing()
 {
+    drawPendingGroups();
+
     CAIRO_GAL_BASE::endDrawing();
 
     // Merge buffers on the screen
@@ -1321,6 +1453,8 @@ void CAIRO_GAL::ResizeScreen( int aWidth, int aHeight )
 {
     CAIRO_GAL_BASE::ResizeScreen( aWidth, aHeight );
 
+    pendingGroups.clear();
+
     // Recreate the bitmaps
     deleteBitmaps();
     allocateBitmaps();
@@ -1347,6 +1481,7 @@ bool CAIRO_GAL::Show( bool aShow )
 
 int CAIRO_GAL::BeginGroup()
 {
+    drawPendingGroups();
     initSurface();
     return CAIRO_GAL_BASE::BeginGroup();
 }
@@ -1359,6 +1494,20 @@ void CAIRO_GAL::EndGroup()
 }
 
 
+void CAIRO_GAL::DrawGroup( int aGroupNumber )
+{
+    // Cached layers consist of groups only, so they can be rasterized out of order with
+    // respect to the immediate mode drawing done on the other targets
+    if( tiledRendering && validCompositor && isInitialized && currentTarget == TARGET_CACHED )
+    {
+        pendingGroups.push_back( aGroupNumber );
+        return;
+    }
+
+    CAIRO_GAL_BASE::DrawGroup( aGroupNumber );
+}
+
+
 void CAIRO_GAL::SetTarget( RENDER_TARGET aTarget )
 {
     // If the compositor is not set, that means that there is a recaching process going on
@@ -1366,6 +1515,8 @@ void CAIRO_GAL::SetTarget( RENDER_TARGET aTarget )
     if( !validCompositor )
         return;
 
+    drawPendingGroups();
+
     // Cairo grouping prevents display of overlapping items on the same layer in the lighter color
     if( isInitialized )
         storePath();
@@ -1395,6 +1546,8 @@ RENDER_TARGET CAIRO_GAL::GetTarget() const
 
 void CAIRO_GAL::ClearTarget( RENDER_TARGET aTarget )
 {
+    drawPendingGroups();
+
     // Save the current state
     unsigned int currentBuffer = compositor->GetBuffer();
 
@@ -1489,6 +1642,130 @@ void CAIRO_GAL::setCompositor()
 }
 
 
+void CAIRO_GAL::drawPendingGroups()
+{
+    if( pendingGroups.empty() )
+        return;
+
+    // Clear the list first, storePath() and the replayed commands may call back here
+    std::vector<int> groupList;
+    groupList.swap( pendingGroups );
+
+    storePath();
+
+    GROUP_STATE state = { isFillEnabled, isStrokeEnabled, fillColor, strokeColor };
+
+    // Small batches are not worth the setup cost of the tile contexts
+    const unsigned int height = screenSize.y;
+    size_t tileCount = std::min<size_t>( 2 * std::thread::hardware_concurrency(), height / 32 );
+
+    if( groupList.size() < 64 || tileCount <= 1 )
+    {
+        for( int group : groupList )
+            replayGroup( currentContext, state, group );
+    }
+    else
+    {
+        /// A group together with the attributes it starts with and the rows it covers
+        struct PENDING_GROUP
+        {
+            int         m_group;
+            GROUP_STATE m_state;
+            double      m_lineWidth;
+            double      m_top;
+            double      m_bottom;
+        };
+
+        // Measure the groups on a scratch context sharing the transformation of the target.
+        // A tile may skip groups, so the attributes each group starts with are recorded here
+        // instead of being carried over from the previous group.
+        cairo_surface_t* scratchSurface = cairo_image_surface_create( CAIRO_FORMAT_A8, 1, 1 );
+        cairo_t*         scratch = cairo_create( scratchSurface );
+        cairo_surface_destroy( scratchSurface );
+
+        cairo_matrix_t matrix;
+        cairo_get_matrix( currentContext, &matrix );
+        cairo_set_matrix( scratch, &matrix );
+        cairo_set_line_width( scratch, cairo_get_line_width( currentContext ) );
+        cairo_set_line_cap( scratch, cairo_get_line_cap( currentContext ) );
+        cairo_set_line_join( scratch, cairo_get_line_join( currentContext ) );
+
+        std::vector<PENDING_GROUP> pending;
+        pending.reserve( groupList.size() );
+
+        for( int group : groupList )
+        {
+            PENDING_GROUP entry = { group, state, cairo_get_line_width( scratch ),
+                                    std::numeric_limits<double>::max(),
+                                    std::numeric_limits<double>::lowest() };
+
+            groupExtents( scratch, state, group, entry.m_top, entry.m_bottom );
+
+            if( entry.m_top <= entry.m_bottom )
+                pending.push_back( entry );
+        }
+
+        double lineWidth = cairo_get_line_width( scratch );
+        cairo_destroy( scratch );
+
+        std::vector<cairo_t*>     tiles( tileCount );
+        std::vector<unsigned int> tileTops( tileCount + 1 );
+
+        for( size_t i = 0; i <= tileCount; ++i )
+            tileTops[i] = height * i / tileCount;
+
+        for( size_t i = 0; i < tileCount; ++i )
+            tiles[i] = compositor->CreateTileContext( tileTops[i], tileTops[i + 1] - tileTops[i] );
+
+        size_t parallelThreadCount = std::min<size_t>( std::thread::hardware_concurrency(),
+                                                       tileCount );
+        std::atomic<size_t> nextTile( 0 );
+        std::vector<std::future<size_t>> returns( parallelThreadCount );
+
+        auto replay_lambda =
+                [&]() -> size_t
+                {
+                    for( size_t i = nextTile++; i < tileCount; i = nextTile++ )
+                    {
+                        // Keep a pixel of margin for the antialiasing
+                        double top    = tileTops[i] - 1.0;
+                        double bottom = tileTops[i + 1] + 1.0;
+
+                        for( const PENDING_GROUP& entry : pending )
+                        {
+                            if( entry.m_bottom < top || entry.m_top > bottom )
+                                continue;
+
+                            GROUP_STATE tileState = entry.m_state;
+
+                            cairo_set_line_width( tiles[i], entry.m_lineWidth );
+                            replayGroup( tiles[i], tileState, entry.m_group );
+                        }
+                    }
+
+                    return 1;
+                };
+
+        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+            returns[ii] = std::async( std::launch::async, replay_lambda );
+
+        // Finalize the threads
+        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+            returns[ii].wait();
+
+        for( cairo_t* tile : tiles )
+            cairo_destroy( tile );
+
+        cairo_set_line_width( currentContext, lineWidth );
+    }
+
+    isFillEnabled   = state.isFill;
+    isStrokeEnabled = state.isStroke;
+    fillColor       = state.fillColor;
+    strokeColor     = state.strokeColor;
+}
+
+
 void CAIRO_GAL::onPaint( wxPaintEvent& aEvent )
 {
     PostPaint( aEvent );
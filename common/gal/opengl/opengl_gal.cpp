@@ -982,6 +982,31 @@ void OPENGL_GAL::DrawPolyline( const SHAPE_LINE_CHAIN& aLineChain )
 }
 
 
+void OPENGL_GAL::DrawPolylines( const std::vector<std::vector<VECTOR2D>>& aPointLists )
+{
+    int lineQuadCount = 0;
+
+    for( const std::vector<VECTOR2D>& points : aPointLists )
+    {
+        if( points.size() >= 2 )
+            lineQuadCount += points.size() - 1;
+    }
+
+    if( lineQuadCount == 0 )
+        return;
+
+    // Reserve the space for all the segments at once, 6 vertices per line quad
+    currentManager->Reserve( 6 * lineQuadCount );
+    currentManager->Color( strokeColor.r, strokeColor.g, strokeColor.b, strokeColor.a );
+
+    for( const std::vector<VECTOR2D>& points : aPointLists )
+    {
+        for( size_t i = 1; i < points.size(); ++i )
+            drawLineQuad( points[i - 1], points[i], false );
+    }
+}
+
+
 void OPENGL_GAL::DrawPolygon( const std::deque<VECTOR2D>& aPointList )
 {
     wxCHECK( aPointList.size() >= 2, /* void */ );
@@ -1696,7 +1721,8 @@ void OPENGL_GAL::DrawCursor( const VECTOR2D& aCursorPosition )
 }
 
 
-void OPENGL_GAL::drawLineQuad( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint )
+void OPENGL_GAL::drawLineQuad( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint,
+                               bool aReserve )
 {
     /* Helper drawing:                   ____--- v3       ^
      *                           ____---- ...   \          \
@@ -1718,7 +1744,8 @@ void OPENGL_GAL::drawLineQuad( const VECTOR2D& aStartPoint, const VECTOR2D& aEnd
 
     VECTOR2D vs( v2.x - v1.x, v2.y - v1.y );
 
-    currentManager->Reserve( 6 );
+    if( aReserve )
+        currentManager->Reserve( 6 );
 
     // Line width is maintained by the vertex shader
     currentManager->Shader( SHADER_LINE_A, lineWidth, vs.x, vs.y );
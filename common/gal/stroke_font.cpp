@@ -31,6 +31,7 @@
 #include <math/util.h>      // for KiROUND
 #include <wx/string.h>
 #include <gr_text.h>
+#include <hash_eda.h>
 
 
 using namespace KIGFX;
@@ -41,6 +42,15 @@ const double STROKE_FONT::UNDERLINE_POSITION_FACTOR = 0.41;
 const double STROKE_FONT::BOLD_FACTOR = 1.3;
 const double STROKE_FONT::STROKE_FONT_SCALE = 1.0 / 21.0;
 const double STROKE_FONT::ITALIC_TILT = 1.0 / 8;
+const size_t STROKE_FONT::MAX_CACHE_ENTRIES = 200000;
+
+///> Text attributes that change the stroke geometry of a text line
+enum RUN_FLAGS
+{
+    RUN_ITALIC     = 0x01,
+    RUN_MIRRORED   = 0x02,
+    RUN_UNDERLINED = 0x04
+};
 
 
 GLYPH_LIST*         g_newStrokeFontGlyphs = nullptr;     ///< Glyph list
@@ -55,6 +65,10 @@ STROKE_FONT::STROKE_FONT( GAL* aGal ) :
 
 bool STROKE_FONT::LoadNewStrokeFont( const char* const aNewStrokeFont[], int aNewStrokeFontSize )
 {
+    // The glyphs are shared by all the fonts, and fonts can be created by several threads
+    static std::mutex loadMutex;
+    std::lock_guard<std::mutex> lock( loadMutex );
+
     if( g_newStrokeFontGlyphs )
     {
         m_glyphs = g_newStrokeFontGlyphs;
@@ -155,10 +169,46 @@ bool STROKE_FONT::LoadNewStrokeFont( const char* const aNewStrokeFont[], int aNe
 
     m_glyphs = g_newStrokeFontGlyphs;
     m_glyphBoundingBoxes = g_newStrokeFontGlyphBoundingBoxes;
+    ClearCache();
     return true;
 }
 
 
+void STROKE_FONT::ClearCache()
+{
+    std::lock_guard<std::mutex> lock( m_cacheMutex );
+
+    m_runCache.clear();
+    m_sizeCache.clear();
+}
+
+
+std::size_t STROKE_FONT::RUN_KEY_HASH::operator()( const RUN_KEY& aKey ) const
+{
+    return hash_val( aKey.m_text, aKey.m_glyphSize.x, aKey.m_glyphSize.y, aKey.m_thickness,
+                     aKey.m_flags );
+}
+
+
+STROKE_FONT::RUN_KEY STROKE_FONT::makeRunKey( const std::string& aText,
+                                              const VECTOR2D& aGlyphSize,
+                                              double aGlyphThickness ) const
+{
+    int flags = 0;
+
+    if( m_gal->IsFontItalic() )
+        flags |= RUN_ITALIC;
+
+    if( m_gal->IsTextMirrored() )
+        flags |= RUN_MIRRORED;
+
+    if( m_gal->IsFontUnderlined() )
+        flags |= RUN_UNDERLINED;
+
+    return RUN_KEY{ aText, aGlyphSize, aGlyphThickness, flags };
+}
+
+
 // Static function:
 double STROKE_FONT::GetInterline( double aGlyphHeight )
 {
@@ -268,16 +318,8 @@ void STROKE_FONT::Draw( const UTF8& aText, const VECTOR2D& aPosition, double aRo
 
 void STROKE_FONT::drawSingleLineText( const UTF8& aText )
 {
-    double      xOffset;
-    double      yOffset;
-    VECTOR2D    baseGlyphSize( m_gal->GetGlyphSize() );
-    double      overbar_italic_comp = computeOverbarVerticalPosition() * ITALIC_TILT;
-
-    if( m_gal->IsTextMirrored() )
-        overbar_italic_comp = -overbar_italic_comp;
-
-    // Compute the text size
-    VECTOR2D textSize = computeTextLineSize( aText );
+    std::shared_ptr<const GLYPH_RUN> cachedRun = getGlyphRun( aText );
+    const GLYPH_RUN&                 run = *cachedRun;
     double half_thickness = m_gal->GetLineWidth()/2;
 
     // Context needs to be saved before any transformations
@@ -294,23 +336,73 @@ void STROKE_FONT::drawSingleLineText( const UTF8& aText )
     switch( m_gal->GetHorizontalJustify() )
     {
     case GR_TEXT_HJUSTIFY_CENTER:
-        m_gal->Translate( VECTOR2D( -textSize.x / 2.0, 0 ) );
+        m_gal->Translate( VECTOR2D( -run.m_size.x / 2.0, 0 ) );
         break;
 
     case GR_TEXT_HJUSTIFY_RIGHT:
         if( !m_gal->IsTextMirrored() )
-            m_gal->Translate( VECTOR2D( -textSize.x, 0 ) );
+            m_gal->Translate( VECTOR2D( -run.m_size.x, 0 ) );
         break;
 
     case GR_TEXT_HJUSTIFY_LEFT:
         if( m_gal->IsTextMirrored() )
-            m_gal->Translate( VECTOR2D( -textSize.x, 0 ) );
+            m_gal->Translate( VECTOR2D( -run.m_size.x, 0 ) );
         break;
 
     default:
         break;
     }
 
+    // The whole line goes to the GAL in a single call, so it can be batched by the backend
+    m_gal->DrawPolylines( run.m_strokes );
+
+    m_gal->Restore();
+}
+
+
+std::shared_ptr<const GLYPH_RUN> STROKE_FONT::getGlyphRun( const UTF8& aText )
+{
+    RUN_KEY key = makeRunKey( aText, m_gal->GetGlyphSize(), m_gal->GetLineWidth() );
+
+    {
+        std::lock_guard<std::mutex> lock( m_cacheMutex );
+        auto it = m_runCache.find( key );
+
+        if( it != m_runCache.end() )
+            return it->second;
+    }
+
+    std::shared_ptr<GLYPH_RUN> run = std::make_shared<GLYPH_RUN>();
+    buildGlyphRun( aText, *run );
+
+    std::lock_guard<std::mutex> lock( m_cacheMutex );
+
+    // Simple flush policy; the cache is rebuilt from the items that are actually redrawn
+    if( m_runCache.size() >= MAX_CACHE_ENTRIES )
+        m_runCache.clear();
+
+    m_runCache.emplace( std::move( key ), run );
+
+    return run;
+}
+
+
+void STROKE_FONT::buildGlyphRun( const UTF8& aText, GLYPH_RUN& aRun ) const
+{
+    double      xOffset;
+    double      yOffset;
+    VECTOR2D    baseGlyphSize( m_gal->GetGlyphSize() );
+    double      overbar_italic_comp = computeOverbarVerticalPosition() * ITALIC_TILT;
+
+    if( m_gal->IsTextMirrored() )
+        overbar_italic_comp = -overbar_italic_comp;
+
+    // Compute the text size
+    VECTOR2D textSize = computeTextLineSize( aText );
+
+    aRun.m_size = textSize;
+    aRun.m_strokes.clear();
+
     if( m_gal->IsTextMirrored() )
     {
         // In case of mirrored text invert the X scale of points and their X direction
@@ -438,7 +530,7 @@ void STROKE_FONT::drawSingleLineText( const UTF8& aText )
             VECTOR2D startOverbar( overbar_start_x, overbar_start_y );
             VECTOR2D endOverbar( overbar_end_x, overbar_end_y );
 
-            m_gal->DrawLine( startOverbar, endOverbar );
+            aRun.m_strokes.push_back( { startOverbar, endOverbar } );
         }
         else
         {
@@ -451,12 +543,14 @@ void STROKE_FONT::drawSingleLineText( const UTF8& aText )
             VECTOR2D startUnderline( xOffset, - vOffset );
             VECTOR2D endUnderline( xOffset + glyphSize.x * bbox.GetEnd().x, - vOffset );
 
-            m_gal->DrawLine( startUnderline, endUnderline );
+            aRun.m_strokes.push_back( { startUnderline, endUnderline } );
         }
 
         for( const std::vector<VECTOR2D>* ptList : *glyph )
         {
-            std::deque<VECTOR2D> ptListScaled;
+            aRun.m_strokes.emplace_back();
+            std::vector<VECTOR2D>& ptListScaled = aRun.m_strokes.back();
+            ptListScaled.reserve( ptList->size() );
 
             for( const VECTOR2D& pt : *ptList )
             {
@@ -474,14 +568,10 @@ void STROKE_FONT::drawSingleLineText( const UTF8& aText )
 
                 ptListScaled.push_back( scaledPt );
             }
-
-            m_gal->DrawPolyline( ptListScaled );
         }
 
         xOffset += glyphSize.x * bbox.GetEnd().x;
     }
-
-    m_gal->Restore();
 }
 
 
@@ -517,6 +607,17 @@ VECTOR2D STROKE_FONT::computeTextLineSize( const UTF8& aText ) const
 VECTOR2D STROKE_FONT::ComputeStringBoundaryLimits( const UTF8& aText, const VECTOR2D& aGlyphSize,
                                                    double aGlyphThickness ) const
 {
+    // Only the italic attribute changes the boundary limits
+    RUN_KEY key{ aText, aGlyphSize, aGlyphThickness, m_gal->IsFontItalic() ? RUN_ITALIC : 0 };
+
+    {
+        std::lock_guard<std::mutex> lock( m_cacheMutex );
+        auto it = m_sizeCache.find( key );
+
+        if( it != m_sizeCache.end() )
+            return it->second;
+    }
+
     VECTOR2D string_bbox;
     int line_count = 1;
     double maxX = 0.0, curX = 0.0;
@@ -608,5 +709,12 @@ VECTOR2D STROKE_FONT::ComputeStringBoundaryLimits( const UTF8& aText, const VECT
     if( m_gal->IsFontItalic() )
         string_bbox.x += string_bbox.y * STROKE_FONT::ITALIC_TILT;
 
+    std::lock_guard<std::mutex> lock( m_cacheMutex );
+
+    if( m_sizeCache.size() >= MAX_CACHE_ENTRIES )
+        m_sizeCache.clear();
+
+    m_sizeCache.emplace( std::move( key ), string_bbox );
+
     return string_bbox;
 }
@@ -0,0 +1,351 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <lib_tree_index.h>
+
+#include <wx/ffile.h>
+#include <wx/filename.h>
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+
+/*
+ * File layout (all integers are little endian, strings are a 32 bit byte count followed by
+ * the UTF-8 bytes):
+ *
+ *   magic "KILIBIDX", u32 version, u32 library count
+ *   for each library:
+ *       string nickname, i64 timestamp, u32 item count
+ *       for each item:
+ *           string name, description, keywords, search text
+ *           u8 flags (1 = root, 2 = power), u32 pad count
+ *           u32 unit count, unit count strings
+ *           u32 field count, field count pairs of strings (name, text)
+ */
+
+const unsigned LIB_TREE_INDEX::INDEX_VERSION = 1;
+
+static const char INDEX_MAGIC[] = "KILIBIDX";
+
+enum INDEX_ITEM_FLAGS
+{
+    ITEM_ROOT  = 1,
+    ITEM_POWER = 2
+};
+
+
+/**
+ * Serializes the index to a memory buffer, written to the file in one block.
+ */
+class INDEX_WRITER
+{
+public:
+    void Write( uint64_t aValue, int aBytes )
+    {
+        for( int ii = 0; ii < aBytes; ++ii )
+            m_buffer.push_back( (char) ( ( aValue >> ( 8 * ii ) ) & 0xFF ) );
+    }
+
+    void Write( const wxString& aText )
+    {
+        wxScopedCharBuffer utf8 = aText.utf8_str();
+
+        Write( utf8.length(), 4 );
+        m_buffer.append( utf8.data(), utf8.length() );
+    }
+
+    std::string m_buffer;
+};
+
+
+/**
+ * Reads the index from the memory buffer of the whole file.  Reading past the end of the
+ * buffer sets the error flag and returns zeros.
+ */
+class INDEX_READER
+{
+public:
+    INDEX_READER( const std::string& aBuffer ) :
+            m_buffer( aBuffer ),
+            m_pos( 0 ),
+            m_error( false )
+    {}
+
+    uint64_t ReadInt( int aBytes )
+    {
+        if( m_pos + aBytes > m_buffer.size() )
+        {
+            m_error = true;
+            return 0;
+        }
+
+        uint64_t value = 0;
+
+        for( int ii = 0; ii < aBytes; ++ii )
+            value |= uint64_t( (unsigned char) m_buffer[m_pos++] ) << ( 8 * ii );
+
+        return value;
+    }
+
+    wxString ReadString()
+    {
+        size_t len = (size_t) ReadInt( 4 );
+
+        if( m_error || m_pos + len > m_buffer.size() )
+        {
+            m_error = true;
+            return wxEmptyString;
+        }
+
+        wxString text = wxString::FromUTF8( m_buffer.data() + m_pos, len );
+        m_pos += len;
+        return text;
+    }
+
+    /// A count of items of at least aMinSize bytes each, checked against the remaining size
+    size_t ReadCount( size_t aMinSize )
+    {
+        size_t count = (size_t) ReadInt( 4 );
+
+        if( count * aMinSize > m_buffer.size() - std::min( m_pos, m_buffer.size() ) )
+            m_error = true;
+
+        return m_error ? 0 : count;
+    }
+
+    bool IsError() const { return m_error; }
+
+private:
+    const std::string& m_buffer;
+    size_t             m_pos;
+    bool               m_error;
+};
+
+
+LIB_TREE_INDEX::ITEM::ITEM( LIB_TREE_ITEM* aItem ) :
+        m_libId( aItem->GetLibId() ),
+        m_description( aItem->GetDescription() ),
+        m_searchText( aItem->GetSearchText() ),
+        m_isRoot( aItem->IsRoot() ),
+        m_isPower( false ),
+        m_padCount( 0 )
+{
+    m_libId.SetLibNickname( aItem->GetLibNickname() );
+    m_libId.SetLibItemName( aItem->GetName() );
+
+    // A single unit item has no unit reference
+    if( aItem->GetUnitCount() > 1 )
+    {
+        for( int unit = 1; unit <= aItem->GetUnitCount(); ++unit )
+            m_unitReferences.push_back( aItem->GetUnitReference( unit ) );
+    }
+}
+
+
+wxString LIB_TREE_INDEX::ITEM::GetUnitReference( int aUnit )
+{
+    if( aUnit < 1 || aUnit > (int) m_unitReferences.size() )
+        return wxEmptyString;
+
+    return m_unitReferences[aUnit - 1];
+}
+
+
+bool LIB_TREE_INDEX::Load( const wxString& aFileName )
+{
+    m_libraries.clear();
+    m_modified = false;
+
+    if( !wxFileName::FileExists( aFileName ) )
+        return false;
+
+    wxFFile file( aFileName, "rb" );
+
+    if( !file.IsOpened() )
+        return false;
+
+    std::string buffer;
+    buffer.resize( (size_t) file.Length() );
+
+    if( buffer.empty() || file.Read( &buffer[0], buffer.size() ) != buffer.size() )
+        return false;
+
+    file.Close();
+
+    const size_t magicLen = sizeof( INDEX_MAGIC ) - 1;
+
+    if( buffer.size() < magicLen || buffer.compare( 0, magicLen, INDEX_MAGIC ) != 0 )
+        return false;
+
+    INDEX_READER reader( buffer );
+    reader.ReadInt( magicLen );
+
+    if( reader.ReadInt( 4 ) != INDEX_VERSION )
+        return false;
+
+    size_t libCount = reader.ReadCount( 16 );
+
+    for( size_t ii = 0; ii < libCount && !reader.IsError(); ++ii )
+    {
+        wxString  nickname = reader.ReadString();
+        LIBRARY&  lib = m_libraries[nickname];
+
+        lib.m_Timestamp = (long long) reader.ReadInt( 8 );
+
+        size_t itemCount = reader.ReadCount( 29 );
+        lib.m_Items.reserve( itemCount );
+
+        for( size_t jj = 0; jj < itemCount && !reader.IsError(); ++jj )
+        {
+            std::unique_ptr<ITEM> item( new ITEM() );
+
+            item->m_libId.SetLibNickname( nickname );
+            item->m_libId.SetLibItemName( reader.ReadString() );
+            item->m_description = reader.ReadString();
+            item->m_keywords = reader.ReadString();
+            item->m_searchText = reader.ReadString();
+
+            int flags = (int) reader.ReadInt( 1 );
+            item->m_isRoot = ( flags & ITEM_ROOT ) != 0;
+            item->m_isPower = ( flags & ITEM_POWER ) != 0;
+            item->m_padCount = (unsigned) reader.ReadInt( 4 );
+
+            size_t unitCount = reader.ReadCount( 4 );
+
+            for( size_t unit = 0; unit < unitCount; ++unit )
+                item->m_unitReferences.push_back( reader.ReadString() );
+
+            size_t fieldCount = reader.ReadCount( 8 );
+
+            for( size_t field = 0; field < fieldCount; ++field )
+            {
+                wxString name = reader.ReadString();
+                item->m_fields.emplace_back( name, reader.ReadString() );
+            }
+
+            lib.m_Items.push_back( std::move( item ) );
+        }
+    }
+
+    if( reader.IsError() )
+    {
+        // whatever went wrong, invalidate the index
+        m_libraries.clear();
+        return false;
+    }
+
+    return true;
+}
+
+
+bool LIB_TREE_INDEX::Save( const wxString& aFileName ) const
+{
+    INDEX_WRITER writer;
+
+    writer.m_buffer.append( INDEX_MAGIC, sizeof( INDEX_MAGIC ) - 1 );
+    writer.Write( INDEX_VERSION, 4 );
+    writer.Write( m_libraries.size(), 4 );
+
+    for( const std::pair<const wxString, LIBRARY>& entry : m_libraries )
+    {
+        writer.Write( entry.first );
+        writer.Write( (uint64_t) entry.second.m_Timestamp, 8 );
+        writer.Write( entry.second.m_Items.size(), 4 );
+
+        for( const std::unique_ptr<ITEM>& item : entry.second.m_Items )
+        {
+            writer.Write( item->GetName() );
+            writer.Write( item->m_description );
+            writer.Write( item->m_keywords );
+            writer.Write( item->m_searchText );
+            writer.Write( ( item->m_isRoot ? ITEM_ROOT : 0 ) | ( item->m_isPower ? ITEM_POWER : 0 ),
+                          1 );
+            writer.Write( item->m_padCount, 4 );
+
+            writer.Write( item->m_unitReferences.size(), 4 );
+
+            for( const wxString& ref : item->m_unitReferences )
+                writer.Write( ref );
+
+            writer.Write( item->m_fields.size(), 4 );
+
+            for( const std::pair<wxString, wxString>& field : item->m_fields )
+            {
+                writer.Write( field.first );
+                writer.Write( field.second );
+            }
+        }
+    }
+
+    wxFFile file( aFileName, "wb" );
+
+    if( !file.IsOpened() )
+        return false;
+
+    return file.Write( writer.m_buffer.data(), writer.m_buffer.size() ) == writer.m_buffer.size()
+           && file.Close();
+}
+
+
+const LIB_TREE_INDEX::LIBRARY* LIB_TREE_INDEX::FindLibrary( const wxString& aNickname,
+                                                           long long aTimestamp ) const
+{
+    auto it = m_libraries.find( aNickname );
+
+    if( it == m_libraries.end() || it->second.m_Timestamp != aTimestamp )
+        return nullptr;
+
+    return &it->second;
+}
+
+
+LIB_TREE_INDEX::LIBRARY& LIB_TREE_INDEX::SetLibrary( const wxString& aNickname,
+                                                     long long aTimestamp )
+{
+    LIBRARY& lib = m_libraries[aNickname];
+
+    lib.m_Timestamp = aTimestamp;
+    lib.m_Items.clear();
+    m_modified = true;
+
+    return lib;
+}
+
+
+void LIB_TREE_INDEX::KeepLibraries( const std::vector<wxString>& aNicknames )
+{
+    for( auto it = m_libraries.begin(); it != m_libraries.end(); )
+    {
+        if( std::find( aNicknames.begin(), aNicknames.end(), it->first ) == aNicknames.end() )
+        {
+            it = m_libraries.erase( it );
+            m_modified = true;
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
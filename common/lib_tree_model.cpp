@@ -23,11 +23,16 @@
 
 #include <algorithm>
 #include <eda_pattern_match.h>
+#include <iterator>
 #include <lib_tree_item.h>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <pgm_base.h>
 #include <kicad_string.h>
 
+#include <wx/tokenzr.h>
+
 // Each node gets this lowest score initially, without any matches applied.
 // Matches will then increase this score depending on match quality.  This way,
 // an empty search string will result in all components being displayed as they
@@ -50,6 +55,41 @@ static int matchPosScore(int aPosition, int aMaximum)
 }
 
 
+// A search term is literal when it has no regex, wildcard or relational syntax.  All the
+// matchers of EDA_COMBINED_MATCHER then find it as a plain substring, and only there.
+static bool isLiteralTerm( const wxString& aTerm )
+{
+    static const wxString specialChars( wxT( ".*+?^${}()|[]\\<>=" ) );
+
+    for( wxUniChar c : aTerm )
+    {
+        if( specialChars.Find( c ) != wxNOT_FOUND )
+            return false;
+    }
+
+    return true;
+}
+
+
+static uint64_t trigramKey( const wxString& aText, size_t aPos )
+{
+    return ( uint64_t( aText[aPos].GetValue() ) << 42 )
+           | ( uint64_t( aText[aPos + 1].GetValue() ) << 21 )
+           | uint64_t( aText[aPos + 2].GetValue() );
+}
+
+
+// Tell the root of the tree its search index must be rebuilt
+static void invalidateSearchIndex( LIB_TREE_NODE* aNode )
+{
+    while( aNode && aNode->m_Type != LIB_TREE_NODE::ROOT )
+        aNode = aNode->m_Parent;
+
+    if( aNode )
+        static_cast<LIB_TREE_NODE_ROOT*>( aNode )->InvalidateSearchIndex();
+}
+
+
 void LIB_TREE_NODE::ResetScore()
 {
     for( auto& child: m_Children )
@@ -191,6 +231,8 @@ void LIB_TREE_NODE_LIB_ID::Update( LIB_TREE_ITEM* aItem )
 {
     // Update is called when the names match, so just update the other fields.
 
+    invalidateSearchIndex( this );
+
     m_LibId.SetLibNickname( aItem->GetLibId().GetLibNickname() );
 
     m_Desc = aItem->GetDescription();
@@ -277,6 +319,7 @@ LIB_TREE_NODE_LIB_ID& LIB_TREE_NODE_LIB::AddItem( LIB_TREE_ITEM* aItem )
 {
     LIB_TREE_NODE_LIB_ID* item = new LIB_TREE_NODE_LIB_ID( this, aItem );
     m_Children.push_back( std::unique_ptr<LIB_TREE_NODE>( item ) );
+    invalidateSearchIndex( this );
     return *item;
 }
 
@@ -317,23 +360,216 @@ void LIB_TREE_NODE_LIB::UpdateScore( EDA_COMBINED_MATCHER& aMatcher )
 }
 
 
+/**
+ * An inverted index of the trigrams of the (normalized) names and search texts of the
+ * #LIB_ID nodes, and the result of the last search.
+ */
+struct LIB_TREE_NODE_ROOT::SEARCH_INDEX
+{
+    std::vector<LIB_TREE_NODE*>                          m_Nodes;
+    std::unordered_map<uint64_t, std::vector<uint32_t>>  m_Postings;  ///< ascending node indices
+
+    wxString                m_LastSearch;    ///< empty if the last search was not literal
+    std::vector<char>       m_Survivors;     ///< nodes still scored after the last search
+};
+
+
 LIB_TREE_NODE_ROOT::LIB_TREE_NODE_ROOT()
 {
     m_Type = ROOT;
 }
 
 
+LIB_TREE_NODE_ROOT::~LIB_TREE_NODE_ROOT()
+{
+}
+
+
 LIB_TREE_NODE_LIB& LIB_TREE_NODE_ROOT::AddLib( wxString const& aName, wxString const& aDesc )
 {
     LIB_TREE_NODE_LIB* lib = new LIB_TREE_NODE_LIB( this, aName, aDesc );
     m_Children.push_back( std::unique_ptr<LIB_TREE_NODE>( lib ) );
+    InvalidateSearchIndex();
     return *lib;
 }
 
 
 void LIB_TREE_NODE_ROOT::UpdateScore( EDA_COMBINED_MATCHER& aMatcher )
 {
+    const wxString& term = aMatcher.GetPattern();
+
+    if( !m_searchIndex || term.length() < 3 || !isLiteralTerm( term ) )
+    {
+        for( auto& child: m_Children )
+            child->UpdateScore( aMatcher );
+
+        return;
+    }
+
+    // The candidates have all the trigrams of the term.  Start from the rarest one.
+    std::vector<const std::vector<uint32_t>*> postings;
+
+    for( size_t ii = 0; ii + 2 < term.length(); ++ii )
+    {
+        auto it = m_searchIndex->m_Postings.find( trigramKey( term, ii ) );
+
+        if( it == m_searchIndex->m_Postings.end() )
+        {
+            postings.clear();
+            break;
+        }
+
+        postings.push_back( &it->second );
+    }
+
+    std::sort( postings.begin(), postings.end(),
+               []( const std::vector<uint32_t>* a, const std::vector<uint32_t>* b )
+               {
+                   return a->size() < b->size();
+               } );
+
+    std::vector<char> candidates( m_searchIndex->m_Nodes.size(), 0 );
+
+    if( !postings.empty() )
+    {
+        std::vector<uint32_t> current = *postings[0];
+        std::vector<uint32_t> next;
+
+        for( size_t ii = 1; ii < postings.size() && !current.empty(); ++ii )
+        {
+            next.clear();
+            std::set_intersection( current.begin(), current.end(), postings[ii]->begin(),
+                                   postings[ii]->end(), std::back_inserter( next ) );
+            current.swap( next );
+        }
+
+        for( uint32_t idx : current )
+            candidates[idx] = 1;
+    }
+
+    // A library name matching the term scores all its items
+    std::unordered_set<LIB_TREE_NODE*> matchingLibs;
+
     for( auto& child: m_Children )
-        child->UpdateScore( aMatcher );
+    {
+        if( child->m_Children.empty() )
+            child->UpdateScore( aMatcher );
+        else if( child->m_MatchName.Contains( term ) )
+            matchingLibs.insert( child.get() );
+    }
+
+    for( size_t ii = 0; ii < m_searchIndex->m_Nodes.size(); ++ii )
+    {
+        LIB_TREE_NODE* node = m_searchIndex->m_Nodes[ii];
+
+        if( candidates[ii] || matchingLibs.count( node->m_Parent ) )
+            node->UpdateScore( aMatcher );
+        else
+            node->m_Score = 0;
+    }
+
+    for( auto& child: m_Children )
+    {
+        if( child->m_Children.empty() )
+            continue;
+
+        child->m_Score = 0;
+
+        for( auto& grandchild: child->m_Children )
+            child->m_Score = std::max( child->m_Score, grandchild->m_Score );
+    }
+}
+
+
+void LIB_TREE_NODE_ROOT::UpdateSearchScores( const wxString& aSearch )
+{
+    ResetScore();
+
+    for( auto& child: m_Children )
+    {
+        if( child->m_Pinned )
+            child->m_Score *= 2;
+    }
+
+    if( !m_searchIndex )
+        buildSearchIndex();
+
+    const wxString search = aSearch.Lower();
+    const bool     literal = isLiteralTerm( search );
+    SEARCH_INDEX&  index = *m_searchIndex;
+
+    // A literal term only matches the items which contain it, so when the search string
+    // only grows, the items dropped by the previous search stay dropped.
+    if( literal && !index.m_LastSearch.IsEmpty() && search.StartsWith( index.m_LastSearch ) )
+    {
+        for( size_t ii = 0; ii < index.m_Nodes.size(); ++ii )
+        {
+            if( !index.m_Survivors[ii] )
+                index.m_Nodes[ii]->m_Score = 0;
+        }
+    }
+
+    wxStringTokenizer tokenizer( search );
+
+    while( tokenizer.HasMoreTokens() )
+    {
+        EDA_COMBINED_MATCHER matcher( tokenizer.GetNextToken() );
+
+        UpdateScore( matcher );
+    }
+
+    index.m_LastSearch = literal ? search : wxString();
+
+    for( size_t ii = 0; ii < index.m_Nodes.size(); ++ii )
+        index.m_Survivors[ii] = index.m_Nodes[ii]->m_Score > 0;
+}
+
+
+void LIB_TREE_NODE_ROOT::InvalidateSearchIndex()
+{
+    m_searchIndex.reset();
+}
+
+
+void LIB_TREE_NODE_ROOT::buildSearchIndex()
+{
+    m_searchIndex.reset( new SEARCH_INDEX );
+
+    std::vector<uint64_t> keys;
+
+    for( auto& lib: m_Children )
+    {
+        for( auto& child: lib->m_Children )
+        {
+            LIB_TREE_NODE* node = child.get();
+            uint32_t       idx = (uint32_t) m_searchIndex->m_Nodes.size();
+
+            if( !node->m_Normalized )
+            {
+                node->m_MatchName = node->m_MatchName.Lower();
+                node->m_SearchText = node->m_SearchText.Lower();
+                node->m_Normalized = true;
+            }
+
+            keys.clear();
+
+            for( const wxString* text : { &node->m_MatchName, &node->m_SearchText } )
+            {
+                for( size_t ii = 0; ii + 2 < text->length(); ++ii )
+                    keys.push_back( trigramKey( *text, ii ) );
+            }
+
+            std::sort( keys.begin(), keys.end() );
+            keys.erase( std::unique( keys.begin(), keys.end() ), keys.end() );
+
+            // Nodes are indexed in order, so the postings stay sorted
+            for( uint64_t key : keys )
+                m_searchIndex->m_Postings[key].push_back( idx );
+
+            m_searchIndex->m_Nodes.push_back( node );
+        }
+    }
+
+    m_searchIndex->m_Survivors.assign( m_searchIndex->m_Nodes.size(), 1 );
 }
 
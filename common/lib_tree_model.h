@@ -52,6 +52,8 @@ class EDA_COMBINED_MATCHER;
  *
  * - `UpdateScore()` - accumulate scores recursively given a new search token
  * - `ResetScore()` - reset scores recursively for a new search string
+ * - `LIB_TREE_NODE_ROOT::UpdateSearchScores()` - score the whole tree for a search string,
+ *      using a trigram index of the items to skip the ones which cannot match
  * - `AssignIntrinsicRanks()` - calculate and cache the initial sort order
  * - `SortNodes()` - recursively sort the tree by score
  * - `Compare()` - compare two nodes; used by `SortNodes()`
@@ -276,12 +278,43 @@ public:
      */
     LIB_TREE_NODE_ROOT();
 
+    ~LIB_TREE_NODE_ROOT();
+
     /**
      * Construct an empty library node, add it to the root, and return it.
      */
     LIB_TREE_NODE_LIB& AddLib( wxString const& aName, wxString const& aDesc );
 
+    /**
+     * Update the scores for a search term.
+     *
+     * A term without any regex, wildcard or relational syntax only matches the items
+     * containing it, so only the items having all its trigrams in their name, keywords
+     * or description are scored; the other ones are dropped.
+     */
     virtual void UpdateScore( EDA_COMBINED_MATCHER& aMatcher ) override;
+
+    /**
+     * Reset the scores and accumulate the scores of all the terms of \a aSearch.
+     *
+     * When \a aSearch only extends the previous search string, and neither uses any regex,
+     * wildcard or relational syntax, the items dropped by the previous search are not
+     * scored again.  The scores are the same as the ones of a full search.
+     */
+    void UpdateSearchScores( const wxString& aSearch );
+
+    /**
+     * Drop the search index.  Must be called when nodes are removed from the tree; the
+     * node methods adding or updating nodes call it.
+     */
+    void InvalidateSearchIndex();
+
+private:
+    struct SEARCH_INDEX;
+
+    void buildSearchIndex();
+
+    std::unique_ptr<SEARCH_INDEX> m_searchIndex;
 };
 
 
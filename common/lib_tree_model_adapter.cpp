@@ -203,24 +203,7 @@ void LIB_TREE_MODEL_ADAPTER::UpdateSearchString( wxString const& aSearch )
         m_widget->UnselectAll();
         Freeze();
 
-        m_tree.ResetScore();
-
-        for( auto& child: m_tree.m_Children )
-        {
-            if( child->m_Pinned )
-                child->m_Score *= 2;
-        }
-
-        wxStringTokenizer tokenizer( aSearch );
-
-        while( tokenizer.HasMoreTokens() )
-        {
-            const wxString term = tokenizer.GetNextToken().Lower();
-            EDA_COMBINED_MATCHER matcher( term );
-
-            m_tree.UpdateScore( matcher );
-        }
-
+        m_tree.UpdateSearchScores( aSearch );
         m_tree.SortNodes();
         AfterReset();
         Thaw();
@@ -32,6 +32,7 @@
 #include <trigo.h>
 
 #include <build_version.h>
+#include <hash_eda.h>
 
 #include "plotter_gerber.h"
 #include "gbr_plotter_aperture_macros.h"
@@ -207,17 +208,20 @@ bool GERBER_PLOTTER::StartPlot()
 
     wxASSERT( outputFile );
 
-    finalFile = outputFile;     // the actual gerber file will be created later
+    // The header is written in the actual gerber file, the body in a work file
+    finalFile = outputFile;
 
     // Create a temp file in system temp to avoid potential network share buffer issues for the final read and save
     m_workFilename = wxFileName::CreateTempFileName( "" );
-    workFile   = wxFopen( m_workFilename, wxT( "wt" ));
-    outputFile = workFile;
-    wxASSERT( outputFile );
+    workFile   = wxFopen( m_workFilename, wxT( "wb" ));
+    wxASSERT( workFile );
 
-    if( outputFile == NULL )
+    if( workFile == NULL )
         return false;
 
+    // The body is written in many small records: use a large buffer
+    setvbuf( workFile, NULL, _IOFBF, 1 << 20 );
+
     for( unsigned ii = 0; ii < m_headerExtraLines.GetCount(); ii++ )
     {
         if( ! m_headerExtraLines[ii].IsEmpty() )
@@ -258,9 +262,11 @@ bool GERBER_PLOTTER::StartPlot()
     // Set initial interpolation mode: always G01 (linear):
     fputs( "G01*\n", outputFile );
 
-    // Add aperture list start point
+    // Add aperture list start point. The aperture list itself is written by EndPlot()
     fputs( "G04 APERTURE LIST*\n", outputFile );
 
+    outputFile = workFile;
+
     // Give a minimal value to the default pen size, used to plot items in sketch mode
     if( m_renderSettings )
     {
@@ -275,66 +281,67 @@ bool GERBER_PLOTTER::StartPlot()
 
 bool GERBER_PLOTTER::EndPlot()
 {
-    char     line[1024];
-    wxString msg;
-
     wxASSERT( outputFile );
 
     /* Outfile is actually a temporary file i.e. workFile */
     fputs( "M02*\n", outputFile );
     fflush( outputFile );
 
-    fclose( workFile );
-    workFile   = wxFopen( m_workFilename, wxT( "rt" ));
-    wxASSERT( workFile );
+    // Placement of apertures in RS274X: the header ends by "G04 APERTURE LIST*"
     outputFile = finalFile;
 
-    // Placement of apertures in RS274X
-    while( fgets( line, 1024, workFile ) )
+    // Add aperture list macro:
+    if( m_hasApertureRoundRect | m_hasApertureRotOval ||
+        m_hasApertureOutline4P || m_hasApertureRotRect ||
+        m_hasApertureChamferedRect )
     {
-        fputs( line, outputFile );
+        fputs( "G04 Aperture macros list*\n", outputFile );
 
-        char* substr = strtok( line, "\n\r" );
+        if( m_hasApertureRoundRect )
+            fputs( APER_MACRO_ROUNDRECT_HEADER, outputFile );
 
-        if( substr && strcmp( substr, "G04 APERTURE LIST*" ) == 0 )
-        {
-            // Add aperture list macro:
-            if( m_hasApertureRoundRect | m_hasApertureRotOval ||
-                m_hasApertureOutline4P || m_hasApertureRotRect ||
-                m_hasApertureChamferedRect )
-            {
-                fputs( "G04 Aperture macros list*\n", outputFile );
+        if( m_hasApertureRotOval )
+            fputs( APER_MACRO_SHAPE_OVAL_HEADER, outputFile );
+
+        if( m_hasApertureRotRect )
+            fputs( APER_MACRO_ROT_RECT_HEADER, outputFile );
 
-                if( m_hasApertureRoundRect )
-                    fputs( APER_MACRO_ROUNDRECT_HEADER, outputFile );
+        if( m_hasApertureOutline4P )
+            fputs( APER_MACRO_OUTLINE4P_HEADER, outputFile );
 
-                if( m_hasApertureRotOval )
-                    fputs( APER_MACRO_SHAPE_OVAL_HEADER, outputFile );
+        if( m_hasApertureChamferedRect )
+        {
+            fputs( APER_MACRO_OUTLINE5P_HEADER, outputFile );
+            fputs( APER_MACRO_OUTLINE6P_HEADER, outputFile );
+            fputs( APER_MACRO_OUTLINE7P_HEADER, outputFile );
+            fputs( APER_MACRO_OUTLINE8P_HEADER, outputFile );
+        }
 
-                if( m_hasApertureRotRect )
-                    fputs( APER_MACRO_ROT_RECT_HEADER, outputFile );
+        fputs( "G04 Aperture macros list end*\n", outputFile );
+    }
 
-                if( m_hasApertureOutline4P )
-                    fputs( APER_MACRO_OUTLINE4P_HEADER, outputFile );
+    writeApertureList();
+    fputs( "G04 APERTURE END LIST*\n", outputFile );
 
-                if( m_hasApertureChamferedRect )
-                {
-                    fputs( APER_MACRO_OUTLINE5P_HEADER, outputFile );
-                    fputs( APER_MACRO_OUTLINE6P_HEADER, outputFile );
-                    fputs( APER_MACRO_OUTLINE7P_HEADER, outputFile );
-                    fputs( APER_MACRO_OUTLINE8P_HEADER, outputFile );
-                }
+    // Append the body: it is copied as is, by blocks
+    fclose( workFile );
+    workFile = wxFopen( m_workFilename, wxT( "rb" ) );
+    wxASSERT( workFile );
 
-                fputs( "G04 Aperture macros list end*\n", outputFile );
-            }
+    if( workFile )
+    {
+        std::vector<char> buffer( 1 << 20 );
+        size_t            count;
 
-            writeApertureList();
-            fputs( "G04 APERTURE END LIST*\n", outputFile );
-        }
+        while( ( count = fread( buffer.data(), 1, buffer.size(), workFile ) ) > 0 )
+            fwrite( buffer.data(), 1, count, outputFile );
+
+        fclose( workFile );
     }
 
-    fclose( workFile );
+    workFile = NULL;
     fclose( finalFile );
+    finalFile = NULL;
     ::wxRemoveFile( m_workFilename );
     outputFile = 0;
 
@@ -359,21 +366,46 @@ void GERBER_PLOTTER::SetCurrentLineWidth( int aWidth, void* aData )
 }
 
 
+size_t GERBER_PLOTTER::apertureKey( const wxSize& aSize, int aRadius, double aRotDegree,
+                                    APERTURE::APERTURE_TYPE aType, int aApertureAttribute )
+{
+    // 0.0 and -0.0 are the same rotation
+    if( aRotDegree == 0.0 )
+        aRotDegree = 0.0;
+
+    return hash_val( static_cast<int>( aType ), aSize.x, aSize.y, aRadius, aRotDegree,
+                     aApertureAttribute );
+}
+
+
+size_t GERBER_PLOTTER::apertureKey( const std::vector<wxPoint>& aCorners,
+                                    APERTURE::APERTURE_TYPE aType, int aApertureAttribute )
+{
+    size_t key = hash_val( static_cast<int>( aType ), aCorners.size(), aApertureAttribute );
+
+    for( const wxPoint& corner : aCorners )
+        hash_combine( key, corner.x, corner.y );
+
+    return key;
+}
+
+
 int GERBER_PLOTTER::GetOrCreateAperture( const wxSize& aSize, int aRadius, double aRotDegree,
                         APERTURE::APERTURE_TYPE aType, int aApertureAttribute )
 {
-    int last_D_code = 9;
+    size_t key = apertureKey( aSize, aRadius, aRotDegree, aType, aApertureAttribute );
 
     // Search an existing aperture
-    for( int idx = 0; idx < (int)m_apertures.size(); ++idx )
+    auto range = m_apertureIndex.equal_range( key );
+
+    for( auto it = range.first; it != range.second; ++it )
     {
-        APERTURE* tool = &m_apertures[idx];
-        last_D_code = tool->m_DCode;
+        APERTURE* tool = &m_apertures[it->second];
 
         if( (tool->m_Type == aType) && (tool->m_Size == aSize) &&
             (tool->m_Radius == aRadius) && (tool->m_Rotation == aRotDegree) &&
             (tool->m_ApertureAttribute == aApertureAttribute) )
-            return idx;
+            return it->second;
     }
 
     // Allocate a new aperture
@@ -382,10 +414,11 @@ int GERBER_PLOTTER::GetOrCreateAperture( const wxSize& aSize, int aRadius, doubl
     new_tool.m_Type  = aType;
     new_tool.m_Radius  = aRadius;
     new_tool.m_Rotation  = aRotDegree;
-    new_tool.m_DCode = last_D_code + 1;
+    new_tool.m_DCode = m_apertures.empty() ? FIRST_DCODE_VALUE : m_apertures.back().m_DCode + 1;
     new_tool.m_ApertureAttribute = aApertureAttribute;
 
     m_apertures.push_back( new_tool );
+    m_apertureIndex.emplace( key, m_apertures.size() - 1 );
 
     return m_apertures.size() - 1;
 }
@@ -394,33 +427,19 @@ int GERBER_PLOTTER::GetOrCreateAperture( const wxSize& aSize, int aRadius, doubl
 int GERBER_PLOTTER::GetOrCreateAperture( const std::vector<wxPoint>& aCorners, double aRotDegree,
                          APERTURE::APERTURE_TYPE aType, int aApertureAttribute )
 {
-    int last_D_code = 9;
+    size_t key = apertureKey( aCorners, aType, aApertureAttribute );
 
     // Search an existing aperture
-    for( int idx = 0; idx < (int)m_apertures.size(); ++idx )
-    {
-        APERTURE* tool = &m_apertures[idx];
+    auto range = m_apertureIndex.equal_range( key );
 
-       last_D_code = tool->m_DCode;
+    for( auto it = range.first; it != range.second; ++it )
+    {
+        APERTURE* tool = &m_apertures[it->second];
 
-        if( (tool->m_Type == aType) && (tool->m_Corners.size() == aCorners.size() ) &&
+        // A candidate must have the same corner list
+        if( (tool->m_Type == aType) && (tool->m_Corners == aCorners ) &&
             (tool->m_ApertureAttribute == aApertureAttribute) )
-        {
-            // A candidate is found. the corner lists must be the same
-            bool is_same = true;
-
-            for( size_t ii = 0; ii < aCorners.size(); ii++ )
-            {
-                if( aCorners[ii] != tool->m_Corners[ii] )
-                {
-                    is_same = false;
-                    break;
-                }
-            }
-
-            if( is_same )
-                return idx;
-        }
+            return it->second;
     }
 
     // Allocate a new aperture
@@ -431,10 +450,11 @@ int GERBER_PLOTTER::GetOrCreateAperture( const std::vector<wxPoint>& aCorners, d
     new_tool.m_Type     = aType;
     new_tool.m_Radius   = 0;             // Not used
     new_tool.m_Rotation = aRotDegree;
-    new_tool.m_DCode    = last_D_code + 1;
+    new_tool.m_DCode    = m_apertures.empty() ? FIRST_DCODE_VALUE : m_apertures.back().m_DCode + 1;
     new_tool.m_ApertureAttribute = aApertureAttribute;
 
     m_apertures.push_back( new_tool );
+    m_apertureIndex.emplace( key, m_apertures.size() - 1 );
 
     return m_apertures.size() - 1;
 }
@@ -26,6 +26,7 @@
 
 #pragma once
 
+#include <unordered_map>
 #include <vector>
 #include <math/box2.h>
 #include <eda_item.h>       // FILL_T
@@ -341,6 +342,10 @@ protected:
     // The last aperture attribute generated (only one aperture attribute can be set)
     int           m_apertureAttribute;
 
+    // The header, up to the aperture list, is written in finalFile.
+    // The body is written in workFile (a temporary file) because it must be written after
+    // the aperture list, which is known only at the end of the plot: EndPlot() writes the
+    // aperture list in finalFile, and appends the body to it.
     FILE* workFile;
     FILE* finalFile;
     wxString m_workFilename;
@@ -350,8 +355,27 @@ protected:
      */
     void writeApertureList();
 
+    /**
+     * @return the key of the aperture dictionary for an aperture, and for
+     * GetOrCreateAperture( const wxSize&, ... )
+     */
+    static size_t apertureKey( const wxSize& aSize, int aRadius, double aRotDegree,
+                               APERTURE::APERTURE_TYPE aType, int aApertureAttribute );
+
+    /**
+     * @return the key of the aperture dictionary for an aperture, and for
+     * GetOrCreateAperture( const std::vector<wxPoint>&, ... )
+     */
+    static size_t apertureKey( const std::vector<wxPoint>& aCorners,
+                               APERTURE::APERTURE_TYPE aType, int aApertureAttribute );
+
     std::vector<APERTURE> m_apertures;  // The list of available apertures
     int     m_currentApertureIdx;       // The index of the current aperture in m_apertures
+
+    // The aperture dictionary: the indexes in m_apertures of the apertures,
+    // from their apertureKey()
+    std::unordered_multimap<size_t, int> m_apertureIndex;
+
     bool    m_hasApertureRoundRect;     // true is at least one round rect aperture is in use
     bool    m_hasApertureRotOval;       // true is at least one oval rotated aperture is in use
     bool    m_hasApertureRotRect;       // true is at least one rect. rotated aperture is in use
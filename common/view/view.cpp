@@ -41,6 +41,10 @@
 #include <profile.h>
 #endif /* __WXDEBUG__  */
 
+#include <atomic>
+#include <future>
+#include <thread>
+
 namespace KIGFX {
 
 class VIEW;
@@ -92,26 +96,32 @@ private:
     int     m_drawPriority;     ///< Order to draw this item in a layer, lowest first
 
     ///> Helper for storing cached items group ids
-    typedef std::pair<int, int> GroupPair;
+    struct GroupEntry
+    {
+        int layer;          ///< Layer number
+        int detailLevel;    ///< Level of detail the group was drawn at
+        int group;          ///< GAL group id
+    };
 
-    ///> Indexes of cached GAL display lists corresponding to the item (for every layer it occupies).
-    ///> (in the std::pair "first" stores layer number, "second" stores group id).
-    GroupPair* m_groups;
-    int        m_groupsSize;
+    ///> Indexes of cached GAL display lists corresponding to the item (for every layer it occupies
+    ///> and every level of detail it was drawn at).
+    GroupEntry* m_groups;
+    int         m_groupsSize;
 
     /**
      * Function getGroup()
      * Returns number of the group id for the given layer, or -1 in case it was not cached before.
      *
      * @param aLayer is the layer number for which group id is queried.
+     * @param aDetailLevel is the level of detail for which group id is queried.
      * @return group id or -1 in case there is no group id (ie. item is not cached).
      */
-    int getGroup( int aLayer ) const
+    int getGroup( int aLayer, int aDetailLevel ) const
     {
         for( int i = 0; i < m_groupsSize; ++i )
         {
-            if( m_groups[i].first == aLayer )
-                return m_groups[i].second;
+            if( m_groups[i].layer == aLayer && m_groups[i].detailLevel == aDetailLevel )
+                return m_groups[i].group;
         }
 
         return -1;
@@ -119,25 +129,26 @@ private:
 
     /**
      * Function setGroup()
-     * Sets a group id for the item and the layer combination.
+     * Sets a group id for the item, layer and level of detail combination.
      *
      * @param aLayer is the layer numbe.
+     * @param aDetailLevel is the level of detail.
      * @param aGroup is the group id.
      */
-    void setGroup( int aLayer, int aGroup )
+    void setGroup( int aLayer, int aDetailLevel, int aGroup )
     {
         // Look if there is already an entry for the layer
         for( int i = 0; i < m_groupsSize; ++i )
         {
-            if( m_groups[i].first == aLayer )
+            if( m_groups[i].layer == aLayer && m_groups[i].detailLevel == aDetailLevel )
             {
-                m_groups[i].second = aGroup;
+                m_groups[i].group = aGroup;
                 return;
             }
         }
 
         // If there was no entry for the given layer - create one
-        GroupPair* newGroups = new GroupPair[m_groupsSize + 1];
+        GroupEntry* newGroups = new GroupEntry[m_groupsSize + 1];
 
         if( m_groupsSize > 0 )
         {
@@ -146,7 +157,45 @@ private:
         }
 
         m_groups = newGroups;
-        newGroups[m_groupsSize++] = GroupPair( aLayer, aGroup );
+        newGroups[m_groupsSize++] = { aLayer, aDetailLevel, aGroup };
+    }
+
+
+    /**
+     * Function forEachGroup()
+     * Calls a function for the group ids cached for a layer, at every level of detail.
+     *
+     * @param aLayer is the layer number.
+     * @param aFunc is called with every valid group id.
+     */
+    template <typename Func>
+    void forEachGroup( int aLayer, Func aFunc ) const
+    {
+        for( int i = 0; i < m_groupsSize; ++i )
+        {
+            if( m_groups[i].layer == aLayer && m_groups[i].group >= 0 )
+                aFunc( m_groups[i].group );
+        }
+    }
+
+
+    /**
+     * Function deleteLayerGroups()
+     * Removes the groups cached for a layer at every level of detail from the GAL.
+     *
+     * @param aLayer is the layer number.
+     * @param aGal is the GAL storing the groups.
+     */
+    void deleteLayerGroups( int aLayer, GAL* aGal )
+    {
+        for( int i = 0; i < m_groupsSize; ++i )
+        {
+            if( m_groups[i].layer == aLayer && m_groups[i].group >= 0 )
+            {
+                aGal->DeleteGroup( m_groups[i].group );
+                m_groups[i].group = -1;
+            }
+        }
     }
 
 
@@ -184,7 +233,7 @@ private:
     {
         for( int i = 0; i < m_groupsSize; ++i )
         {
-            int orig_layer = m_groups[i].first;
+            int orig_layer = m_groups[i].layer;
             int new_layer = orig_layer;
 
             try
@@ -193,7 +242,7 @@ private:
             }
             catch( const std::out_of_range& ) {}
 
-            m_groups[i].first = new_layer;
+            m_groups[i].layer = new_layer;
         }
     }
 
@@ -271,6 +320,8 @@ VIEW::VIEW( bool aIsDynamic ) :
     m_minScale( 0.2 ), m_maxScale( 25000.0 ),
     m_mirrorX( false ), m_mirrorY( false ),
     m_painter( NULL ),
+    m_detailLevel( 0 ),
+    m_detailLevelAreaLevel( -1 ),
     m_gal( NULL ),
     m_dynamic( aIsDynamic ),
     m_useDrawPriority( false ),
@@ -383,10 +434,7 @@ void VIEW::Remove( VIEW_ITEM* aItem )
         MarkTargetDirty( l.target );
 
         // Clear the GAL cache
-        int prevGroup = viewData->getGroup( layers[i] );
-
-        if( prevGroup >= 0 )
-            m_gal->DeleteGroup( prevGroup );
+        viewData->deleteLayerGroups( layers[i], m_gal );
     }
 
     viewData->deleteGroups();
@@ -573,6 +621,8 @@ void VIEW::SetScale( double aScale, VECTOR2D aAnchor )
     m_gal->SetZoomFactor( m_scale );
     m_gal->ComputeWorldScreenMatrix();
 
+    updateDetailLevel();
+
     VECTOR2D delta = ToWorld( a ) - aAnchor;
 
     SetCenter( m_center - delta );
@@ -582,6 +632,55 @@ void VIEW::SetScale( double aScale, VECTOR2D aAnchor )
 }
 
 
+void VIEW::updateDetailLevel()
+{
+    int detailLevel = m_painter ? m_painter->GetDetailLevel() : 0;
+
+    if( detailLevel == m_detailLevel )
+        return;
+
+    // Groups of the other levels are kept, so zooming back and forth does not recache
+    // anything.  The items that were never drawn at this level are cached by UpdateItems()
+    // once they are visible, see updateVisibleDetailLevel().
+    m_detailLevel = detailLevel;
+}
+
+
+void VIEW::updateVisibleDetailLevel()
+{
+    BOX2I area = visibleArea();
+
+    if( m_detailLevelAreaLevel == m_detailLevel && m_detailLevelArea.Contains( area ) )
+        return;
+
+    m_detailLevelArea = area;
+    m_detailLevelAreaLevel = m_detailLevel;
+
+    for( VIEW_LAYER* l : m_orderedLayers )
+    {
+        if( !l->visible || !IsCached( l->id ) )
+            continue;
+
+        int  layer = l->id;
+        auto visitor =
+                [&]( VIEW_ITEM* aItem ) -> bool
+                {
+                    auto viewData = aItem->viewPrivData();
+
+                    if( viewData && viewData->storesGroups()
+                            && viewData->getGroup( layer, m_detailLevel ) < 0 )
+                    {
+                        viewData->m_requiredUpdate |= DETAIL_LEVEL;
+                    }
+
+                    return true;
+                };
+
+        l->items->Query( area, visitor );
+    }
+}
+
+
 void VIEW::SetCenter( const VECTOR2D& aCenter )
 {
     m_center = aCenter;
@@ -738,10 +837,12 @@ struct VIEW::updateItemsColor
     {
         // Obtain the color that should be used for coloring the item
         const COLOR4D color = painter->GetSettings()->GetColor( aItem, layer );
-        int group = aItem->viewPrivData()->getGroup( layer );
 
-        if( group >= 0 )
-            gal->ChangeGroupColor( group, color );
+        aItem->viewPrivData()->forEachGroup( layer,
+                [&]( int aGroup )
+                {
+                    gal->ChangeGroupColor( aGroup, color );
+                } );
 
         return true;
     }
@@ -792,10 +893,12 @@ void VIEW::UpdateAllLayersColor()
             for( int i = 0; i < layers_count; ++i )
             {
                 const COLOR4D color = m_painter->GetSettings()->GetColor( item, layers[i] );
-                int group = viewData->getGroup( layers[i] );
 
-                if( group >= 0 )
-                    m_gal->ChangeGroupColor( group, color );
+                viewData->forEachGroup( layers[i],
+                        [&]( int aGroup )
+                        {
+                            m_gal->ChangeGroupColor( aGroup, color );
+                        } );
             }
         }
     }
@@ -813,10 +916,11 @@ struct VIEW::changeItemsDepth
 
     bool operator()( VIEW_ITEM* aItem )
     {
-        int group = aItem->viewPrivData()->getGroup( layer );
-
-        if( group >= 0 )
-            gal->ChangeGroupDepth( group, depth );
+        aItem->viewPrivData()->forEachGroup( layer,
+                [&]( int aGroup )
+                {
+                    gal->ChangeGroupDepth( aGroup, depth );
+                } );
 
         return true;
     }
@@ -922,10 +1026,13 @@ void VIEW::UpdateAllLayersOrder()
 
             for( int i = 0; i < layers_count; ++i )
             {
-                int group = viewData->getGroup( layers[i] );
+                int depth = m_layers[layers[i]].renderingOrder;
 
-                if( group >= 0 )
-                    m_gal->ChangeGroupDepth( group, m_layers[layers[i]].renderingOrder );
+                viewData->forEachGroup( layers[i],
+                        [&]( int aGroup )
+                        {
+                            m_gal->ChangeGroupDepth( aGroup, depth );
+                        } );
             }
         }
     }
@@ -1014,10 +1121,12 @@ void VIEW::draw( VIEW_ITEM* aItem, int aLayer, bool aImmediate )
     if( IsCached( aLayer ) && !aImmediate )
     {
         // Draw using cached information or create one
-        int group = viewData->getGroup( aLayer );
+        int group = viewData->getGroup( aLayer, m_detailLevel );
 
         if( group >= 0 )
             m_gal->DrawGroup( group );
+        else if( viewData->storesGroups() )
+            Update( aItem, DETAIL_LEVEL );
         else
             Update( aItem );
     }
@@ -1068,13 +1177,8 @@ struct VIEW::recacheItem
         if( !viewData )
             return false;
 
-        // Remove previously cached group
-        int group = viewData->getGroup( layer );
-
-        if( group >= 0 )
-            gal->DeleteGroup( group );
-
-        viewData->setGroup( layer, -1 );
+        // Remove previously cached groups
+        viewData->deleteLayerGroups( layer, gal );
         view->Update( aItem );
 
         return true;
@@ -1120,12 +1224,8 @@ void VIEW::ClearTargets()
 }
 
 
-void VIEW::Redraw()
+BOX2I VIEW::visibleArea() const
 {
-#ifdef __WXDEBUG__
-    PROF_COUNTER totalRealTime;
-#endif /* __WXDEBUG__ */
-
     VECTOR2D screenSize = m_gal->GetScreenPixelSize();
     BOX2D    rect( ToWorld( VECTOR2D( 0, 0 ) ),
                    ToWorld( screenSize ) - ToWorld( VECTOR2D( 0, 0 ) ) );
@@ -1139,7 +1239,17 @@ void VIEW::Redraw()
             rect.GetHeight() > std::numeric_limits<int>::max() )
         recti.SetMaximum();
 
-    redrawRect( recti );
+    return recti;
+}
+
+
+void VIEW::Redraw()
+{
+#ifdef __WXDEBUG__
+    PROF_COUNTER totalRealTime;
+#endif /* __WXDEBUG__ */
+
+    redrawRect( visibleArea() );
     // All targets were redrawn, so nothing is dirty
     markTargetClean( TARGET_CACHED );
     markTargetClean( TARGET_NONCACHED );
@@ -1219,10 +1329,22 @@ void VIEW::invalidateItem( VIEW_ITEM* aItem, int aUpdateFlags )
 
         if( IsCached( layerId ) )
         {
+            bool missingLevel = ( aUpdateFlags & DETAIL_LEVEL )
+                                && aItem->viewPrivData()->getGroup( layerId, m_detailLevel ) < 0;
+
             if( aUpdateFlags & ( GEOMETRY | LAYERS | REPAINT ) )
+            {
                 updateItemGeometry( aItem, layerId );
+            }
+            else if( missingLevel )
+            {
+                // Groups kept for the other levels of detail are stale after a color change
+                updateItemGeometry( aItem, layerId, !( aUpdateFlags & COLOR ) );
+            }
             else if( aUpdateFlags & COLOR )
+            {
                 updateItemColor( aItem, layerId );
+            }
         }
 
         // Mark those layers as dirty, so the VIEW will be refreshed
@@ -1259,15 +1381,17 @@ void VIEW::updateItemColor( VIEW_ITEM* aItem, int aLayer )
 
     // Obtain the color that should be used for coloring the item on the specific layerId
     const COLOR4D color = m_painter->GetSettings()->GetColor( aItem, aLayer );
-    int group = viewData->getGroup( aLayer );
 
     // Change the color, only if it has group assigned
-    if( group >= 0 )
-        m_gal->ChangeGroupColor( group, color );
+    viewData->forEachGroup( aLayer,
+            [&]( int aGroup )
+            {
+                m_gal->ChangeGroupColor( aGroup, color );
+            } );
 }
 
 
-void VIEW::updateItemGeometry( VIEW_ITEM* aItem, int aLayer )
+void VIEW::updateItemGeometry( VIEW_ITEM* aItem, int aLayer, bool aKeepOtherLevels )
 {
     auto viewData = aItem->viewPrivData();
     wxCHECK( (unsigned) aLayer < m_layers.size(), /*void*/ );
@@ -1282,13 +1406,21 @@ void VIEW::updateItemGeometry( VIEW_ITEM* aItem, int aLayer )
     m_gal->SetLayerDepth( l.renderingOrder );
 
     // Redraw the item from scratch
-    int group = viewData->getGroup( aLayer );
+    if( aKeepOtherLevels )
+    {
+        int group = viewData->getGroup( aLayer, m_detailLevel );
 
-    if( group >= 0 )
-        m_gal->DeleteGroup( group );
+        if( group >= 0 )
+            m_gal->DeleteGroup( group );
+    }
+    else
+    {
+        // Groups drawn at other levels of detail are outdated as well
+        viewData->deleteLayerGroups( aLayer, m_gal );
+    }
 
-    group = m_gal->BeginGroup();
-    viewData->setGroup( aLayer, group );
+    int group = m_gal->BeginGroup();
+    viewData->setGroup( aLayer, m_detailLevel, group );
 
     if( !m_painter->Draw( static_cast<EDA_ITEM*>( aItem ), aLayer ) )
         aItem->ViewDraw( aLayer, this ); // Alternative drawing method
@@ -1333,13 +1465,7 @@ void VIEW::updateLayers( VIEW_ITEM* aItem )
         if( IsCached( l.id ) )
         {
             // Redraw the item from scratch
-            int prevGroup = viewData->getGroup( layers[i] );
-
-            if( prevGroup >= 0 )
-            {
-                m_gal->DeleteGroup( prevGroup );
-                viewData->setGroup( l.id, -1 );
-            }
+            viewData->deleteLayerGroups( l.id, m_gal );
         }
     }
 
@@ -1380,6 +1506,8 @@ void VIEW::RecacheAllItems()
 
     r.SetMaximum();
 
+    // The items are only flagged here: they are prepared in parallel and drawn again by the
+    // next UpdateItems()
     for( const VIEW_LAYER& l : m_layers )
     {
         if( IsCached( l.id ) )
@@ -1395,6 +1523,23 @@ void VIEW::UpdateItems()
 {
     if( m_gal->IsVisible() )
     {
+        const int redrawFlags = GEOMETRY | LAYERS | REPAINT | INITIAL_ADD | DETAIL_LEVEL;
+        std::vector<VIEW_ITEM*> dirtyItems;
+
+        updateVisibleDetailLevel();
+
+        for( VIEW_ITEM* item : *m_allItems )
+        {
+            auto viewData = item->viewPrivData();
+
+            if( viewData && ( viewData->m_requiredUpdate & redrawFlags ) )
+                dirtyItems.push_back( item );
+        }
+
+        // Compute the expensive geometry in parallel first, the GAL is then fed
+        // from the main thread only
+        prepareItems( dirtyItems );
+
         GAL_UPDATE_CONTEXT ctx( m_gal );
 
         for( VIEW_ITEM* item : *m_allItems )
@@ -1414,6 +1559,42 @@ void VIEW::UpdateItems()
 }
 
 
+void VIEW::prepareItems( const std::vector<VIEW_ITEM*>& aItems )
+{
+    if( !m_painter )
+        return;
+
+    // We don't want to spin up new threads for a handful of items (overhead costs)
+    size_t parallelThreadCount = std::min<size_t>( std::thread::hardware_concurrency(),
+            ( aItems.size() + 255 ) / 256 );
+
+    std::atomic<size_t> nextItem( 0 );
+    std::vector<std::future<size_t>> returns( parallelThreadCount );
+
+    auto prepare_lambda = [&nextItem, &aItems, this]() -> size_t
+    {
+        for( size_t i = nextItem++; i < aItems.size(); i = nextItem++ )
+            m_painter->Prepare( aItems[i] );
+
+        return 1;
+    };
+
+    if( parallelThreadCount <= 1 )
+    {
+        prepare_lambda();
+    }
+    else
+    {
+        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+            returns[ii] = std::async( std::launch::async, prepare_lambda );
+
+        // Finalize the threads
+        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+            returns[ii].wait();
+    }
+}
+
+
 void VIEW::UpdateAllItems( int aUpdateFlags )
 {
     for( VIEW_ITEM* item : *m_allItems )
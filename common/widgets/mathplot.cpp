@@ -39,9 +39,11 @@
 #include <wx/image.h>
 #include <wx/tipwin.h>
 
+#include <algorithm>
 #include <cmath>
 #include <cstdio>   // used only for debug
 #include <ctime>    // used for representation of x axes involving date
+#include <numeric>
 #include <set>
 
 // Memory leak debugging
@@ -3198,6 +3200,8 @@ mpFXYVector::mpFXYVector( const wxString& name, int flags ) : mpFXY( name, flags
     m_minY  = -1;
     m_maxY  = 1;
     m_type  = mpLAYER_PLOT;
+    m_sortedX = true;
+    m_usePlotIndices = false;
 }
 
 
@@ -3266,6 +3270,17 @@ size_t mpFXYVector::GetCount()
 
 bool mpFXYVector::GetNextXY( double& x, double& y )
 {
+    if( m_usePlotIndices )
+    {
+        if( m_index >= m_plotIndices.size() )
+            return false;
+
+        size_t ii = m_plotIndices[m_index++];
+        x = m_xs[ii];
+        y = m_ys[ii];
+        return true;
+    }
+
     if( m_index >= m_xs.size() )
     {
         return false;
@@ -3283,6 +3298,9 @@ void mpFXYVector::Clear()
 {
     m_xs.clear();
     m_ys.clear();
+    m_minIndex.clear();
+    m_maxIndex.clear();
+    m_sortedX = true;
 }
 
 
@@ -3296,6 +3314,11 @@ void mpFXYVector::SetData( const std::vector<double>& xs, const std::vector<doub
     m_xs    = xs;
     m_ys    = ys;
 
+    m_sortedX = std::is_sorted( m_xs.begin(), m_xs.end() );
+    m_minIndex.clear();
+    m_maxIndex.clear();
+    updatePyramid();
+
     // Update internal variables for the bounding box.
     if( xs.size()>0 )
     {
@@ -3334,6 +3357,171 @@ void mpFXYVector::SetData( const std::vector<double>& xs, const std::vector<doub
 }
 
 
+void mpFXYVector::AppendData( const std::vector<double>& xs, const std::vector<double>& ys )
+{
+    if( xs.size() != ys.size() || xs.empty() )
+        return;
+
+    if( m_xs.empty() )
+    {
+        SetData( xs, ys );
+        return;
+    }
+
+    m_sortedX = m_sortedX && xs.front() >= m_xs.back() && std::is_sorted( xs.begin(), xs.end() );
+
+    m_xs.insert( m_xs.end(), xs.begin(), xs.end() );
+    m_ys.insert( m_ys.end(), ys.begin(), ys.end() );
+
+    if( m_sortedX )
+    {
+        updatePyramid();
+    }
+    else
+    {
+        m_minIndex.clear();
+        m_maxIndex.clear();
+    }
+
+    m_minX = std::min( m_minX, *std::min_element( xs.begin(), xs.end() ) );
+    m_maxX = std::max( m_maxX, *std::max_element( xs.begin(), xs.end() ) );
+    m_minY = std::min( m_minY, *std::min_element( ys.begin(), ys.end() ) );
+    m_maxY = std::max( m_maxY, *std::max_element( ys.begin(), ys.end() ) );
+}
+
+
+void mpFXYVector::updatePyramid()
+{
+    // The pyramid is only used to plot the visible range of sorted data
+    if( !m_sortedX )
+        return;
+
+    // Each level is extended with the blocks completed since the last update, from the
+    // blocks of the previous level
+    for( size_t level = 1; ( m_ys.size() >> level ) > 0; ++level )
+    {
+        if( m_minIndex.size() < level )
+        {
+            m_minIndex.emplace_back();
+            m_maxIndex.emplace_back();
+        }
+
+        std::vector<size_t>& minIndex = m_minIndex[level - 1];
+        std::vector<size_t>& maxIndex = m_maxIndex[level - 1];
+        size_t               blocks = m_ys.size() >> level;
+
+        for( size_t ii = minIndex.size(); ii < blocks; ++ii )
+        {
+            size_t minA = 2 * ii, minB = 2 * ii + 1;
+            size_t maxA = minA, maxB = minB;
+
+            if( level > 1 )
+            {
+                minA = m_minIndex[level - 2][2 * ii];
+                minB = m_minIndex[level - 2][2 * ii + 1];
+                maxA = m_maxIndex[level - 2][2 * ii];
+                maxB = m_maxIndex[level - 2][2 * ii + 1];
+            }
+
+            minIndex.push_back( m_ys[minB] < m_ys[minA] ? minB : minA );
+            maxIndex.push_back( m_ys[maxB] > m_ys[maxA] ? maxB : maxA );
+        }
+    }
+}
+
+
+void mpFXYVector::GetPlotIndices( double aMinX, double aMaxX, int aPixels,
+                                  std::vector<size_t>& aIndices ) const
+{
+    const size_t count = m_xs.size();
+
+    aIndices.clear();
+
+    if( count == 0 )
+        return;
+
+    if( !m_sortedX )
+    {
+        aIndices.resize( count );
+        std::iota( aIndices.begin(), aIndices.end(), 0 );
+        return;
+    }
+
+    if( aMinX > aMaxX )
+        std::swap( aMinX, aMaxX );
+
+    // The points in the range, and one more on each side for the lines crossing its ends
+    size_t first = std::lower_bound( m_xs.begin(), m_xs.end(), aMinX ) - m_xs.begin();
+    size_t last = std::upper_bound( m_xs.begin(), m_xs.end(), aMaxX ) - m_xs.begin();
+
+    first = first > 0 ? first - 1 : 0;
+    last = std::min( last, count - 1 );
+
+    // The largest blocks of at most half a pixel on average
+    size_t level = 0;
+
+    while( aPixels > 0 && level < m_minIndex.size()
+            && ( size_t( 4 ) << level ) * aPixels <= last - first + 1 )
+    {
+        ++level;
+    }
+
+    for( size_t ii = first; ii <= last; )
+    {
+        // The largest block starting at ii and ending at the latest at last
+        size_t blockLevel = level;
+
+        while( blockLevel > 0
+                && ( ( ii & ( ( size_t( 1 ) << blockLevel ) - 1 ) ) != 0
+                     || ii + ( size_t( 1 ) << blockLevel ) - 1 > last ) )
+        {
+            --blockLevel;
+        }
+
+        if( blockLevel == 0 )
+        {
+            aIndices.push_back( ii++ );
+            continue;
+        }
+
+        size_t end = ii + ( size_t( 1 ) << blockLevel ) - 1;
+        size_t minIdx = m_minIndex[blockLevel - 1][ii >> blockLevel];
+        size_t maxIdx = m_maxIndex[blockLevel - 1][ii >> blockLevel];
+
+        aIndices.push_back( ii );
+
+        for( size_t idx : { std::min( minIdx, maxIdx ), std::max( minIdx, maxIdx ), end } )
+        {
+            if( idx != aIndices.back() )
+                aIndices.push_back( idx );
+        }
+
+        ii = end + 1;
+    }
+}
+
+
+void mpFXYVector::Plot( wxDC& dc, mpWindow& w )
+{
+    if( !m_visible || m_xs.empty() )
+    {
+        mpFXY::Plot( dc, w );
+        return;
+    }
+
+    wxCoord startPx = m_drawOutsideMargins ? 0 : w.GetMarginLeft();
+    wxCoord endPx   = m_drawOutsideMargins ? w.GetScrX() : w.GetScrX() - w.GetMarginRight();
+
+    // Points are drawn one by one, so only a continuous plot can be decimated
+    GetPlotIndices( s2x( w.p2x( startPx ) ), s2x( w.p2x( endPx ) ),
+                    m_continuous ? endPx - startPx + 1 : 0, m_plotIndices );
+
+    m_usePlotIndices = true;
+    mpFXY::Plot( dc, w );
+    m_usePlotIndices = false;
+}
+
+
 // -----------------------------------------------------------------------------
 // mpText - provided by Val Greene
 // -----------------------------------------------------------------------------
@@ -19,8 +19,10 @@
  */
 
 #include <list>
+#include <set>
 #include <thread>
 #include <algorithm>
+#include <functional>
 #include <future>
 #include <vector>
 #include <unordered_map>
@@ -367,6 +369,19 @@ bool CONNECTION_GRAPH::m_allowRealTime = true;
 
 
 void CONNECTION_GRAPH::Reset()
+{
+    resetSubgraphs();
+
+    m_sheetList.clear();
+    m_sheetScreens.clear();
+    m_net_name_to_code_map.clear();
+    m_bus_name_to_code_map.clear();
+    m_last_net_code = 1;
+    m_last_bus_code = 1;
+}
+
+
+void CONNECTION_GRAPH::resetSubgraphs()
 {
     for( auto& subgraph : m_subgraphs )
         delete subgraph;
@@ -377,15 +392,11 @@ void CONNECTION_GRAPH::Reset()
     m_sheet_to_subgraphs_map.clear();
     m_invisible_power_pins.clear();
     m_bus_alias_cache.clear();
-    m_net_name_to_code_map.clear();
-    m_bus_name_to_code_map.clear();
     m_net_code_to_subgraphs_map.clear();
     m_net_name_to_subgraphs_map.clear();
     m_item_to_subgraph_map.clear();
     m_local_label_cache.clear();
     m_global_label_cache.clear();
-    m_last_net_code = 1;
-    m_last_bus_code = 1;
     m_last_subgraph_code = 1;
 }
 
@@ -394,12 +405,61 @@ void CONNECTION_GRAPH::Recalculate( const SCH_SHEET_LIST& aSheetList, bool aUnco
 {
     PROF_COUNTER recalc_time( "CONNECTION_GRAPH::Recalculate" );
 
+    // The connected items of an unchanged sheet can only be reused if it is still in the
+    // same place in the same hierarchy
+    if( aSheetList.size() != m_sheetList.size() )
+        aUnconditional = true;
+
+    // Find the screens to update before updating any sheet: a screen used by several sheets
+    // must be updated for all of them, but its items are cleaned by the first update.
+    std::set<SCH_SCREEN*> dirty_screens;
+
+    for( size_t ii = 0; !aUnconditional && ii < aSheetList.size(); ++ii )
+    {
+        if( aSheetList[ii] != m_sheetList[ii] )
+        {
+            aUnconditional = true;
+        }
+        else if( aSheetList[ii].LastScreen() != m_sheetScreens[ii] )
+        {
+            // A sheet pointed to another file keeps its path, but the items of the new
+            // screen were never connected for it
+            dirty_screens.insert( aSheetList[ii].LastScreen() );
+        }
+    }
+
+    for( const SCH_SHEET_PATH& sheet : aSheetList )
+    {
+        SCH_SCREEN* screen = sheet.LastScreen();
+
+        if( aUnconditional || screen->IsConnectivityDirty() )
+        {
+            dirty_screens.insert( screen );
+            continue;
+        }
+
+        for( SCH_ITEM* item : screen->Items() )
+        {
+            if( item->IsConnectable() && item->IsConnectivityDirty() )
+            {
+                dirty_screens.insert( screen );
+                break;
+            }
+        }
+    }
+
     if( aUnconditional )
         Reset();
+    else
+        resetSubgraphs();
 
     PROF_COUNTER update_items( "updateItemConnectivity" );
 
     m_sheetList = aSheetList;
+    m_sheetScreens.clear();
+
+    for( const SCH_SHEET_PATH& sheet : aSheetList )
+        m_sheetScreens.push_back( sheet.LastScreen() );
 
     for( const SCH_SHEET_PATH& sheet : aSheetList )
     {
@@ -407,18 +467,31 @@ void CONNECTION_GRAPH::Recalculate( const SCH_SHEET_LIST& aSheetList, bool aUnco
 
         for( SCH_ITEM* item : sheet.LastScreen()->Items() )
         {
-            if( item->IsConnectable() && ( aUnconditional || item->IsConnectivityDirty() ) )
+            if( item->IsConnectable() )
                 items.push_back( item );
         }
 
         m_items.reserve( m_items.size() + items.size() );
 
-        updateItemConnectivity( sheet, items );
+        if( dirty_screens.count( sheet.LastScreen() ) )
+        {
+            updateItemConnectivity( sheet, items );
 
-        // UpdateDanglingState() also adds connected items for SCH_TEXT
-        sheet.LastScreen()->TestDanglingEnds( &sheet );
+            // UpdateDanglingState() also adds connected items for SCH_TEXT
+            sheet.LastScreen()->TestDanglingEnds( &sheet );
+        }
+        else
+        {
+            reuseItemConnectivity( sheet, items );
+        }
     }
 
+    for( SCH_SCREEN* screen : dirty_screens )
+        screen->SetConnectivityDirty( false );
+
+    wxLogTrace( ConnProfileMask, "Connectivity of %lu screens updated, %lu sheets in total",
+                (unsigned long) dirty_screens.size(), (unsigned long) aSheetList.size() );
+
     if( wxLog::IsAllowedTraceMask( ConnProfileMask ) )
         update_items.Show();
 
@@ -651,6 +724,64 @@ void CONNECTION_GRAPH::updateItemConnectivity( const SCH_SHEET_PATH& aSheet,
 }
 
 
+void CONNECTION_GRAPH::reuseItemConnectivity( const SCH_SHEET_PATH& aSheet,
+                                              const std::vector<SCH_ITEM*>& aItemList )
+{
+    for( SCH_ITEM* item : aItemList )
+    {
+        if( item->Type() == SCH_SHEET_T )
+        {
+            for( SCH_SHEET_PIN* pin : static_cast<SCH_SHEET*>( item )->GetPins() )
+            {
+                pin->InitializeConnection( aSheet, this );
+                m_items.emplace_back( pin );
+            }
+        }
+        else if( item->Type() == SCH_COMPONENT_T )
+        {
+            SCH_COMPONENT* component = static_cast<SCH_COMPONENT*>( item );
+
+            for( SCH_PIN* pin : component->GetPins( &aSheet ) )
+            {
+                pin->InitializeConnection( aSheet, this );
+
+                if( pin->IsPowerConnection() && !pin->IsVisible() )
+                    m_invisible_power_pins.emplace_back( std::make_pair( aSheet, pin ) );
+
+                m_items.emplace_back( pin );
+            }
+        }
+        else
+        {
+            m_items.emplace_back( item );
+            auto conn = item->InitializeConnection( aSheet, this );
+
+            // The links between bus entries and buses are still valid, only the
+            // bus/net property must be set again
+            switch( item->Type() )
+            {
+            case SCH_LINE_T:
+                conn->SetType( item->GetLayer() == LAYER_BUS ? CONNECTION_TYPE::BUS :
+                                                               CONNECTION_TYPE::NET );
+                break;
+
+            case SCH_BUS_BUS_ENTRY_T:
+                conn->SetType( CONNECTION_TYPE::BUS );
+                break;
+
+            case SCH_PIN_T:
+            case SCH_BUS_WIRE_ENTRY_T:
+                conn->SetType( CONNECTION_TYPE::NET );
+                break;
+
+            default:
+                break;
+            }
+        }
+    }
+}
+
+
 // TODO(JE) This won't give the same subgraph IDs (and eventually net/graph codes)
 // to the same subgraph necessarily if it runs over and over again on the same
 // sheet.  We need:
@@ -2040,50 +2171,118 @@ int CONNECTION_GRAPH::RunERC()
 
     ERC_SETTINGS& settings = m_schematic->ErcSettings();
 
-    for( auto&& subgraph : m_subgraphs )
-    {
-        // Graph is supposed to be up-to-date before calling RunERC()
+    // Graph is supposed to be up-to-date before calling RunERC()
+    for( CONNECTION_SUBGRAPH* subgraph : m_subgraphs )
         wxASSERT( !subgraph->m_dirty );
 
-        /**
-         * NOTE:
-         *
-         * We could check that labels attached to bus subgraphs follow the
-         * proper format (i.e. actually define a bus).
-         *
-         * This check doesn't need to be here right now because labels
-         * won't actually be connected to bus wires if they aren't in the right
-         * format due to their TestDanglingEnds() implementation.
-         */
+    // The subgraphs are checked on several threads.  A check may read other subgraphs (the
+    // hierarchical parent for instance), so all the drivers are resolved before the checks
+    // start.  The markers are collected per subgraph and added to the screens afterwards, in
+    // the order of the subgraphs, so that the results don't depend on the thread scheduling.
+    std::vector<std::vector<SCH_MARKER*>> markers( m_subgraphs.size() );
+    std::vector<int>                      errors( m_subgraphs.size(), 0 );
 
-        if( settings.IsTestEnabled( ERCE_DRIVER_CONFLICT ) && !subgraph->ResolveDrivers() )
-            error_count++;
+    // We don't want to spin up a new thread for fewer than 4 subgraphs (overhead costs)
+    size_t parallelThreadCount = std::max<size_t>( 1,
+            std::min<size_t>( std::thread::hardware_concurrency(),
+                              ( m_subgraphs.size() + 3 ) / 4 ) );
 
-        if( settings.IsTestEnabled( ERCE_BUS_TO_NET_CONFLICT )
-                && !ercCheckBusToNetConflicts( subgraph ) )
-            error_count++;
+    auto run_parallel =
+            [&]( const std::function<void( size_t )>& aCheck )
+            {
+                std::atomic<size_t> nextSubgraph( 0 );
+                std::vector<std::future<size_t>> returns( parallelThreadCount );
 
-        if( settings.IsTestEnabled( ERCE_BUS_ENTRY_CONFLICT )
-                && !ercCheckBusToBusEntryConflicts( subgraph ) )
-            error_count++;
+                auto check_lambda =
+                        [&]() -> size_t
+                        {
+                            for( size_t ii = nextSubgraph++; ii < m_subgraphs.size();
+                                 ii = nextSubgraph++ )
+                            {
+                                aCheck( ii );
+                            }
 
-        if( settings.IsTestEnabled( ERCE_BUS_TO_BUS_CONFLICT )
-                && !ercCheckBusToBusConflicts( subgraph ) )
-            error_count++;
+                            return 1;
+                        };
 
-        if( settings.IsTestEnabled( ERCE_WIRE_DANGLING )
-            && !ercCheckFloatingWires( subgraph ) )
-            error_count++;
+                if( parallelThreadCount == 1 )
+                {
+                    check_lambda();
+                }
+                else
+                {
+                    for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+                        returns[ii] = std::async( std::launch::async, check_lambda );
 
-        // The following checks are always performed since they don't currently
-        // have an option exposed to the user
+                    // Finalize the threads
+                    for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+                        returns[ii].wait();
+                }
+            };
 
-        if( !ercCheckNoConnects( subgraph ) )
-            error_count++;
+    if( settings.IsTestEnabled( ERCE_DRIVER_CONFLICT ) )
+    {
+        run_parallel(
+                [&]( size_t ii )
+                {
+                    if( !m_subgraphs[ii]->ResolveDrivers() )
+                        errors[ii]++;
+                } );
+    }
+
+    run_parallel(
+            [&]( size_t ii )
+            {
+                CONNECTION_SUBGRAPH*      subgraph = m_subgraphs[ii];
+                std::vector<SCH_MARKER*>& subgraphMarkers = markers[ii];
+
+                /**
+                 * NOTE:
+                 *
+                 * We could check that labels attached to bus subgraphs follow the
+                 * proper format (i.e. actually define a bus).
+                 *
+                 * This check doesn't need to be here right now because labels
+                 * won't actually be connected to bus wires if they aren't in the right
+                 * format due to their TestDanglingEnds() implementation.
+                 */
+
+                if( settings.IsTestEnabled( ERCE_BUS_TO_NET_CONFLICT )
+                        && !ercCheckBusToNetConflicts( subgraph, subgraphMarkers ) )
+                    errors[ii]++;
+
+                if( settings.IsTestEnabled( ERCE_BUS_ENTRY_CONFLICT )
+                        && !ercCheckBusToBusEntryConflicts( subgraph, subgraphMarkers ) )
+                    errors[ii]++;
+
+                if( settings.IsTestEnabled( ERCE_BUS_TO_BUS_CONFLICT )
+                        && !ercCheckBusToBusConflicts( subgraph, subgraphMarkers ) )
+                    errors[ii]++;
+
+                if( settings.IsTestEnabled( ERCE_WIRE_DANGLING )
+                    && !ercCheckFloatingWires( subgraph, subgraphMarkers ) )
+                    errors[ii]++;
+
+                // The following checks are always performed since they don't currently
+                // have an option exposed to the user
+
+                if( !ercCheckNoConnects( subgraph, subgraphMarkers ) )
+                    errors[ii]++;
+
+                if( ( settings.IsTestEnabled( ERCE_LABEL_NOT_CONNECTED )
+                        || settings.IsTestEnabled( ERCE_GLOBLABEL ) )
+                        && !ercCheckLabels( subgraph, subgraphMarkers ) )
+                    errors[ii]++;
+            } );
+
+    for( size_t ii = 0; ii < m_subgraphs.size(); ++ii )
+    {
+        SCH_SCREEN* screen = m_subgraphs[ii]->m_sheet.LastScreen();
+
+        for( SCH_MARKER* marker : markers[ii] )
+            screen->Append( marker );
 
-        if( ( settings.IsTestEnabled( ERCE_LABEL_NOT_CONNECTED )
-                || settings.IsTestEnabled( ERCE_GLOBLABEL ) ) && !ercCheckLabels( subgraph ) )
-            error_count++;
+        error_count += errors[ii];
     }
 
     // Hierarchical sheet checking is done at the schematic level
@@ -2094,11 +2293,9 @@ int CONNECTION_GRAPH::RunERC()
 }
 
 
-bool CONNECTION_GRAPH::ercCheckBusToNetConflicts( const CONNECTION_SUBGRAPH* aSubgraph )
+bool CONNECTION_GRAPH::ercCheckBusToNetConflicts( const CONNECTION_SUBGRAPH* aSubgraph,
+                                                  std::vector<SCH_MARKER*>& aMarkers )
 {
-    auto sheet = aSubgraph->m_sheet;
-    auto screen = sheet.LastScreen();
-
     SCH_ITEM* net_item = nullptr;
     SCH_ITEM* bus_item = nullptr;
     SCH_CONNECTION conn( this );
@@ -2141,7 +2338,7 @@ bool CONNECTION_GRAPH::ercCheckBusToNetConflicts( const CONNECTION_SUBGRAPH* aSu
         ercItem->SetItems( net_item, bus_item );
 
         SCH_MARKER* marker = new SCH_MARKER( ercItem, net_item->GetPosition() );
-        screen->Append( marker );
+        aMarkers.push_back( marker );
 
         return false;
     }
@@ -2150,11 +2347,11 @@ bool CONNECTION_GRAPH::ercCheckBusToNetConflicts( const CONNECTION_SUBGRAPH* aSu
 }
 
 
-bool CONNECTION_GRAPH::ercCheckBusToBusConflicts( const CONNECTION_SUBGRAPH* aSubgraph )
+bool CONNECTION_GRAPH::ercCheckBusToBusConflicts( const CONNECTION_SUBGRAPH* aSubgraph,
+                                                  std::vector<SCH_MARKER*>& aMarkers )
 {
     wxString msg;
     auto sheet = aSubgraph->m_sheet;
-    auto screen = sheet.LastScreen();
 
     SCH_ITEM* label = nullptr;
     SCH_ITEM* port = nullptr;
@@ -2209,7 +2406,7 @@ bool CONNECTION_GRAPH::ercCheckBusToBusConflicts( const CONNECTION_SUBGRAPH* aSu
             ercItem->SetItems( label, port );
 
             SCH_MARKER* marker = new SCH_MARKER( ercItem, label->GetPosition() );
-            screen->Append( marker );
+            aMarkers.push_back( marker );
 
             return false;
         }
@@ -2219,11 +2416,11 @@ bool CONNECTION_GRAPH::ercCheckBusToBusConflicts( const CONNECTION_SUBGRAPH* aSu
 }
 
 
-bool CONNECTION_GRAPH::ercCheckBusToBusEntryConflicts( const CONNECTION_SUBGRAPH* aSubgraph )
+bool CONNECTION_GRAPH::ercCheckBusToBusEntryConflicts( const CONNECTION_SUBGRAPH* aSubgraph,
+                                                       std::vector<SCH_MARKER*>& aMarkers )
 {
     bool conflict = false;
     auto sheet = aSubgraph->m_sheet;
-    auto screen = sheet.LastScreen();
 
     SCH_BUS_WIRE_ENTRY* bus_entry = nullptr;
     SCH_ITEM* bus_wire = nullptr;
@@ -2289,7 +2486,7 @@ bool CONNECTION_GRAPH::ercCheckBusToBusEntryConflicts( const CONNECTION_SUBGRAPH
         ercItem->SetItems( bus_entry, bus_wire );
 
         SCH_MARKER* marker = new SCH_MARKER( ercItem, bus_entry->GetPosition() );
-        screen->Append( marker );
+        aMarkers.push_back( marker );
 
         return false;
     }
@@ -2299,11 +2496,11 @@ bool CONNECTION_GRAPH::ercCheckBusToBusEntryConflicts( const CONNECTION_SUBGRAPH
 
 
 // TODO(JE) Check sheet pins here too?
-bool CONNECTION_GRAPH::ercCheckNoConnects( const CONNECTION_SUBGRAPH* aSubgraph )
+bool CONNECTION_GRAPH::ercCheckNoConnects( const CONNECTION_SUBGRAPH* aSubgraph,
+                                           std::vector<SCH_MARKER*>& aMarkers )
 {
     wxString msg;
     const SCH_SHEET_PATH& sheet  = aSubgraph->m_sheet;
-    SCH_SCREEN*           screen = sheet.LastScreen();
     bool                  ok     = true;
 
     if( aSubgraph->m_no_connect != nullptr )
@@ -2343,7 +2540,7 @@ bool CONNECTION_GRAPH::ercCheckNoConnects( const CONNECTION_SUBGRAPH* aSubgraph
             ercItem->SetItems( pin );
 
             SCH_MARKER* marker = new SCH_MARKER( ercItem, pin->GetTransformedPosition() );
-            screen->Append( marker );
+            aMarkers.push_back( marker );
 
             ok = false;
         }
@@ -2354,7 +2551,7 @@ bool CONNECTION_GRAPH::ercCheckNoConnects( const CONNECTION_SUBGRAPH* aSubgraph
             ercItem->SetItems( aSubgraph->m_no_connect );
 
             SCH_MARKER* marker = new SCH_MARKER( ercItem, aSubgraph->m_no_connect->GetPosition() );
-            screen->Append( marker );
+            aMarkers.push_back( marker );
 
             ok = false;
         }
@@ -2418,7 +2615,7 @@ bool CONNECTION_GRAPH::ercCheckNoConnects( const CONNECTION_SUBGRAPH* aSubgraph
             ercItem->SetItems( pin );
 
             SCH_MARKER* marker = new SCH_MARKER( ercItem, pin->GetTransformedPosition() );
-            screen->Append( marker );
+            aMarkers.push_back( marker );
 
             ok = false;
         }
@@ -2441,7 +2638,7 @@ bool CONNECTION_GRAPH::ercCheckNoConnects( const CONNECTION_SUBGRAPH* aSubgraph
 
                     SCH_MARKER* marker = new SCH_MARKER( ercItem,
                                                          testPin->GetTransformedPosition() );
-                    screen->Append( marker );
+                    aMarkers.push_back( marker );
 
                     ok = false;
                 }
@@ -2453,7 +2650,8 @@ bool CONNECTION_GRAPH::ercCheckNoConnects( const CONNECTION_SUBGRAPH* aSubgraph
 }
 
 
-bool CONNECTION_GRAPH::ercCheckFloatingWires( const CONNECTION_SUBGRAPH* aSubgraph )
+bool CONNECTION_GRAPH::ercCheckFloatingWires( const CONNECTION_SUBGRAPH* aSubgraph,
+                                              std::vector<SCH_MARKER*>& aMarkers )
 {
     if( aSubgraph->m_driver )
         return true;
@@ -2471,8 +2669,6 @@ bool CONNECTION_GRAPH::ercCheckFloatingWires( const CONNECTION_SUBGRAPH* aSubgra
 
     if( !wires.empty() )
     {
-        SCH_SCREEN* screen = aSubgraph->m_sheet.LastScreen();
-
         std::shared_ptr<ERC_ITEM> ercItem = ERC_ITEM::Create( ERCE_WIRE_DANGLING );
         ercItem->SetItems( wires[0],
                            wires.size() > 1 ? wires[1] : nullptr,
@@ -2480,7 +2676,7 @@ bool CONNECTION_GRAPH::ercCheckFloatingWires( const CONNECTION_SUBGRAPH* aSubgra
                            wires.size() > 3 ? wires[3] : nullptr );
 
         SCH_MARKER* marker = new SCH_MARKER( ercItem, wires[0]->GetPosition() );
-        screen->Append( marker );
+        aMarkers.push_back( marker );
 
         return false;
     }
@@ -2489,7 +2685,8 @@ bool CONNECTION_GRAPH::ercCheckFloatingWires( const CONNECTION_SUBGRAPH* aSubgra
 }
 
 
-bool CONNECTION_GRAPH::ercCheckLabels( const CONNECTION_SUBGRAPH* aSubgraph )
+bool CONNECTION_GRAPH::ercCheckLabels( const CONNECTION_SUBGRAPH* aSubgraph,
+                                       std::vector<SCH_MARKER*>& aMarkers )
 {
     // Label connection rules:
     // Local labels are flagged if they don't connect to any pins and don't have a no-connect
@@ -2524,7 +2721,7 @@ bool CONNECTION_GRAPH::ercCheckLabels( const CONNECTION_SUBGRAPH* aSubgraph )
                 ercItem->SetItems( text );
 
                 SCH_MARKER* marker = new SCH_MARKER( ercItem, text->GetPosition() );
-                aSubgraph->m_sheet.LastScreen()->Append( marker );
+                aMarkers.push_back( marker );
                 ok = false;
             }
 
@@ -2596,7 +2793,7 @@ bool CONNECTION_GRAPH::ercCheckLabels( const CONNECTION_SUBGRAPH* aSubgraph )
         ercItem->SetItems( text );
 
         SCH_MARKER* marker = new SCH_MARKER( ercItem, text->GetPosition() );
-        aSubgraph->m_sheet.LastScreen()->Append( marker );
+        aMarkers.push_back( marker );
 
         return false;
     }
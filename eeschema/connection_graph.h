@@ -40,6 +40,7 @@ class CONNECTION_GRAPH;
 class SCHEMATIC;
 class SCH_EDIT_FRAME;
 class SCH_HIERLABEL;
+class SCH_MARKER;
 class SCH_PIN;
 class SCH_SHEET_PIN;
 
@@ -253,6 +254,12 @@ public:
     /**
      * Updates the connection graph for the given list of sheets.
      *
+     * Unless \a aUnconditional is set, only the sheets whose screen was changed since the last
+     * update (items added or removed, or items with dirty connectivity) have their graphical
+     * connectivity recalculated; the other sheets keep the connected items found last time.
+     * The subgraphs are then rebuilt for the whole hierarchy, and the net and bus codes of the
+     * existing nets are kept.  A full recalculation is done if the hierarchy has changed.
+     *
      * @param aSheetList is the list of possibly modified sheets
      * @param aUnconditional is true if an unconditional full recalculation should be done
      */
@@ -312,6 +319,9 @@ private:
     // All the sheets in the schematic (as long as we don't have partial updates)
     SCH_SHEET_LIST m_sheetList;
 
+    // The screen of each sheet of m_sheetList when it was last updated
+    std::vector<SCH_SCREEN*> m_sheetScreens;
+
     // All connectable items in the schematic
     std::vector<SCH_ITEM*> m_items;
 
@@ -383,6 +393,24 @@ private:
     void updateItemConnectivity( const SCH_SHEET_PATH& aSheet,
                                  const std::vector<SCH_ITEM*>& aItemList );
 
+    /**
+     * Re-initializes the connections of items on a sheet whose graphical connectivity has
+     * not changed since the last call to updateItemConnectivity().  The connected items are
+     * kept, only the connections are reset.  As a side effect, items are loaded into m_items
+     * for BuildConnectionGraph()
+     *
+     * @param aSheet is the path to the sheet of all items in the list
+     * @param aItemList is a list of items to consider
+     */
+    void reuseItemConnectivity( const SCH_SHEET_PATH& aSheet,
+                                const std::vector<SCH_ITEM*>& aItemList );
+
+    /**
+     * Deletes the subgraphs and clears the caches built from them, but keeps the net and bus
+     * codes already assigned so that the nets keep their code in an incremental update.
+     */
+    void resetSubgraphs();
+
     /**
      * Generates the connection graph (after all item connectivity has been updated)
      *
@@ -451,9 +479,11 @@ private:
      * For example, a net wire connected to a bus port/pin, or vice versa
      *
      * @param  aSubgraph      is the subgraph to examine
+     * @param  aMarkers       receives the markers to add to the sheet of the subgraph
      * @return                true for no errors, false for errors
      */
-    bool ercCheckBusToNetConflicts( const CONNECTION_SUBGRAPH* aSubgraph );
+    bool ercCheckBusToNetConflicts( const CONNECTION_SUBGRAPH* aSubgraph,
+                                    std::vector<SCH_MARKER*>& aMarkers );
 
     /**
      * Checks one subgraph for conflicting connections between two bus items
@@ -463,9 +493,11 @@ private:
      * sheet pin
      *
      * @param  aSubgraph      is the subgraph to examine
+     * @param  aMarkers       receives the markers to add to the sheet of the subgraph
      * @return                true for no errors, false for errors
      */
-    bool ercCheckBusToBusConflicts( const CONNECTION_SUBGRAPH* aSubgraph );
+    bool ercCheckBusToBusConflicts( const CONNECTION_SUBGRAPH* aSubgraph,
+                                    std::vector<SCH_MARKER*>& aMarkers );
 
     /**
      * Checks one subgraph for conflicting bus entry to bus connections
@@ -477,9 +509,11 @@ private:
      * "USB.DP" but someone might accidentally just enter "DP"
      *
      * @param  aSubgraph      is the subgraph to examine
+     * @param  aMarkers       receives the markers to add to the sheet of the subgraph
      * @return                true for no errors, false for errors
      */
-    bool ercCheckBusToBusEntryConflicts( const CONNECTION_SUBGRAPH* aSubgraph );
+    bool ercCheckBusToBusEntryConflicts( const CONNECTION_SUBGRAPH* aSubgraph,
+                                         std::vector<SCH_MARKER*>& aMarkers );
 
     /**
      * Checks one subgraph for proper presence or absence of no-connect symbols
@@ -488,9 +522,11 @@ private:
      * A pin without a no-connect symbol should have at least one connection
      *
      * @param  aSubgraph      is the subgraph to examine
+     * @param  aMarkers       receives the markers to add to the sheet of the subgraph
      * @return                true for no errors, false for errors
      */
-    bool ercCheckNoConnects( const CONNECTION_SUBGRAPH* aSubgraph );
+    bool ercCheckNoConnects( const CONNECTION_SUBGRAPH* aSubgraph,
+                             std::vector<SCH_MARKER*>& aMarkers );
 
     /**
      * Checks one subgraph for floating wires
@@ -498,9 +534,11 @@ private:
      * Will throw an error for any subgraph that consists of just wires with no driver
      *
      * @param  aSubgraph      is the subgraph to examine
+     * @param  aMarkers       receives the markers to add to the sheet of the subgraph
      * @return                true for no errors, false for errors
      */
-    bool ercCheckFloatingWires( const CONNECTION_SUBGRAPH* aSubgraph );
+    bool ercCheckFloatingWires( const CONNECTION_SUBGRAPH* aSubgraph,
+                                std::vector<SCH_MARKER*>& aMarkers );
 
     /**
      * Checks one subgraph for proper connection of labels
@@ -508,10 +546,12 @@ private:
      * Labels should be connected to something
      *
      * @param  aSubgraph      is the subgraph to examine
+     * @param  aMarkers       receives the markers to add to the sheet of the subgraph
      * @param  aCheckGlobalLabels is true if global labels should be checked for loneliness
      * @return                true for no errors, false for errors
      */
-    bool ercCheckLabels( const CONNECTION_SUBGRAPH* aSubgraph );
+    bool ercCheckLabels( const CONNECTION_SUBGRAPH* aSubgraph,
+                         std::vector<SCH_MARKER*>& aMarkers );
 
     /**
      * Checks that a hierarchical sheet has at least one matching label inside the sheet for each
@@ -41,6 +41,11 @@
 #include <page_layout/ws_proxy_view_item.h>
 #include <wx/ffile.h>
 
+#include <atomic>
+#include <future>
+#include <thread>
+#include <unordered_set>
+
 
 /* ERC tests :
  *  1 - conflicts between connected pins ( example: 2 connected outputs )
@@ -413,71 +418,111 @@ int ERC_TESTER::TestPinToPin()
     ERC_SETTINGS&  settings = m_schematic->ErcSettings();
     const NET_MAP& nets     = m_schematic->ConnectionGraph()->GetNetMap();
 
-    int errors = 0;
+    std::vector<const std::vector<CONNECTION_SUBGRAPH*>*> netSubgraphs;
 
-    for( const std::pair<NET_NAME_CODE, std::vector<CONNECTION_SUBGRAPH*>> net : nets )
-    {
-        std::vector<SCH_PIN*> pins;
-        std::unordered_map<EDA_ITEM*, SCH_SCREEN*> pinToScreenMap;
+    for( const std::pair<const NET_NAME_CODE, std::vector<CONNECTION_SUBGRAPH*>>& net : nets )
+        netSubgraphs.push_back( &net.second );
 
-        for( CONNECTION_SUBGRAPH* subgraph: net.second )
-        {
-            for( EDA_ITEM* item : subgraph->m_items )
+    // The nets are tested on several threads.  The markers are collected per net and added to
+    // the screens afterwards, in the order of the nets, so that the results don't depend on
+    // the thread scheduling.
+    std::vector<std::vector<std::pair<SCH_SCREEN*, SCH_MARKER*>>> markers( netSubgraphs.size() );
+
+    auto testNet =
+            [&]( size_t aNet )
             {
-                if( item->Type() == SCH_PIN_T )
+                std::vector<std::pair<SCH_PIN*, SCH_SCREEN*>> pins;
+                std::unordered_set<SCH_PIN*>                  foundPins;
+
+                // A pin of a screen used by several sheets is in a subgraph for each of them
+                for( CONNECTION_SUBGRAPH* subgraph : *netSubgraphs[aNet] )
                 {
-                    pins.emplace_back( static_cast<SCH_PIN*>( item ) );
-                    pinToScreenMap[item] = subgraph->m_sheet.LastScreen();
+                    for( EDA_ITEM* item : subgraph->m_items )
+                    {
+                        if( item->Type() == SCH_PIN_T
+                                && foundPins.insert( static_cast<SCH_PIN*>( item ) ).second )
+                        {
+                            pins.emplace_back( static_cast<SCH_PIN*>( item ),
+                                               subgraph->m_sheet.LastScreen() );
+                        }
+                    }
                 }
-            }
-        }
 
-        // Single-pin nets are handled elsewhere
-        if( pins.size() < 2 )
-            continue;
+                // Single-pin nets are handled elsewhere
+                if( pins.size() < 2 )
+                    return;
 
-        std::set<std::pair<SCH_PIN*, SCH_PIN*>> tested;
+                // Test each pair of pins once
+                for( size_t ii = 0; ii < pins.size(); ++ii )
+                {
+                    SCH_PIN*           refPin = pins[ii].first;
+                    ELECTRICAL_PINTYPE refType = refPin->GetType();
 
-        for( SCH_PIN* refPin : pins )
-        {
-            ELECTRICAL_PINTYPE refType = refPin->GetType();
+                    for( size_t jj = ii + 1; jj < pins.size(); ++jj )
+                    {
+                        SCH_PIN*           testPin = pins[jj].first;
+                        ELECTRICAL_PINTYPE testType = testPin->GetType();
+
+                        PIN_ERROR erc = settings.GetPinMapValue( refType, testType );
+
+                        if( erc != PIN_ERROR::OK )
+                        {
+                            std::shared_ptr<ERC_ITEM> ercItem =
+                                    ERC_ITEM::Create( erc == PIN_ERROR::WARNING ?
+                                                              ERCE_PIN_TO_PIN_WARNING :
+                                                              ERCE_PIN_TO_PIN_ERROR );
+                            ercItem->SetItems( refPin, testPin );
+
+                            ercItem->SetErrorMessage(
+                                    wxString::Format( _( "Pins of type %s and %s are connected" ),
+                                            ElectricalPinTypeGetText( refType ),
+                                            ElectricalPinTypeGetText( testType ) ) );
+
+                            SCH_MARKER* marker =
+                                    new SCH_MARKER( ercItem, refPin->GetTransformedPosition() );
+                            markers[aNet].emplace_back( pins[ii].second, marker );
+                        }
+                    }
+                }
+            };
 
-            for( SCH_PIN* testPin : pins )
-            {
-                if( testPin == refPin )
-                    continue;
+    size_t parallelThreadCount = std::max<size_t>( 1,
+            std::min<size_t>( std::thread::hardware_concurrency(), netSubgraphs.size() ) );
 
-                std::pair<SCH_PIN*, SCH_PIN*> pair1 = std::make_pair( refPin, testPin );
-                std::pair<SCH_PIN*, SCH_PIN*> pair2 = std::make_pair( testPin, refPin );
+    std::atomic<size_t> nextNet( 0 );
+    std::vector<std::future<size_t>> returns( parallelThreadCount );
 
-                if( tested.count( pair1 ) || tested.count( pair2 ) )
-                    continue;
+    auto test_lambda =
+            [&]() -> size_t
+            {
+                for( size_t ii = nextNet++; ii < netSubgraphs.size(); ii = nextNet++ )
+                    testNet( ii );
 
-                tested.insert( pair1 );
-                tested.insert( pair2 );
+                return 1;
+            };
 
-                ELECTRICAL_PINTYPE testType = testPin->GetType();
+    if( parallelThreadCount == 1 )
+    {
+        test_lambda();
+    }
+    else
+    {
+        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+            returns[ii] = std::async( std::launch::async, test_lambda );
 
-                PIN_ERROR erc = settings.GetPinMapValue( refType, testType );
+        // Finalize the threads
+        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+            returns[ii].wait();
+    }
 
-                if( erc != PIN_ERROR::OK )
-                {
-                    std::shared_ptr<ERC_ITEM> ercItem =
-                            ERC_ITEM::Create( erc == PIN_ERROR::WARNING ? ERCE_PIN_TO_PIN_WARNING :
-                                                                          ERCE_PIN_TO_PIN_ERROR );
-                    ercItem->SetItems( refPin, testPin );
-
-                    ercItem->SetErrorMessage(
-                            wxString::Format( _( "Pins of type %s and %s are connected" ),
-                                    ElectricalPinTypeGetText( refType ),
-                                    ElectricalPinTypeGetText( testType ) ) );
-
-                    SCH_MARKER* marker =
-                            new SCH_MARKER( ercItem, refPin->GetTransformedPosition() );
-                    pinToScreenMap[refPin]->Append( marker );
-                    errors++;
-                }
-            }
+    int errors = 0;
+
+    for( const std::vector<std::pair<SCH_SCREEN*, SCH_MARKER*>>& netMarkers : markers )
+    {
+        for( const std::pair<SCH_SCREEN*, SCH_MARKER*>& marker : netMarkers )
+        {
+            marker.first->Append( marker.second );
+            errors++;
         }
     }
 
@@ -493,7 +538,7 @@ int ERC_TESTER::TestMultUnitPinConflicts()
 
     std::unordered_map<wxString, std::pair<wxString, SCH_PIN*>> pinToNetMap;
 
-    for( const std::pair<NET_NAME_CODE, std::vector<CONNECTION_SUBGRAPH*>> net : nets )
+    for( const std::pair<const NET_NAME_CODE, std::vector<CONNECTION_SUBGRAPH*>>& net : nets )
     {
         const wxString& netName = net.first.first;
         std::vector<SCH_PIN*> pins;
@@ -547,12 +592,11 @@ int ERC_TESTER::TestSimilarLabels()
 
     int errors = 0;
 
-    std::unordered_map<wxString, SCH_TEXT*> labelMap;
+    // The first label found for each normalized (lower case) text, with its shown text
+    std::unordered_map<wxString, std::pair<wxString, SCH_TEXT*>> labelMap;
 
-    for( const std::pair<NET_NAME_CODE, std::vector<CONNECTION_SUBGRAPH*>> net : nets )
+    for( const std::pair<const NET_NAME_CODE, std::vector<CONNECTION_SUBGRAPH*>>& net : nets )
     {
-        std::vector<SCH_PIN*> pins;
-
         for( CONNECTION_SUBGRAPH* subgraph : net.second )
         {
             for( EDA_ITEM* item : subgraph->m_items )
@@ -564,17 +608,15 @@ int ERC_TESTER::TestSimilarLabels()
                 case SCH_GLOBAL_LABEL_T:
                 {
                     SCH_TEXT* text = static_cast<SCH_TEXT*>( item );
+                    wxString  shownText = text->GetShownText();
 
-                    wxString normalized = text->GetShownText().Lower();
+                    auto inserted = labelMap.emplace( shownText.Lower(),
+                                                      std::make_pair( shownText, text ) );
 
-                    if( !labelMap.count( normalized ) )
-                    {
-                        labelMap[normalized] = text;
-                    }
-                    else if( labelMap.at( normalized )->GetShownText() != text->GetShownText() )
+                    if( !inserted.second && inserted.first->second.first != shownText )
                     {
                         std::shared_ptr<ERC_ITEM> ercItem = ERC_ITEM::Create( ERCE_SIMILAR_LABELS );
-                        ercItem->SetItems( text, labelMap.at( normalized ) );
+                        ercItem->SetItems( text, inserted.first->second.second );
 
                         SCH_MARKER* marker = new SCH_MARKER( ercItem, text->GetPosition() );
                         subgraph->m_sheet.LastScreen()->Append( marker );
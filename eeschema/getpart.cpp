@@ -140,7 +140,7 @@ COMPONENT_SELECTION SCH_BASE_FRAME::SelectCompFromLibTree( const SCHLIB_FILTER*
     const std::vector< wxString > libNicknames = libs->GetLogicalLibs();
 
     if( !loaded )
-        adapter->AddLibraries( libNicknames, this );
+        adapter->AddLibraries( libNicknames, this, GetSymbolIndexFileName() );
 
     if( aHighlight && aHighlight->IsValid() )
         adapter->SetPreselectNode( *aHighlight, /* aUnit */ 0 );
@@ -816,7 +816,7 @@ void LIB_VIEW_FRAME::OnSelectSymbol( wxCommandEvent& aEvent )
     auto adapter = static_cast<SYMBOL_TREE_MODEL_ADAPTER*>( adapterPtr.get() );
 
     const auto libNicknames = libs->GetLogicalLibs();
-    adapter->AddLibraries( libNicknames, this );
+    adapter->AddLibraries( libNicknames, this, GetSymbolIndexFileName() );
 
     LIB_PART* current = GetSelectedSymbol();
     LIB_ID id;
@@ -188,6 +188,17 @@ LIB_PART* SCH_BASE_FRAME::GetLibPart( const LIB_ID& aLibId, bool aUseCacheLib, b
 }
 
 
+wxString SCH_BASE_FRAME::GetSymbolIndexFileName()
+{
+    SETTINGS_MANAGER* mgr = GetSettingsManager();
+
+    if( !mgr->IsProjectOpen() || !wxFileName::IsDirWritable( Prj().GetProjectPath() ) )
+        return wxEmptyString;
+
+    return Prj().GetProjectPath() + "sym-info-cache";
+}
+
+
 bool SCH_BASE_FRAME::saveSymbolLibTables( bool aGlobal, bool aProject )
 {
     wxString msg;
@@ -192,6 +192,12 @@ public:
 
     LIB_PART* GetFlattenedLibPart( const LIB_ID& aLibId, bool aShowErrorMsg = false );
 
+    /**
+     * @return the file of the symbol library index of the project (see LIB_TREE_INDEX), or
+     *         an empty string if there is no project or if its directory is read only.
+     */
+    wxString GetSymbolIndexFileName();
+
     /**
      * Function SelectComponentFromLibBrowser
      * Calls the library viewer to select component to import into schematic.
@@ -1208,7 +1208,9 @@ void SCH_EDIT_FRAME::RecalculateConnections( SCH_CLEANUP_FLAGS aCleanupFlags )
     if( settings.m_IntersheetsRefShow == true )
         RecomputeIntersheetsRefs();
 
-    Schematic().ConnectionGraph()->Recalculate( list, true );
+    // Only the sheets changed since the last update need their connectivity recalculated,
+    // except after a global cleanup
+    Schematic().ConnectionGraph()->Recalculate( list, aCleanupFlags == GLOBAL_CLEANUP );
 }
 
 int SCH_EDIT_FRAME::RecomputeIntersheetsRefs()
@@ -902,6 +902,9 @@ public:
 
     /**
      * Generates the connection data for the entire schematic hierarchy.
+     *
+     * Only the sheets changed since the last update have their connectivity recalculated,
+     * unless \a aCleanupFlags is GLOBAL_CLEANUP.
      */
     void RecalculateConnections( SCH_CLEANUP_FLAGS aCleanupFlags );
 
@@ -20,6 +20,11 @@
  */
 
 #include <algorithm>
+#include <atomic>
+#include <exception>
+#include <future>
+#include <map>
+#include <thread>
 
 // For some reason wxWidgets is built with wxUSE_BASE64 unset so expose the wxWidgets
 // base64 code.
@@ -28,6 +33,8 @@
 #include <wx/mstream.h>
 #include <advanced_config.h>
 #include <pgm_base.h>
+#include <settings/settings_manager.h>
+#include <libedit/libedit_settings.h>
 #include <trace_helpers.h>
 #include <sch_bitmap.h>
 #include <sch_bus_entry.h>
@@ -286,7 +293,8 @@ static void formatStroke( OUTPUTFORMATTER* aFormatter, int aNestLevel,
  */
 class SCH_SEXPR_PLUGIN_CACHE
 {
-    static int      m_modHash;      // Keep track of the modification status of the library.
+    static std::atomic<int> m_modHash; // Keep track of the modification status of the library.
+                                       // Caches of several libraries can load at the same time.
 
     wxString        m_fileName;     // Absolute path and file name.
     wxFileName      m_libFileName;  // Absolute path and file name is required here.
@@ -454,74 +462,163 @@ SCH_SHEET* SCH_SEXPR_PLUGIN::Load( const wxString& aFileName, SCHEMATIC* aSchema
 }
 
 
-// Everything below this comment is recursive.  Modify with care.
-
 void SCH_SEXPR_PLUGIN::loadHierarchy( SCH_SHEET* aSheet )
 {
-    SCH_SCREEN* screen = NULL;
+    if( aSheet->GetScreen() )
+        return;
 
-    if( !aSheet->GetScreen() )
+    /**
+     * A sheet waiting for its screen, with the path its file name is relative to (the path
+     * of the file of the parent sheet).
+     */
+    struct PENDING_SHEET
     {
-        // SCH_SCREEN objects store the full path and file name where the SCH_SHEET object only
-        // stores the file name and extension.  Add the project path to the file name and
-        // extension to compare when calling SCH_SHEET::SearchHierarchy().
-        wxFileName fileName = aSheet->GetFileName();
+        SCH_SHEET* m_sheet;
+        wxString   m_path;
+    };
 
-        if( !fileName.IsAbsolute() )
-            fileName.MakeAbsolute( m_currentPath.top() );
+    /**
+     * A schematic file to parse, into the screen of the first sheet using it.
+     */
+    struct PARSE_JOB
+    {
+        SCH_SHEET*         m_sheet;
+        wxString           m_fileName;
+        std::exception_ptr m_error;
+    };
 
-        // Save the current path so that it gets restored when decending and ascending the
-        // sheet hierarchy which allows for sheet schematic files to be nested in folders
-        // relative to the last path a schematic was loaded from.
-        wxLogTrace( traceSchLegacyPlugin, "Saving path    \"%s\"", m_currentPath.top() );
-        m_currentPath.push( fileName.GetPath() );
-        wxLogTrace( traceSchLegacyPlugin, "Current path   \"%s\"", m_currentPath.top() );
-        wxLogTrace( traceSchLegacyPlugin, "Loading        \"%s\"", fileName.GetFullPath() );
+    // Screens created by this load, by full file name.  Screens already in the schematic
+    // (when appending) are found by SCH_SHEET::SearchHierarchy().
+    std::map<wxString, SCH_SCREEN*> loadedScreens;
 
-        m_rootSheet->SearchHierarchy( fileName.GetFullPath(), &screen );
+    // The translated default field names and the symbol editor settings used by the parser
+    // are created on first use; fetch them here so the parser threads only read them.
+    TEMPLATE_FIELDNAME::GetDefaultFieldName( REFERENCE );
+    Pgm().GetSettingsManager().GetAppSettings<LIBEDIT_SETTINGS>();
 
-        if( screen )
+    std::vector<PENDING_SHEET> pending = { { aSheet, m_currentPath.top() } };
+
+    // The hierarchy is loaded one level at a time: the screens of the sheets of a level are
+    // assigned (or shared) first, then the new files of the level are parsed concurrently,
+    // and the sheets found in them make the next level.
+    while( !pending.empty() )
+    {
+        std::vector<PARSE_JOB> jobs;
+
+        for( const PENDING_SHEET& entry : pending )
         {
-            aSheet->SetScreen( screen );
-            aSheet->GetScreen()->SetParent( m_schematic );
-            // Do not need to load the sub-sheets - this has already been done.
+            SCH_SHEET* sheet = entry.m_sheet;
+
+            if( sheet->GetScreen() )
+                continue;
+
+            // SCH_SCREEN objects store the full path and file name where the SCH_SHEET object
+            // only stores the file name and extension.  Add the path of the parent sheet file
+            // so that sheet files can be nested in folders relative to their parent.
+            wxFileName fileName = sheet->GetFileName();
+
+            if( !fileName.IsAbsolute() )
+                fileName.MakeAbsolute( entry.m_path );
+
+            wxString    fullPath = fileName.GetFullPath();
+            SCH_SCREEN* screen = nullptr;
+            auto        it = loadedScreens.find( fullPath );
+
+            if( it != loadedScreens.end() )
+                screen = it->second;
+            else
+                m_rootSheet->SearchHierarchy( fullPath, &screen );
+
+            if( screen )
+            {
+                sheet->SetScreen( screen );
+                sheet->GetScreen()->SetParent( m_schematic );
+                // Do not need to load the sub-sheets - this is done with the first sheet.
+                continue;
+            }
+
+            wxLogTrace( traceSchLegacyPlugin, "Loading        \"%s\"", fullPath );
+
+            sheet->SetScreen( new SCH_SCREEN( m_schematic ) );
+            sheet->GetScreen()->SetFileName( fullPath );
+            loadedScreens[fullPath] = sheet->GetScreen();
+            jobs.push_back( { sheet, fullPath, nullptr } );
         }
+
+        // Each file is parsed by its own parser into its own screen.  The LOCALE_IO of Load()
+        // is held by this thread for the whole parse.
+        size_t parallelThreadCount = std::max<size_t>( 1,
+                std::min<size_t>( std::thread::hardware_concurrency(), jobs.size() ) );
+
+        std::atomic<size_t> nextJob( 0 );
+        std::vector<std::future<size_t>> returns( parallelThreadCount );
+
+        auto parse_lambda =
+                [&]() -> size_t
+                {
+                    for( size_t ii = nextJob++; ii < jobs.size(); ii = nextJob++ )
+                    {
+                        try
+                        {
+                            loadFile( jobs[ii].m_fileName, jobs[ii].m_sheet );
+                        }
+                        catch( ... )
+                        {
+                            // Kept for this thread to rethrow: other exceptions than IO_ERROR
+                            // still abort the load as they do when parsing sequentially.
+                            jobs[ii].m_error = std::current_exception();
+                        }
+                    }
+
+                    return 1;
+                };
+
+        if( parallelThreadCount == 1 )
+            parse_lambda();
         else
         {
-            aSheet->SetScreen( new SCH_SCREEN( m_schematic ) );
-            aSheet->GetScreen()->SetFileName( fileName.GetFullPath() );
+            for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+                returns[ii] = std::async( std::launch::async, parse_lambda );
 
-            try
-            {
-                loadFile( fileName.GetFullPath(), aSheet );
-            }
-            catch( const IO_ERROR& ioe )
+            // Finalize the threads
+            for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+                returns[ii].wait();
+        }
+
+        pending.clear();
+
+        for( const PARSE_JOB& job : jobs )
+        {
+            if( job.m_error )
             {
                 // If there is a problem loading the root sheet, there is no recovery.
-                if( aSheet == m_rootSheet )
-                    throw( ioe );
+                if( job.m_sheet == m_rootSheet )
+                    std::rethrow_exception( job.m_error );
 
                 // For all subsheets, queue up the error message for the caller.
-                if( !m_error.IsEmpty() )
-                    m_error += "\n";
+                try
+                {
+                    std::rethrow_exception( job.m_error );
+                }
+                catch( const IO_ERROR& ioe )
+                {
+                    if( !m_error.IsEmpty() )
+                        m_error += "\n";
 
-                m_error += ioe.What();
+                    m_error += ioe.What();
+                }
             }
 
-            // This was moved out of the try{} block so that any sheets definitionsthat
-            // the plugin fully parsed before the exception was raised will be loaded.
-            for( auto aItem : aSheet->GetScreen()->Items().OfType( SCH_SHEET_T ) )
-            {
-                wxCHECK2( aItem->Type() == SCH_SHEET_T, /* do nothing */ );
-                auto sheet = static_cast<SCH_SHEET*>( aItem );
+            // Any sheet definitions the parser fully parsed before an exception was raised
+            // are loaded.
+            wxString path = wxFileName( job.m_fileName ).GetPath();
 
-                // Recursion starts here.
-                loadHierarchy( sheet );
+            for( SCH_ITEM* item : job.m_sheet->GetScreen()->Items().OfType( SCH_SHEET_T ) )
+            {
+                wxCHECK2( item->Type() == SCH_SHEET_T, continue );
+                pending.push_back( { static_cast<SCH_SHEET*>( item ), path } );
             }
         }
-
-        m_currentPath.pop();
-        wxLogTrace( traceSchLegacyPlugin, "Restoring path \"%s\"", m_currentPath.top() );
     }
 }
 
@@ -1236,7 +1333,7 @@ void SCH_SEXPR_PLUGIN::saveBusAlias( std::shared_ptr<BUS_ALIAS> aAlias, int aNes
 }
 
 
-int SCH_SEXPR_PLUGIN_CACHE::m_modHash = 1;     // starts at 1 and goes up
+std::atomic<int> SCH_SEXPR_PLUGIN_CACHE::m_modHash( 1 );     // starts at 1 and goes up
 
 
 SCH_SEXPR_PLUGIN_CACHE::SCH_SEXPR_PLUGIN_CACHE( const wxString& aFullPathAndFileName ) :
@@ -69,6 +69,7 @@ SCH_SCREEN::SCH_SCREEN( EDA_ITEM* aParent ) :
     m_paper( wxT( "A4" ) )
 {
     m_modification_sync = 0;
+    m_connectivityDirty = true;
 
     m_refCount = 0;
 
@@ -176,6 +177,7 @@ void SCH_SCREEN::Append( SCH_ITEM* aItem )
 
         m_rtree.insert( aItem );
         --m_modification_sync;
+        m_connectivityDirty = true;
     }
 }
 
@@ -205,6 +207,8 @@ void SCH_SCREEN::Clear( bool aFree )
         m_rtree.clear();
     }
 
+    m_connectivityDirty = true;
+
     // Clear the project settings
     m_ScreenNumber = m_NumberOfScreens = 1;
 
@@ -242,6 +246,9 @@ bool SCH_SCREEN::Remove( SCH_ITEM* aItem )
 {
     bool retv = m_rtree.remove( aItem );
 
+    if( retv )
+        m_connectivityDirty = true;
+
     // Check if the library symbol for the removed schematic symbol is still required.
     if( retv && aItem->Type() == SCH_COMPONENT_T )
     {
@@ -116,6 +116,9 @@ private:
     int         m_modification_sync; // inequality with PART_LIBS::GetModificationHash() will
                                      //   trigger ResolveAll().
 
+    bool        m_connectivityDirty; // Items were added or removed since the last update of
+                                     //   the connection graph.
+
     /// List of bus aliases stored in this screen
     std::unordered_set< std::shared_ptr< BUS_ALIAS > > m_aliases;
 
@@ -207,6 +210,13 @@ public:
         return m_clientSheetPathList;
     }
 
+    /**
+     * @return true if items were added to or removed from the screen since the connectivity
+     *         of its items was last updated by the CONNECTION_GRAPH.
+     */
+    bool IsConnectivityDirty() const                        { return m_connectivityDirty; }
+    void SetConnectivityDirty( bool aDirty = true )         { m_connectivityDirty = aDirty; }
+
     void Append( SCH_ITEM* aItem );
 
     /**
@@ -282,6 +282,7 @@ void SCH_SHEET::AddPin( SCH_SHEET_PIN* aSheetPin )
     aSheetPin->SetParent( this );
     m_pins.push_back( aSheetPin );
     renumberPins();
+    SetConnectivityDirty();
 }
 
 
@@ -296,6 +297,7 @@ void SCH_SHEET::RemovePin( SCH_SHEET_PIN* aSheetPin )
         {
             m_pins.erase( i );
             renumberPins();
+            SetConnectivityDirty();
             return;
         }
     }
@@ -254,6 +254,57 @@ bool NGSPICE::LoadNetlist( const string& aNetlist )
 }
 
 
+/**
+ * Name of a vector as reported by the data callbacks.  ngspice vector names are not case
+ * sensitive, and node voltages are named after the node only, while ngGet_Vec_Info() also
+ * accepts the V(node) form.
+ */
+static string streamedName( const string& aName )
+{
+    string name( aName );
+    transform( name.begin(), name.end(), name.begin(), ::tolower );
+
+    if( name.size() > 3 && name.compare( 0, 2, "v(" ) == 0 && name.back() == ')'
+            && name.find( ',' ) == string::npos )
+    {
+        name = name.substr( 2, name.size() - 3 );
+    }
+
+    return name;
+}
+
+
+void NGSPICE::SetStreamedVectors( const vector<string>& aNames )
+{
+    std::lock_guard<std::mutex> lock( m_streamMutex );
+
+    m_streamedIndex.clear();
+    m_streamed.clear();
+
+    for( const string& name : aNames )
+        m_streamed[streamedName( name )];
+}
+
+
+void NGSPICE::GetNewPoints( const vector<string>& aNames, vector<vector<double>>& aPoints )
+{
+    std::lock_guard<std::mutex> lock( m_streamMutex );
+
+    aPoints.resize( aNames.size() );
+
+    for( size_t ii = 0; ii < aNames.size(); ++ii )
+    {
+        auto it = m_streamed.find( streamedName( aNames[ii] ) );
+
+        aPoints[ii].clear();
+
+        // Hand over the buffer, the next points are collected in a new one
+        if( it != m_streamed.end() )
+            aPoints[ii].swap( it->second );
+    }
+}
+
+
 bool NGSPICE::Run()
 {
     LOCALE_IO c_locale;               // ngspice works correctly only with C locale
@@ -391,7 +442,8 @@ void NGSPICE::init_dll()
     m_ngSpice_AllVecs = (ngSpice_AllVecs) m_dll.GetSymbol( "ngSpice_AllVecs" );
     m_ngSpice_Running = (ngSpice_Running) m_dll.GetSymbol( "ngSpice_running" ); // it is not a typo
 
-    m_ngSpice_Init( &cbSendChar, &cbSendStat, &cbControlledExit, NULL, NULL, &cbBGThreadRunning, this );
+    m_ngSpice_Init( &cbSendChar, &cbSendStat, &cbControlledExit, &cbSendData, &cbSendInitData,
+                    &cbBGThreadRunning, this );
 
     // Load a custom spinit file, to fix the problem with loading .cm files
     // Switch to the executable directory, so the relative paths are correct
@@ -541,6 +593,60 @@ int NGSPICE::cbSendStat( char* what, int id, void* user )
 }
 
 
+int NGSPICE::cbSendData( pvecvaluesall vecs, int count, int id, void* user )
+{
+    NGSPICE* sim = reinterpret_cast<NGSPICE*>( user );
+
+    std::lock_guard<std::mutex> lock( sim->m_streamMutex );
+
+    if( sim->m_streamed.empty() )
+        return 0;
+
+    int vecCount = std::min<int>( vecs->veccount, sim->m_streamedIndex.size() );
+
+    for( int ii = 0; ii < vecCount; ++ii )
+    {
+        vector<double>* points = sim->m_streamedIndex[ii];
+
+        if( !points )
+            continue;
+
+        const vecvalues* value = vecs->vecsa[ii];
+
+        if( value->is_complex )
+            points->push_back( hypot( value->creal, value->cimag ) );
+        else
+            points->push_back( value->creal );
+    }
+
+    return 0;
+}
+
+
+int NGSPICE::cbSendInitData( pvecinfoall info, int id, void* user )
+{
+    NGSPICE* sim = reinterpret_cast<NGSPICE*>( user );
+
+    std::lock_guard<std::mutex> lock( sim->m_streamMutex );
+
+    // A new plot starts: match its vectors with the streamed ones
+    sim->m_streamedIndex.assign( info->veccount, nullptr );
+
+    for( auto& streamed : sim->m_streamed )
+        streamed.second.clear();
+
+    for( int ii = 0; ii < info->veccount; ++ii )
+    {
+        auto it = sim->m_streamed.find( streamedName( info->vecs[ii]->vecname ) );
+
+        if( it != sim->m_streamed.end() )
+            sim->m_streamedIndex[ii] = &it->second;
+    }
+
+    return 0;
+}
+
+
 int NGSPICE::cbBGThreadRunning( bool is_running, int id, void* user )
 {
     NGSPICE* sim = reinterpret_cast<NGSPICE*>( user );
@@ -30,6 +30,9 @@
 #include <wx/dynlib.h>
 #include <ngspice/sharedspice.h>
 
+#include <map>
+#include <mutex>
+
 class wxDynamicLibrary;
 
 class NGSPICE : public SPICE_SIMULATOR {
@@ -77,6 +80,13 @@ public:
     ///> @copydoc SPICE_SIMULATOR::GetPhasePlot()
     std::vector<double> GetPhasePlot( const std::string& aName, int aMaxLen = -1 ) override;
 
+    ///> @copydoc SPICE_SIMULATOR::SetStreamedVectors()
+    void SetStreamedVectors( const std::vector<std::string>& aNames ) override;
+
+    ///> @copydoc SPICE_SIMULATOR::GetNewPoints()
+    void GetNewPoints( const std::vector<std::string>& aNames,
+                       std::vector<std::vector<double>>& aPoints ) override;
+
     ///> @copydoc SPICE_SIMULATOR::GetNetlist()
     virtual const std::string GetNetlist() const override;
 
@@ -122,6 +132,8 @@ private:
     // Callback functions
     static int cbSendChar( char* what, int id, void* user );
     static int cbSendStat( char* what, int id, void* user );
+    static int cbSendData( pvecvaluesall vecs, int count, int id, void* user );
+    static int cbSendInitData( pvecinfoall info, int id, void* user );
     static int cbBGThreadRunning( bool is_running, int id, void* user );
     static int cbControlledExit( int status, bool immediate, bool exit_upon_quit, int id, void* user );
 
@@ -136,6 +148,15 @@ private:
 
     ///> current netlist
     std::string m_netlist;
+
+    ///> Points of the streamed vectors collected during a background run, by lower case name
+    std::map<std::string, std::vector<double>> m_streamed;
+
+    ///> Collection of each vector of the running plot, nullptr for a vector not streamed
+    std::vector<std::vector<double>*> m_streamedIndex;
+
+    ///> Guards the streamed points, collected by the ngspice background thread
+    std::mutex m_streamMutex;
 };
 
 #endif /* NGSPICE_H */
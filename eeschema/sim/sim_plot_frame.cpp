@@ -121,6 +121,7 @@ wxString SIM_PLOT_FRAME::m_savedWorkbooksPath;
 SIM_PLOT_FRAME::SIM_PLOT_FRAME( KIWAY* aKiway, wxWindow* aParent )
         : SIM_PLOT_FRAME_BASE( aParent ),
           m_lastSimPlot( nullptr ),
+          m_livePlot( nullptr ),
           m_welcomePanel( nullptr ),
           m_plotNumber( 0 )
 {
@@ -172,6 +173,10 @@ SIM_PLOT_FRAME::SIM_PLOT_FRAME( KIWAY* aKiway, wxWindow* aParent )
     Connect( EVT_SIM_FINISHED, wxCommandEventHandler( SIM_PLOT_FRAME::onSimFinished ), NULL, this );
     Connect( EVT_SIM_CURSOR_UPDATE, wxCommandEventHandler( SIM_PLOT_FRAME::onCursorUpdate ), NULL, this );
 
+    m_liveUpdateTimer.SetOwner( this );
+    Connect( m_liveUpdateTimer.GetId(), wxEVT_TIMER,
+             wxTimerEventHandler( SIM_PLOT_FRAME::onLiveUpdate ), NULL, this );
+
     // Toolbar buttons
     m_toolSimulate = m_toolBar->AddTool( ID_SIM_RUN, _( "Run/Stop Simulation" ),
             KiBitmap( sim_run_xpm ), _( "Run Simulation" ), wxITEM_NORMAL );
@@ -229,6 +234,7 @@ SIM_PLOT_FRAME::SIM_PLOT_FRAME( KIWAY* aKiway, wxWindow* aParent )
 
 SIM_PLOT_FRAME::~SIM_PLOT_FRAME()
 {
+    m_liveUpdateTimer.Stop();
     m_simulator->SetReporter( nullptr );
     delete m_reporter;
     delete m_signalsIconColorList;
@@ -458,6 +464,7 @@ void SIM_PLOT_FRAME::StartSimulation( const wxString& aSimCommand )
     m_simulator->LoadNetlist( formatter.GetString() );
     updateTuners();
     applyTuners();
+    setupLiveUpdate();
     m_simulator->Run();
 }
 
@@ -791,6 +798,46 @@ bool SIM_PLOT_FRAME::updatePlot( const TRACE_DESC& aDescriptor, SIM_PLOT_PANEL*
 }
 
 
+void SIM_PLOT_FRAME::setupLiveUpdate()
+{
+    m_livePlot = nullptr;
+    m_liveVectors.clear();
+    m_liveTraces.clear();
+
+    SIM_PLOT_PANEL* plotPanel = CurrentPlot();
+
+    // The points of a transient analysis come in the order of the X axis, so they can be
+    // appended to the traces.  Other analyses are plotted when they are finished.
+    if( plotPanel && m_exporter->GetSimType() == ST_TRANSIENT
+            && plotPanel->GetType() == ST_TRANSIENT )
+    {
+        m_liveVectors.push_back( m_simulator->GetXAxis( ST_TRANSIENT ) );
+
+        for( const auto& trace : m_plots[plotPanel].m_traces )
+        {
+            const TRACE_DESC& desc = trace.second;
+            wxString spiceVector = m_exporter->ComponentToVector( desc.GetName(), desc.GetType(),
+                                                                  desc.GetParam() );
+
+            if( TRACE* plotTrace = plotPanel->GetTrace( trace.first ) )
+            {
+                plotTrace->SetData( std::vector<double>(), std::vector<double>() );
+                m_liveVectors.push_back( (const char*) spiceVector.c_str() );
+                m_liveTraces.push_back( trace.first );
+            }
+        }
+
+        if( !m_liveTraces.empty() )
+            m_livePlot = plotPanel;
+    }
+
+    if( !m_livePlot )
+        m_liveVectors.clear();
+
+    m_simulator->SetStreamedVectors( m_liveVectors );
+}
+
+
 void SIM_PLOT_FRAME::updateSignalList()
 {
     m_signals->ClearAll();
@@ -1235,6 +1282,10 @@ void SIM_PLOT_FRAME::onPlotClose( wxAuiNotebookEvent& event )
             dynamic_cast<SIM_PANEL_BASE*>( m_plotNotebook->GetPage( idx ) );
 
     m_plots.erase( plotPanel );
+
+    if( plotPanel == m_livePlot )
+        m_livePlot = nullptr;
+
     updateSignalList();
     wxCommandEvent dummy;
     onCursorUpdate( dummy );
@@ -1473,6 +1524,9 @@ void SIM_PLOT_FRAME::onSimStarted( wxCommandEvent& aEvent )
 {
     m_toolBar->SetToolNormalBitmap( ID_SIM_RUN, KiBitmap( sim_stop_xpm ) );
     SetCursor( wxCURSOR_ARROWWAIT );
+
+    if( m_livePlot )
+        m_liveUpdateTimer.Start( 250 );
 }
 
 
@@ -1481,6 +1535,13 @@ void SIM_PLOT_FRAME::onSimFinished( wxCommandEvent& aEvent )
     m_toolBar->SetToolNormalBitmap( ID_SIM_RUN, KiBitmap( sim_run_xpm ) );
     SetCursor( wxCURSOR_ARROW );
 
+    // The traces are reloaded below from the complete simulation vectors
+    m_liveUpdateTimer.Stop();
+    m_livePlot = nullptr;
+    m_liveVectors.clear();
+    m_liveTraces.clear();
+    m_simulator->SetStreamedVectors( m_liveVectors );
+
     SIM_TYPE simType = m_exporter->GetSimType();
 
     if( simType == ST_UNKNOWN )
@@ -1548,6 +1609,31 @@ void SIM_PLOT_FRAME::onSimFinished( wxCommandEvent& aEvent )
 }
 
 
+void SIM_PLOT_FRAME::onLiveUpdate( wxTimerEvent& aEvent )
+{
+    if( !m_livePlot )
+        return;
+
+    std::vector<std::vector<double>> points;
+    m_simulator->GetNewPoints( m_liveVectors, points );
+
+    const std::vector<double>& data_x = points[0];
+
+    if( data_x.empty() )
+        return;
+
+    for( size_t ii = 1; ii < points.size(); ++ii )
+    {
+        TRACE* trace = m_livePlot->GetTrace( m_liveTraces[ii - 1] );
+
+        if( trace && points[ii].size() == data_x.size() )
+            trace->AppendData( data_x, points[ii] );
+    }
+
+    m_livePlot->GetPlotWin()->UpdateAll();
+}
+
+
 void SIM_PLOT_FRAME::onSimUpdate( wxCommandEvent& aEvent )
 {
     if( IsSimulationRunning() )
@@ -1565,6 +1651,7 @@ void SIM_PLOT_FRAME::onSimUpdate( wxCommandEvent& aEvent )
         m_simConsole->Clear();
         // Do not export netlist, it is already stored in the simulator
         applyTuners();
+        setupLiveUpdate();
         m_simulator->Run();
     }
 }
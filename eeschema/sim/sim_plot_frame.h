@@ -41,10 +41,12 @@
 #include <dialogs/dialog_sim_settings.h>
 
 #include <wx/event.h>
+#include <wx/timer.h>
 
 #include <list>
 #include <memory>
 #include <map>
+#include <vector>
 
 class SCH_EDIT_FRAME;
 class SCH_COMPONENT;
@@ -268,6 +270,12 @@ private:
      */
     void applyTuners();
 
+    /**
+     * @brief Selects the traces of the current plot to update while a transient simulation
+     * runs, and clears them.  To be called before running the simulation.
+     */
+    void setupLiveUpdate();
+
     /**
      * @brief Loads plot settings from a file.
      * @param aPath is the file name.
@@ -335,6 +343,7 @@ private:
     void onSimReport( wxCommandEvent& aEvent );
     void onSimStarted( wxCommandEvent& aEvent );
     void onSimFinished( wxCommandEvent& aEvent );
+    void onLiveUpdate( wxTimerEvent& aEvent );
 
     // adjust the sash dimension of splitter windows after reading
     // the config settings
@@ -400,6 +409,16 @@ private:
     ///> Panel that was used as the most recent one for simulations
     SIM_PLOT_PANEL* m_lastSimPlot;
 
+    ///> Panel whose traces are updated while the simulation runs, or nullptr
+    SIM_PLOT_PANEL* m_livePlot;
+
+    ///> Spice vectors streamed for m_livePlot: the X axis, then one per trace of m_liveTraces
+    std::vector<std::string> m_liveVectors;
+    std::vector<wxString>    m_liveTraces;
+
+    ///> Reads the streamed points while the simulation runs
+    wxTimer m_liveUpdateTimer;
+
     ///> imagelists uset to add a small coloured icon to signal names
     ///> and cursors name, the same color as the corresponding signal traces
     wxImageList* m_signalsIconColorList;
@@ -145,6 +145,25 @@ public:
      */
     virtual std::vector<double> GetPhasePlot( const std::string& aName, int aMaxLen = -1 ) = 0;
 
+    /**
+     * @brief Selects the vectors whose points are collected while the simulation runs in the
+     * background, to be read with GetNewPoints() without copying the whole vectors.
+     * It has to be called before Run(); each run starts with empty collections.
+     * @param aNames are the vector names in Spice convention, an empty list stops the collection.
+     */
+    virtual void SetStreamedVectors( const std::vector<std::string>& aNames ) = 0;
+
+    /**
+     * @brief Moves the points collected since the previous call for the streamed vectors: the
+     * real values of a real vector, the magnitudes of a complex one.  All the vectors are read
+     * at once, so they get the same number of points.
+     * @param aNames are the streamed vector names.
+     * @param aPoints receives the new points of each vector of aNames, in the same order.
+     * A vector which is not streamed gets no point.
+     */
+    virtual void GetNewPoints( const std::vector<std::string>& aNames,
+                               std::vector<std::vector<double>>& aPoints ) = 0;
+
     /**
      * @brief Returns current SPICE netlist used by the simulator.
      * @return The netlist.
@@ -31,6 +31,10 @@
 #include <systemdirsappend.h>
 #include <symbol_lib_table.h>
 #include <class_libentry.h>
+#include <class_library.h>          // for DOC_EXT
+
+#include <wx/filename.h>
+#include <wx/hash.h>
 
 #define OPT_SEP     '|'         ///< options separator character
 
@@ -278,6 +282,30 @@ int SYMBOL_LIB_TABLE::GetModifyHash()
 }
 
 
+long long SYMBOL_LIB_TABLE::GenerateTimestamp( const wxString& aNickname )
+{
+    const SYMBOL_LIB_TABLE_ROW* row = FindRow( aNickname );
+
+    if( !row )
+        return 0;
+
+    wxString   uri = row->GetFullURI( true );
+    wxFileName fn( uri );
+
+    if( !fn.FileExists() )
+        return 0;
+
+    long long timestamp = fn.GetModificationTime().GetValue().GetValue();
+
+    fn.SetExt( DOC_EXT );
+
+    if( row->GetType() == SCH_IO_MGR::ShowType( SCH_IO_MGR::SCH_LEGACY ) && fn.FileExists() )
+        timestamp += fn.GetModificationTime().GetValue().GetValue();
+
+    return timestamp + wxHashTable::MakeKey( uri );
+}
+
+
 void SYMBOL_LIB_TABLE::EnumerateSymbolLib( const wxString& aNickname, wxArrayString& aAliasNames,
                                            bool aPowerSymbolsOnly )
 {
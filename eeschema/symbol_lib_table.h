@@ -151,6 +151,15 @@ public:
 
     int GetModifyHash();
 
+    /**
+     * Generate a timestamp of the library \a aNickname, from the modification time of its
+     * file (and of its documentation file for a legacy library) and its location.
+     * Timestamps either match or they don't.
+     *
+     * @return the timestamp, or 0 if the library file cannot be found.
+     */
+    long long GenerateTimestamp( const wxString& aNickname );
+
     //-----<PLUGIN API SUBSET, REBASED ON aNickname>---------------------------
 
     /**
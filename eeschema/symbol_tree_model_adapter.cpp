@@ -24,18 +24,49 @@
 #include <widgets/app_progress_dialog.h>
 
 #include <eda_pattern_match.h>
+#include <pgm_base.h>
+#include <settings/settings_manager.h>
+#include <libedit/libedit_settings.h>
 #include <symbol_lib_table.h>
 #include <class_libentry.h>
 #include <generate_alias_info.h>
 
 #include <symbol_tree_model_adapter.h>
 
+#include <atomic>
+#include <chrono>
+#include <thread>
+
 
 bool SYMBOL_TREE_MODEL_ADAPTER::m_show_progress = true;
 
 #define PROGRESS_INTERVAL_MILLIS 66
 
 
+/**
+ * Build the library index item of \a aSymbol.
+ */
+static std::unique_ptr<LIB_TREE_INDEX::ITEM> makeIndexItem( LIB_PART* aSymbol )
+{
+    std::unique_ptr<LIB_TREE_INDEX::ITEM> item( new LIB_TREE_INDEX::ITEM( aSymbol ) );
+    LIB_FIELDS                            fields;
+
+    item->m_keywords = aSymbol->GetKeyWords();
+    item->m_isPower = aSymbol->IsPower();
+    item->m_padCount = (unsigned) aSymbol->GetPinCount();
+
+    aSymbol->GetFields( fields );
+
+    for( const LIB_FIELD& field : fields )
+    {
+        if( !field.GetText().IsEmpty() )
+            item->m_fields.emplace_back( field.GetName(), field.GetText() );
+    }
+
+    return item;
+}
+
+
 SYMBOL_TREE_MODEL_ADAPTER::PTR SYMBOL_TREE_MODEL_ADAPTER::Create( EDA_BASE_FRAME* aParent,
                                                                   LIB_TABLE* aLibs )
 {
@@ -54,34 +85,150 @@ SYMBOL_TREE_MODEL_ADAPTER::~SYMBOL_TREE_MODEL_ADAPTER()
 
 
 void SYMBOL_TREE_MODEL_ADAPTER::AddLibraries( const std::vector<wxString>& aNicknames,
-                                              wxWindow* aParent )
+                                              wxWindow* aParent, const wxString& aIndexFile )
 {
     APP_PROGRESS_DIALOG* prg = nullptr;
     wxLongLong        nextUpdate = wxGetUTCTimeMillis() + (PROGRESS_INTERVAL_MILLIS / 2);
 
-    if( m_show_progress )
+    bool onlyPowerSymbols = ( GetFilter() == CMP_FILTER_POWER );
+    bool useIndex = !aIndexFile.IsEmpty();
+
+    LIB_TREE_INDEX                              index;
+    std::vector<long long>                      timestamps( aNicknames.size(), 0 );
+    std::vector<const LIB_TREE_INDEX::LIBRARY*> indexedLibs( aNicknames.size(), nullptr );
+
+    if( useIndex )
+        index.Load( aIndexFile );
+
+    // The libraries are parsed on several threads.  What the parsers create on first use
+    // is created here: the plugin of each library, and the symbol editor settings (which
+    // give the default sizes of pins)
+    std::vector<size_t> libsToLoad;
+
+    for( size_t ii = 0; ii < aNicknames.size(); ++ii )
+    {
+        m_libs->FindRow( aNicknames[ii] );
+
+        if( useIndex )
+        {
+            timestamps[ii] = m_libs->GenerateTimestamp( aNicknames[ii] );
+
+            if( timestamps[ii] )
+                indexedLibs[ii] = index.FindLibrary( aNicknames[ii], timestamps[ii] );
+        }
+
+        if( !indexedLibs[ii] )
+            libsToLoad.push_back( ii );
+    }
+
+    Pgm().GetSettingsManager().GetAppSettings<LIBEDIT_SETTINGS>();
+
+    if( m_show_progress && !libsToLoad.empty() )
     {
         prg = new APP_PROGRESS_DIALOG( _( "Loading Symbol Libraries" ), wxEmptyString,
-                                       aNicknames.size(), aParent );
+                                       libsToLoad.size(), aParent );
     }
 
-    unsigned int ii = 0;
+    std::vector<std::vector<LIB_PART*>> libSymbols( aNicknames.size() );
+    std::vector<wxString>               libErrors( aNicknames.size() );
+
+    // Each parser switches to the C locale; keep it for the whole load so the user
+    // locale is not restored while other libraries are parsed
+    LOCALE_IO toggle;
+
+    std::atomic<size_t> nextLib( 0 );
+    std::atomic<size_t> libsFinished( 0 );
+    std::atomic<size_t> threadsFinished( 0 );
 
-    for( const auto& nickname : aNicknames )
+    size_t parallelThreadCount = std::min<size_t>(
+            std::max<size_t>( std::thread::hardware_concurrency(), 2 ), libsToLoad.size() );
+
+    for( size_t ii = 0; ii < parallelThreadCount; ++ii )
     {
-        if( prg && wxGetUTCTimeMillis() > nextUpdate )
+        std::thread t = std::thread( [&]()
         {
-            prg->Update( ii, wxString::Format( _( "Loading library \"%s\"" ), nickname ) );
+            for( size_t j = nextLib.fetch_add( 1 ); j < libsToLoad.size();
+                 j = nextLib.fetch_add( 1 ) )
+            {
+                size_t i = libsToLoad[j];
+
+                // An indexed library holds all the symbols; the filter is applied on the index
+                bool onlyPower = onlyPowerSymbols && !timestamps[i];
+
+                try
+                {
+                    m_libs->LoadSymbolLib( libSymbols[i], aNicknames[i], onlyPower );
+                }
+                catch( const IO_ERROR& ioe )
+                {
+                    libErrors[i] = ioe.What();
+                }
+                catch( const std::exception& e )
+                {
+                    libErrors[i] = e.what();
+                }
+
+                libsFinished++;
+            }
+
+            threadsFinished++;
+        } );
+
+        t.detach();
+    }
+
+    while( threadsFinished < parallelThreadCount )
+    {
+        size_t started = std::min( nextLib.load(), libsToLoad.size() );
+
+        if( prg && started > 0 && wxGetUTCTimeMillis() > nextUpdate )
+        {
+            prg->Update( libsFinished, wxString::Format( _( "Loading library \"%s\"" ),
+                                                         aNicknames[libsToLoad[started - 1]] ) );
 
             nextUpdate = wxGetUTCTimeMillis() + PROGRESS_INTERVAL_MILLIS;
         }
 
-        AddLibrary( nickname );
-        ii++;
+        std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+    }
+
+    // The libraries are added in the nicknames order
+    for( size_t ii = 0; ii < aNicknames.size(); ++ii )
+    {
+        if( !libErrors[ii].IsEmpty() )
+        {
+            wxLogError( wxString::Format( _( "Error loading symbol library %s.\n\n%s" ),
+                                          aNicknames[ii],
+                                          libErrors[ii] ) );
+            continue;
+        }
+
+        if( !indexedLibs[ii] && timestamps[ii] )
+        {
+            LIB_TREE_INDEX::LIBRARY& lib = index.SetLibrary( aNicknames[ii], timestamps[ii] );
+
+            for( LIB_PART* symbol : libSymbols[ii] )
+                lib.m_Items.push_back( makeIndexItem( symbol ) );
+
+            indexedLibs[ii] = &lib;
+        }
+
+        if( indexedLibs[ii] )
+            addIndexedSymbols( aNicknames[ii], *indexedLibs[ii] );
+        else
+            addLibrarySymbols( aNicknames[ii], libSymbols[ii] );
     }
 
     m_tree.AssignIntrinsicRanks();
 
+    if( useIndex )
+    {
+        index.KeepLibraries( aNicknames );
+
+        if( index.IsModified() )
+            index.Save( aIndexFile );
+    }
+
     if( prg )
     {
         prg->Destroy();
@@ -94,7 +241,6 @@ void SYMBOL_TREE_MODEL_ADAPTER::AddLibrary( wxString const& aLibNickname )
 {
     bool                        onlyPowerSymbols = ( GetFilter() == CMP_FILTER_POWER );
     std::vector<LIB_PART*>      symbols;
-    std::vector<LIB_TREE_ITEM*> comp_list;
 
     try
     {
@@ -108,14 +254,40 @@ void SYMBOL_TREE_MODEL_ADAPTER::AddLibrary( wxString const& aLibNickname )
         return;
     }
 
-    if( symbols.size() > 0 )
+    addLibrarySymbols( aLibNickname, symbols );
+}
+
+
+void SYMBOL_TREE_MODEL_ADAPTER::addLibrarySymbols( const wxString& aLibNickname,
+                                                   const std::vector<LIB_PART*>& aSymbols )
+{
+    std::vector<LIB_TREE_ITEM*> comp_list;
+
+    if( aSymbols.size() > 0 )
     {
-        comp_list.assign( symbols.begin(), symbols.end() );
+        comp_list.assign( aSymbols.begin(), aSymbols.end() );
         DoAddLibrary( aLibNickname, m_libs->GetDescription( aLibNickname ), comp_list, false );
     }
 }
 
 
+void SYMBOL_TREE_MODEL_ADAPTER::addIndexedSymbols( const wxString& aLibNickname,
+                                                   const LIB_TREE_INDEX::LIBRARY& aLib )
+{
+    bool                        onlyPowerSymbols = ( GetFilter() == CMP_FILTER_POWER );
+    std::vector<LIB_TREE_ITEM*> comp_list;
+
+    for( const std::unique_ptr<LIB_TREE_INDEX::ITEM>& item : aLib.m_Items )
+    {
+        if( !onlyPowerSymbols || item->m_isPower )
+            comp_list.push_back( item.get() );
+    }
+
+    if( comp_list.size() > 0 )
+        DoAddLibrary( aLibNickname, m_libs->GetDescription( aLibNickname ), comp_list, false );
+}
+
+
 wxString SYMBOL_TREE_MODEL_ADAPTER::GenerateInfo( LIB_ID const& aLibId, int aUnit )
 {
     return GenerateAliasInfo( m_libs, aLibId, aUnit );
@@ -23,8 +23,10 @@
 #define SYMBOL_TREE_MODEL_ADAPTER_H
 
 #include <lib_tree_model_adapter.h>
+#include <lib_tree_index.h>
 
 class LIB_TABLE;
+class LIB_PART;
 class SYMBOL_LIB_TABLE;
 
 class SYMBOL_TREE_MODEL_ADAPTER : public LIB_TREE_MODEL_ADAPTER
@@ -44,12 +46,19 @@ public:
 
     /**
      * Add all the libraries in a SYMBOL_LIB_TABLE to the model.
+     * The libraries are loaded on several threads, and added in the \a aNicknames order.
      * Displays a progress dialog attached to the parent frame the first time it is run.
      *
+     * With a library index file, the libraries which did not change since they were indexed
+     * are added from the index, without being loaded; the other ones are loaded and indexed,
+     * and the index file is updated.
+     *
      * @param aNicknames is the list of library nicknames
      * @param aParent is the parent window to display the progress dialog
+     * @param aIndexFile is the file of the LIB_TREE_INDEX of the libraries, if any
      */
-    void AddLibraries( const std::vector<wxString>& aNicknames, wxWindow* aParent );
+    void AddLibraries( const std::vector<wxString>& aNicknames, wxWindow* aParent,
+                       const wxString& aIndexFile = wxEmptyString );
 
     void AddLibrary( wxString const& aLibNickname );
 
@@ -62,6 +71,17 @@ protected:
     SYMBOL_TREE_MODEL_ADAPTER( EDA_BASE_FRAME* aParent, LIB_TABLE* aLibs );
 
 private:
+    /**
+     * Add the symbols of a library, loaded by SYMBOL_LIB_TABLE::LoadSymbolLib(), to the model.
+     */
+    void addLibrarySymbols( const wxString& aLibNickname, const std::vector<LIB_PART*>& aSymbols );
+
+    /**
+     * Add the indexed symbols of a library to the model, only the power symbols if the
+     * power filter is set.
+     */
+    void addIndexedSymbols( const wxString& aLibNickname, const LIB_TREE_INDEX::LIBRARY& aLib );
+
     /**
      * Flag to only show the symbol library table load progress dialog the first time.
      */
@@ -176,6 +176,7 @@ void SYMBOL_TREE_SYNCHRONIZING_ADAPTER::updateLibrary( LIB_TREE_NODE_LIB& aLibNo
             {
                 // node does not exist in the library manager, remove the corresponding node
                 nodeIt = aLibNode.m_Children.erase( nodeIt );
+                m_tree.InvalidateSearchIndex();
             }
         }
 
@@ -195,6 +196,7 @@ LIB_TREE_NODE::PTR_VECTOR::iterator SYMBOL_TREE_SYNCHRONIZING_ADAPTER::deleteLib
     LIB_TREE_NODE* node = aLibNodeIt->get();
     m_libHashes.erase( node->m_Name );
     auto it = m_tree.m_Children.erase( aLibNodeIt );
+    m_tree.InvalidateSearchIndex();
     return it;
 }
 
@@ -85,6 +85,8 @@ void D_CODE::Clear_D_CODE_Data()
     m_Rotation   = 0.0;
     m_EdgesCount = 0;
     m_Polygon.RemoveAllContours();
+    m_flashShape.RemoveAllContours();
+    m_flashShapeValid = false;
 }
 
 
@@ -302,6 +304,7 @@ void D_CODE::ConvertShapeToPolygon()
     wxPoint currpos;
 
     m_Polygon.RemoveAllContours();
+    m_flashShapeValid = false;
 
     switch( m_Shape )
     {
@@ -451,3 +454,48 @@ static void addHoleToPolygon( SHAPE_POLY_SET*       aPolygon,
     aPolygon->BooleanSubtract( holeBuffer, SHAPE_POLY_SET::PM_FAST );
     aPolygon->Fracture( SHAPE_POLY_SET::PM_FAST );
 }
+
+
+const SHAPE_POLY_SET& D_CODE::GetFlashShape( const GERBER_DRAW_ITEM* aParent )
+{
+    // The draw transform is a linear transform plus an offset: the flash shape only
+    // depends on the linear part, identified here by the draw position of the X and Y axis
+    const int axisLength = 1000000;
+    wxPoint   origin = aParent->GetABPosition( wxPoint( 0, 0 ) );
+    wxPoint   axisX = aParent->GetABPosition( wxPoint( axisLength, 0 ) ) - origin;
+    wxPoint   axisY = aParent->GetABPosition( wxPoint( 0, axisLength ) ) - origin;
+
+    if( m_flashShapeValid && axisX == m_flashShapeAxis[0] && axisY == m_flashShapeAxis[1] )
+        return m_flashShape;
+
+    if( m_Macro )
+    {
+        // The macro shape is built at the item position: build it at the origin
+        m_flashShape = *m_Macro->GetApertureMacroShape( aParent, wxPoint( 0, 0 ) );
+        m_flashShape.Move( -VECTOR2I( origin ) );
+    }
+    else
+    {
+        if( m_Polygon.OutlineCount() == 0 )
+            ConvertShapeToPolygon();
+
+        m_flashShape = m_Polygon;
+
+        for( auto iter = m_flashShape.IterateWithHoles(); iter; iter++ )
+        {
+            wxPoint pt( iter->x, iter->y );
+            m_flashShape.SetVertex( iter.GetIndex(),
+                                    VECTOR2I( aParent->GetABPosition( pt ) - origin ) );
+        }
+    }
+
+    // Filled flashes are drawn from the cached triangulation
+    if( m_flashShape.OutlineCount() )
+        m_flashShape.CacheTriangulation();
+
+    m_flashShapeAxis[0] = axisX;
+    m_flashShapeAxis[1] = axisY;
+    m_flashShapeValid = true;
+
+    return m_flashShape;
+}
@@ -90,6 +90,10 @@ private:
      */
     std::vector<double>   m_am_params;
 
+    SHAPE_POLY_SET        m_flashShape;         ///< Shape of the flashes, see GetFlashShape()
+    wxPoint               m_flashShapeAxis[2];  ///< Draw X and Y axis of m_flashShape
+    bool                  m_flashShapeValid;
+
 public:
     wxSize                m_Size;           ///< Horizontal and vertical dimensions.
     APERTURE_T            m_Shape;          ///< shape ( Line, rectangle, circle , oval .. )
@@ -122,6 +126,7 @@ public:
     void AppendParam( double aValue )
     {
         m_am_params.push_back( aValue );
+        m_flashShapeValid = false;
     }
 
     /**
@@ -151,6 +156,7 @@ public:
     void SetMacro( APERTURE_MACRO* aMacro )
     {
         m_Macro = aMacro;
+        m_flashShapeValid = false;
     }
 
 
@@ -204,6 +210,17 @@ public:
      */
     void ConvertShapeToPolygon();
 
+    /**
+     * Function GetFlashShape
+     * returns the shape of the items flashed with this D_CODE, in draw (AB) coordinates
+     * and relative to the flash position, i.e. aParent->GetABPosition( aParent->m_Start ).
+     * This is the aperture macro shape for macros, and m_Polygon for other apertures.
+     * The shape is built once and shared by all the flashes: it is only rebuilt when the
+     * image axis (rotation, mirror, scale) of aParent differ from the previous call.
+     * @param aParent = a flashed GERBER_DRAW_ITEM using this D_CODE
+     */
+    const SHAPE_POLY_SET& GetFlashShape( const GERBER_DRAW_ITEM* aParent );
+
     /**
      * Function GetShapeDim
      * calculates a value that can be used to evaluate the size of text
@@ -93,6 +93,9 @@ END_EVENT_TABLE()
 void GERBVIEW_FRAME::OnSelectHighlightChoice( wxCommandEvent& event )
 {
     auto settings = static_cast<KIGFX::GERBVIEW_PAINTER*>( GetCanvas()->GetView()->GetPainter() )->GetSettings();
+    wxString prevComponent = settings->m_componentHighlightString;
+    wxString prevNet = settings->m_netHighlightString;
+    wxString prevAttribute = settings->m_attributeHighlightString;
 
     switch( event.GetId() )
     {
@@ -110,8 +113,7 @@ void GERBVIEW_FRAME::OnSelectHighlightChoice( wxCommandEvent& event )
 
     }
 
-    GetCanvas()->GetView()->UpdateAllItems( KIGFX::COLOR );
-    GetCanvas()->Refresh();
+    UpdateHighlightedItems( prevComponent, prevNet, prevAttribute );
 }
 
 
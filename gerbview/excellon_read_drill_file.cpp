@@ -263,30 +263,44 @@ bool GERBVIEW_FRAME::Read_EXCELLON_File( const wxString& aFullFileName )
         return false;
     }
 
-    layerId = images->AddGbrImage( drill_layer, layerId );
+    return attachExcellonImage( drill_layer );
+}
+
+
+bool GERBVIEW_FRAME::attachExcellonImage( EXCELLON_IMAGE* aDrillLayer )
+{
+    int layerId = GetActiveLayer();
+    GERBER_FILE_IMAGE_LIST* images = GetGerberLayout()->GetImagesList();
+
+    if( images->GetGbrImage( layerId ) )
+        Erase_Current_DrawLayer( false );
+
+    // The image can be read before knowing its layer
+    aDrillLayer->m_GraphicLayer = layerId;
+    layerId = images->AddGbrImage( aDrillLayer, layerId );
 
     if( layerId < 0 )
     {
-        delete drill_layer;
+        delete aDrillLayer;
         ShowInfoBarError( _( "No empty layers to load file into." ) );
         return false;
     }
 
     // Display errors list
-    if( drill_layer->GetMessages().size() > 0 )
+    if( aDrillLayer->GetMessages().size() > 0 )
     {
         HTML_MESSAGE_BOX dlg( this, _( "Error reading EXCELLON drill file" ) );
-        dlg.ListSet( drill_layer->GetMessages() );
+        dlg.ListSet( aDrillLayer->GetMessages() );
         dlg.ShowModal();
     }
 
     if( GetCanvas() )
     {
-        for( GERBER_DRAW_ITEM* item : drill_layer->GetItems() )
+        for( GERBER_DRAW_ITEM* item : aDrillLayer->GetItems() )
             GetCanvas()->GetView()->Add( (KIGFX::VIEW_ITEM*) item );
     }
 
-    return success;
+    return true;
 }
 
 /*
@@ -385,6 +399,8 @@ bool EXCELLON_IMAGE::LoadFile( const wxString & aFullFileName )
     delete m_FileFunction;
     m_FileFunction = new X2_ATTRIBUTE_FILEFUNCTION( dummy );
 
+    UpdateItemsTree();
+
     m_InUse = true;
 
     return true;
@@ -35,11 +35,95 @@
 #include <wildcards_and_files_ext.h>
 #include <widgets/progress_reporter.h>
 
+#include <atomic>
+#include <chrono>
+#include <thread>
+
 // HTML Messages used more than one time:
 #define MSG_NO_MORE_LAYER _( "<b>No more available layers</b> in Gerbview to load files" )
 #define MSG_NOT_LOADED    _( "\n<b>Not loaded:</b> <i>%s</i>" )
 
 
+/**
+ * Read a set of Gerber and Excellon files on several threads.
+ * The images are not put on a layer: the caller attaches them in the list order.
+ * @param aFullFileNames is the list of files to read.
+ * @param aIsDrillFile tells the files to read as Excellon drill files.
+ * @param aProgress is an optional progress reporter, advanced once per file.
+ * @return the image of each file, or nullptr for the files which cannot be read.
+ */
+static std::vector<GERBER_FILE_IMAGE*> readImages( const std::vector<wxString>& aFullFileNames,
+                                                   const std::vector<bool>& aIsDrillFile,
+                                                   PROGRESS_REPORTER* aProgress )
+{
+    std::vector<GERBER_FILE_IMAGE*> images( aFullFileNames.size(), nullptr );
+
+    if( aFullFileNames.empty() )
+        return images;
+
+    // Each reader switches to the C locale; keep it for the whole read so the user
+    // locale is not restored while other readers are running
+    LOCALE_IO toggleIo;
+
+    std::atomic<size_t> nextFile( 0 );
+    std::atomic<size_t> threadsFinished( 0 );
+
+    size_t parallelThreadCount = std::min<size_t>(
+            std::max<size_t>( std::thread::hardware_concurrency(), 2 ), aFullFileNames.size() );
+
+    for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+    {
+        std::thread t = std::thread( [&]()
+        {
+            for( size_t i = nextFile.fetch_add( 1 ); i < aFullFileNames.size();
+                 i = nextFile.fetch_add( 1 ) )
+            {
+                GERBER_FILE_IMAGE* image;
+                bool               success;
+
+                // The layer is set when the image is attached
+                if( aIsDrillFile[i] )
+                {
+                    EXCELLON_IMAGE* drill_layer = new EXCELLON_IMAGE( 0 );
+                    success = drill_layer->LoadFile( aFullFileNames[i] );
+                    image = drill_layer;
+                }
+                else
+                {
+                    image = new GERBER_FILE_IMAGE( 0 );
+                    success = image->LoadGerberFile( aFullFileNames[i] );
+                }
+
+                if( !success )
+                {
+                    delete image;
+                    image = nullptr;
+                }
+
+                images[i] = image;
+
+                if( aProgress )
+                    aProgress->AdvanceProgress();
+            }
+
+            threadsFinished++;
+        } );
+
+        t.detach();
+    }
+
+    while( threadsFinished < parallelThreadCount )
+    {
+        if( aProgress )
+            aProgress->KeepRefreshing();
+
+        std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+    }
+
+    return images;
+}
+
+
 void GERBVIEW_FRAME::OnGbrFileHistory( wxCommandEvent& event )
 {
     wxString fn;
@@ -210,8 +294,10 @@ bool GERBVIEW_FRAME::LoadListOfGerberAndDrillFiles( const wxString& aPath,
     wxString msg;
     WX_STRING_REPORTER reporter( &msg );
 
-    // Create progress dialog (only used if more than 1 file to load
-    std::unique_ptr<WX_PROGRESS_REPORTER> progress = nullptr;
+    // Check the files first: they are then all read at the same time, and attached
+    // to the layers in the list order
+    std::vector<wxString> fullFileNames;
+    std::vector<bool>     isDrillFile;
 
     for( unsigned ii = 0; ii < aFilenameList.GetCount(); ii++ )
     {
@@ -232,72 +318,90 @@ bool GERBVIEW_FRAME::LoadListOfGerberAndDrillFiles( const wxString& aPath,
             continue;
         }
 
-        m_lastFileName = filename.GetFullPath();
+        bool isDrill = aFileType && (*aFileType)[ii] == 1;
+
+        if( !isDrill && filename.GetExt() == GerberJobFileExtension.c_str() )
+        {
+            //We cannot read a gerber job file as a gerber plot file: skip it
+            wxString txt;
+            txt.Printf(
+                _( "<b>A gerber job file cannot be loaded as a plot file</b> <i>%s</i>" ),
+                filename.GetFullName() );
+            success = false;
+            reporter.Report( txt, RPT_SEVERITY_ERROR );
+            continue;
+        }
+
+        fullFileNames.push_back( filename.GetFullPath() );
+        isDrillFile.push_back( isDrill );
+    }
+
+    // Create progress dialog (only used if more than 1 file to load
+    std::unique_ptr<WX_PROGRESS_REPORTER> progress = nullptr;
+
+    if( fullFileNames.size() > 1 )
+    {
+        progress = std::make_unique<WX_PROGRESS_REPORTER>( this,
+                        _( "Loading Gerber files..." ), 1, false );
+        progress->SetMaxProgress( fullFileNames.size() );
+    }
+
+    std::vector<GERBER_FILE_IMAGE*> images = readImages( fullFileNames, isDrillFile,
+                                                         progress.get() );
+    progress.reset();
+
+    for( size_t ii = 0; ii < images.size(); ii++ )
+    {
+        m_lastFileName = fullFileNames[ii];
 
-        if( !progress && ( aFilenameList.GetCount() > 1 ) )
+        if( layer == NO_AVAILABLE_LAYERS )
         {
-            progress = std::make_unique<WX_PROGRESS_REPORTER>( this,
-                            _( "Loading Gerber files..." ), 1, false );
-            progress->SetMaxProgress( aFilenameList.GetCount() - 1 );
-            progress->Report( wxString::Format( _("Loading %u/%zu %s" ), ii+1,
-                                            aFilenameList.GetCount(), m_lastFileName ) );
+            // Report the name of not loaded files:
+            filename = m_lastFileName;
+            wxString txt = wxString::Format( MSG_NOT_LOADED, filename.GetFullName() );
+            reporter.Report( txt, RPT_SEVERITY_ERROR );
+            delete images[ii];
+            continue;
         }
-        else if( progress )
+
+        if( !images[ii] )
         {
-            progress->Report( wxString::Format( _("Loading %u/%zu %s" ), ii+1,
-                                            aFilenameList.GetCount(), m_lastFileName ) );
-            progress->KeepRefreshing();
+            wxString warning;
+            warning << "<b>" << _( "File not found:" ) << "</b><br>" << m_lastFileName << "<br>";
+            reporter.Report( warning, RPT_SEVERITY_WARNING );
+            success = false;
+            continue;
         }
 
         SetActiveLayer( layer, false );
 
         visibility[ layer ] = true;
 
-        if( aFileType && (*aFileType)[ii] == 1 )
+        if( isDrillFile[ii] )
         {
-            LoadExcellonFiles( filename.GetFullPath() );
-            layer = GetActiveLayer();   // Loading NC drill file changes the active layer
+            if( !attachExcellonImage( static_cast<EXCELLON_IMAGE*>( images[ii] ) ) )
+                continue;
+
+            // Update the list of recent drill files.
+            UpdateFileHistory( m_lastFileName, &m_drillFileHistory );
         }
         else
         {
-            if( filename.GetExt() == GerberJobFileExtension.c_str() )
-            {
-                //We cannot read a gerber job file as a gerber plot file: skip it
-                wxString txt;
-                txt.Printf(
-                    _( "<b>A gerber job file cannot be loaded as a plot file</b> <i>%s</i>" ),
-                    filename.GetFullName() );
-                success = false;
-                reporter.Report( txt, RPT_SEVERITY_ERROR );
-            }
-            else if( Read_GERBER_File( filename.GetFullPath() ) )
-            {
-                UpdateFileHistory( m_lastFileName );
-
-                layer = getNextAvailableLayer( layer );
+            attachGerberImage( images[ii] );
+            UpdateFileHistory( m_lastFileName );
+        }
 
-                if( layer == NO_AVAILABLE_LAYERS && ii < aFilenameList.GetCount()-1 )
-                {
-                    success = false;
-                    reporter.Report( MSG_NO_MORE_LAYER, RPT_SEVERITY_ERROR );
-
-                    // Report the name of not loaded files:
-                    ii += 1;
-                    while( ii < aFilenameList.GetCount() )
-                    {
-                        filename = aFilenameList[ii++];
-                        wxString txt = wxString::Format( MSG_NOT_LOADED, filename.GetFullName() );
-                        reporter.Report( txt, RPT_SEVERITY_ERROR );
-                    }
-                    break;
-                }
+        layer = getNextAvailableLayer( layer );
 
-                SetActiveLayer( layer, false );
-            }
+        if( layer == NO_AVAILABLE_LAYERS && ii < images.size() - 1 )
+        {
+            success = false;
+            reporter.Report( MSG_NO_MORE_LAYER, RPT_SEVERITY_ERROR );
+        }
+        else
+        {
+            SetActiveLayer( layer, false );
         }
-
-        if( progress )
-            progress->AdvanceProgress();
     }
 
     if( !success )
@@ -460,19 +564,17 @@ bool GERBVIEW_FRAME::unarchiveFiles( const wxString& aFullFileName, REPORTER* aR
     // Update the list of recent zip files.
     UpdateFileHistory( aFullFileName, &m_zipFileHistory );
 
-    // The unzipped file in only a temporary file. Give it a filename
-    // which cannot conflict with an usual filename.
-    // TODO: make Read_GERBER_File() and Read_EXCELLON_File() able to
-    // accept a stream, and avoid using a temp file.
-    wxFileName temp_fn( "$tempfile.tmp" );
-    temp_fn.MakeAbsolute( unzipDir );
-    wxString unzipped_tempfile = temp_fn.GetFullPath();
-
+    // The unzipped files are only temporary files. Give them filenames
+    // which cannot conflict with usual filenames.
+    // TODO: make GERBER_FILE_IMAGE::LoadGerberFile() and EXCELLON_IMAGE::LoadFile() able to
+    // accept a stream, and avoid using temp files.
+    std::vector<wxString> tempFileNames;
+    std::vector<wxString> entryNames;
+    std::vector<bool>     isDrillFile;
 
     bool success = true;
     wxZipInputStream zipArchive( zipFile );
     wxZipEntry* entry;
-    bool reported_no_more_layer = false;
 
     while( ( entry = zipArchive.GetNextEntry() ) )
     {
@@ -511,27 +613,9 @@ bool GERBVIEW_FRAME::unarchiveFiles( const wxString& aFullFileName, REPORTER* aR
             continue;
         }
 
-        int layer = GetActiveLayer();
-
-        if( layer == NO_AVAILABLE_LAYERS )
-        {
-            success = false;
-
-            if( aReporter )
-            {
-                if( !reported_no_more_layer )
-                    aReporter->Report( MSG_NO_MORE_LAYER,  RPT_SEVERITY_ERROR );
-
-                reported_no_more_layer = true;
-
-                // Report the name of not loaded files:
-                msg.Printf( MSG_NOT_LOADED, GetChars( entry->GetName() ) );
-                aReporter->Report( msg, RPT_SEVERITY_ERROR );
-            }
-
-            delete entry;
-            continue;
-        }
+        wxFileName temp_fn( wxString::Format( "$tempfile%zu.tmp", tempFileNames.size() ) );
+        temp_fn.MakeAbsolute( unzipDir );
+        wxString unzipped_tempfile = temp_fn.GetFullPath();
 
         // Create the unzipped temporary file:
         {
@@ -549,25 +633,56 @@ bool GERBVIEW_FRAME::unarchiveFiles( const wxString& aFullFileName, REPORTER* aR
                                 unzipped_tempfile );
                     aReporter->Report( msg, RPT_SEVERITY_ERROR );
                 }
+
+                delete entry;
+                continue;
             }
         }
 
-        bool read_ok = true;
+        tempFileNames.push_back( unzipped_tempfile );
+        entryNames.push_back( fname );
+        isDrillFile.push_back( curr_ext == "drl" );
 
-        if( curr_ext[0] == 'g' || curr_ext == "pho" )
-        {
-            // Read gerber files: each file is loaded on a new GerbView layer
-            read_ok = Read_GERBER_File( unzipped_tempfile );
-        }
-        else // if( curr_ext == "drl" )
+        delete entry;
+    }
+
+    // Read all the files at the same time, then attach them in the archive order
+    std::vector<GERBER_FILE_IMAGE*> images = readImages( tempFileNames, isDrillFile, nullptr );
+    bool reported_no_more_layer = false;
+
+    for( size_t ii = 0; ii < images.size(); ii++ )
+    {
+        // The unzipped file is only a temporary file, delete it.
+        wxRemoveFile( tempFileNames[ii] );
+
+        int layer = GetActiveLayer();
+
+        if( layer == NO_AVAILABLE_LAYERS )
         {
-            read_ok = Read_EXCELLON_File( unzipped_tempfile );
+            success = false;
+
+            if( aReporter )
+            {
+                if( !reported_no_more_layer )
+                    aReporter->Report( MSG_NO_MORE_LAYER,  RPT_SEVERITY_ERROR );
+
+                reported_no_more_layer = true;
+
+                // Report the name of not loaded files:
+                msg.Printf( MSG_NOT_LOADED, GetChars( entryNames[ii] ) );
+                aReporter->Report( msg, RPT_SEVERITY_ERROR );
+            }
+
+            delete images[ii];
+            continue;
         }
 
-        delete entry;
+        bool read_ok = images[ii] != nullptr;
 
-        // The unzipped file is only a temporary file, delete it.
-        wxRemoveFile( unzipped_tempfile );
+        if( read_ok && isDrillFile[ii] )
+            read_ok = attachExcellonImage( static_cast<EXCELLON_IMAGE*>( images[ii] ) );
+        else if( read_ok )
+            attachGerberImage( images[ii] );
 
         if( !read_ok )
         {
@@ -575,7 +690,7 @@ bool GERBVIEW_FRAME::unarchiveFiles( const wxString& aFullFileName, REPORTER* aR
 
             if( aReporter )
             {
-                msg.Printf( _("<b>unzipped file %s read error</b>\n"), unzipped_tempfile );
+                msg.Printf( _("<b>unzipped file %s read error</b>\n"), tempFileNames[ii] );
                 aReporter->Report( msg, RPT_SEVERITY_ERROR );
             }
         }
@@ -584,7 +699,7 @@ bool GERBVIEW_FRAME::unarchiveFiles( const wxString& aFullFileName, REPORTER* aR
             GERBER_FILE_IMAGE* gerber_image = GetGbrImage( layer );
 
             if( gerber_image )
-                gerber_image->m_FileName = fname;
+                gerber_image->m_FileName = entryNames[ii];
 
             layer = getNextAvailableLayer( layer );
             SetActiveLayer( layer, false );
@@ -365,10 +365,13 @@ const EDA_RECT GERBER_DRAW_ITEM::GetBoundingBox() const
     {
         if( code )
         {
-            // Update the shape drawings and the bounding box coordiantes:
-            code->GetMacro()->GetApertureMacroShape( this, m_Start );
-            // now the bounding box is valid:
-            bbox = code->GetMacro()->GetBoundingBox();
+            // The flash shape is shared by all the flashes of this D_CODE.  It is already
+            // in AB coordinates, so it must not go through the axis transform below
+            BOX2I bb = code->GetFlashShape( this ).BBox();
+            bb.Move( VECTOR2I( GetABPosition( m_Start ) ) );
+
+            return EDA_RECT( wxPoint( bb.GetX(), bb.GetY() ),
+                             wxSize( bb.GetWidth() + 1, bb.GetHeight() + 1 ) );
         }
         break;
     }
@@ -798,9 +801,8 @@ bool GERBER_DRAW_ITEM::HitTest( const wxPoint& aRefPos, int aAccuracy ) const
         return poly.Contains( VECTOR2I( ref_pos ), 0, aAccuracy );
 
     case GBR_SPOT_POLY:
-        poly = GetDcodeDescr()->m_Polygon;
-        poly.Move( VECTOR2I( m_Start ) );
-        return poly.Contains( VECTOR2I( ref_pos ), 0, aAccuracy );
+        // Test the D_CODE shape at its origin rather than moving a copy of it
+        return GetDcodeDescr()->m_Polygon.Contains( VECTOR2I( ref_pos - m_Start ), 0, aAccuracy );
 
     case GBR_SPOT_RECT:
         return GetBoundingBox().Contains( aRefPos );
@@ -876,9 +878,11 @@ bool GERBER_DRAW_ITEM::HitTest( const wxPoint& aRefPos, int aAccuracy ) const
         }
 
     case GBR_SPOT_MACRO:
-        // Aperture macro polygons are already in absolute coordinates
-        auto p = GetDcodeDescr()->GetMacro()->GetApertureMacroShape( this, m_Start );
-        return p->Contains( VECTOR2I( aRefPos ), -1, aAccuracy );
+    {
+        // The flash shape is in draw coordinates, relative to the flash position
+        const SHAPE_POLY_SET& shape = GetDcodeDescr()->GetFlashShape( this );
+        return shape.Contains( VECTOR2I( aRefPos - GetABPosition( m_Start ) ), -1, aAccuracy );
+    }
     }
 
     // TODO: a better analyze of the shape (perhaps create a D_CODE::HitTest for flashed items)
@@ -961,7 +965,7 @@ double GERBER_DRAW_ITEM::ViewGetLOD( int aLayer, KIGFX::VIEW* aView ) const
         switch( m_Shape )
         {
         case GBR_SPOT_MACRO:
-            size = GetDcodeDescr()->GetMacro()->GetBoundingBox().GetWidth();
+            size = GetDcodeDescr()->GetFlashShape( this ).BBox().GetWidth();
             break;
 
         case GBR_ARC:
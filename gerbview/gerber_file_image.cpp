@@ -400,6 +400,21 @@ void GERBER_FILE_IMAGE::RemoveAttribute( X2_ATTRIBUTE& aAttribute )
 }
 
 
+void GERBER_FILE_IMAGE::UpdateItemsTree()
+{
+    for( size_t ii = m_itemsTree.size(); ii < m_drawings.size(); ++ii )
+        m_itemsTree.Insert( m_drawings[ii] );
+}
+
+
+void GERBER_FILE_IMAGE::QueryItems( const EDA_RECT& aArea,
+                                    const std::function<bool( GERBER_DRAW_ITEM* )>& aVisitor )
+{
+    UpdateItemsTree();
+    m_itemsTree.Query( aArea, aVisitor );
+}
+
+
 SEARCH_RESULT GERBER_FILE_IMAGE::Visit( INSPECTOR inspector, void* testData, const KICAD_T scanTypes[] )
 {
     KICAD_T        stype;
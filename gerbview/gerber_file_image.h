@@ -30,6 +30,7 @@
 
 #include <dcode.h>
 #include <gerber_draw_item.h>
+#include <gerber_rtree.h>
 #include <am_primitive.h>
 #include <gbr_netlist_metadata.h>
 
@@ -114,6 +115,7 @@ class GERBER_FILE_IMAGE : public EDA_ITEM
 
     GERBER_LAYER       m_GBRLayerParams;                    // hold params for the current gerber layer
     GERBER_DRAW_ITEMS  m_drawings;                              // linked list of Gerber Items to draw
+    GERBER_RTREE       m_itemsTree;                             // spatial index of m_drawings
 
 public:
     bool               m_InUse;                                 // true if this image is currently in use
@@ -292,6 +294,25 @@ public:
         m_drawings.push_back( aItem );
     }
 
+    /**
+     * Function UpdateItemsTree
+     * adds to the spatial index the items added to the list since the last call.
+     * Items are not moved once created, so the index only grows with the list.
+     * It is called at the end of the file loading, and by QueryItems().
+     */
+    void UpdateItemsTree();
+
+    /**
+     * Function QueryItems
+     * calls aVisitor for each item of the image whose bounding box intersects aArea,
+     * using the spatial index rather than testing all the items.
+     * @param aArea = the area to search, in draw (AB) coordinates
+     * @param aVisitor = the function to call for each found item. It returns false
+     * to stop the search.
+     */
+    void QueryItems( const EDA_RECT& aArea,
+                     const std::function<bool( GERBER_DRAW_ITEM* )>& aVisitor );
+
     /**
      * @return the last GERBER_DRAW_ITEM* item of the items list
      */
@@ -0,0 +1,116 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef GERBER_RTREE_H
+#define GERBER_RTREE_H
+
+#include <functional>
+
+#include <eda_rect.h>
+#include <gerber_draw_item.h>
+
+#include <geometry/rtree.h>
+
+/**
+ * GERBER_RTREE
+ * Implements an R-tree for fast spatial indexing of the GERBER_DRAW_ITEMs of an image.
+ * Items are indexed by their bounding box, in draw (AB) coordinates.
+ * Non-owning.
+ */
+class GERBER_RTREE
+{
+private:
+    using gbr_rtree = RTree<GERBER_DRAW_ITEM*, int, 2, double>;
+
+public:
+    GERBER_RTREE()
+    {
+        m_tree  = new gbr_rtree();
+        m_count = 0;
+    }
+
+    ~GERBER_RTREE()
+    {
+        delete m_tree;
+    }
+
+    /**
+     * Function Insert()
+     * Inserts an item into the tree. Item's bounding box is taken via its GetBoundingBox()
+     * method.
+     */
+    void Insert( GERBER_DRAW_ITEM* aItem )
+    {
+        const EDA_RECT bbox    = aItem->GetBoundingBox();
+        const int      mmin[2] = { bbox.GetX(), bbox.GetY() };
+        const int      mmax[2] = { bbox.GetRight(), bbox.GetBottom() };
+
+        m_tree->Insert( mmin, mmax, aItem );
+        m_count++;
+    }
+
+    /**
+     * Function RemoveAll()
+     * Removes all items from the RTree
+     */
+    void RemoveAll()
+    {
+        m_tree->RemoveAll();
+        m_count = 0;
+    }
+
+    /**
+     * Function Query()
+     * Executes aVisitor for each item whose bounding box intersects with aArea.
+     * aVisitor returns false to stop the search.
+     */
+    void Query( const EDA_RECT& aArea,
+                const std::function<bool( GERBER_DRAW_ITEM* )>& aVisitor ) const
+    {
+        EDA_RECT  area = aArea;
+        area.Normalize();
+
+        const int mmin[2] = { area.GetX(), area.GetY() };
+        const int mmax[2] = { area.GetRight(), area.GetBottom() };
+
+        m_tree->Search( mmin, mmax,
+                        [&aVisitor]( GERBER_DRAW_ITEM* const& aItem )
+                        {
+                            return aVisitor( aItem );
+                        } );
+    }
+
+    /**
+     * @return the number of items in the tree
+     */
+    size_t size() const
+    {
+        return m_count;
+    }
+
+private:
+    gbr_rtree* m_tree;
+    size_t     m_count;
+};
+
+#endif  // GERBER_RTREE_H
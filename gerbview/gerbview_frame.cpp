@@ -634,6 +634,47 @@ void GERBVIEW_FRAME::UpdateDisplayOptions( const GBR_DISPLAY_OPTIONS& aOptions )
 }
 
 
+void GERBVIEW_FRAME::UpdateHighlightedItems( const wxString& aPrevComponent,
+                                             const wxString& aPrevNet,
+                                             const wxString& aPrevAttribute )
+{
+    auto view = GetCanvas()->GetView();
+    auto settings = static_cast<KIGFX::GERBVIEW_PAINTER*>( view->GetPainter() )->GetSettings();
+
+    // An item can only change of color if it matches one of the previous or new strings
+    auto matches = []( const wxString& aHighlight, const wxString& aValue )
+                   {
+                       return !aHighlight.IsEmpty() && aHighlight == aValue;
+                   };
+
+    view->UpdateAllItemsConditionally( KIGFX::COLOR, [&]( KIGFX::VIEW_ITEM* aItem )
+    {
+        auto item = dynamic_cast<GERBER_DRAW_ITEM*>( aItem );
+
+        if( !item )
+            return false;
+
+        const GBR_NETLIST_METADATA& netAttr = item->GetNetAttributes();
+
+        if( matches( aPrevComponent, netAttr.m_Cmpref )
+                || matches( settings->m_componentHighlightString, netAttr.m_Cmpref ) )
+            return true;
+
+        if( matches( aPrevNet, netAttr.m_Netname )
+                || matches( settings->m_netHighlightString, netAttr.m_Netname ) )
+            return true;
+
+        D_CODE* apertDescr = item->GetDcodeDescr();
+
+        return apertDescr && ( matches( aPrevAttribute, apertDescr->m_AperFunction )
+                    || matches( settings->m_attributeHighlightString,
+                                apertDescr->m_AperFunction ) );
+    } );
+
+    GetCanvas()->Refresh();
+}
+
+
 void GERBVIEW_FRAME::UpdateTitleAndInfo()
 {
     GERBER_FILE_IMAGE* gerber = GetGbrImage( GetActiveLayer() );
@@ -37,6 +37,7 @@
 #define NO_AVAILABLE_LAYERS UNDEFINED_LAYER
 
 class DCODE_SELECTION_BOX;
+class EXCELLON_IMAGE;
 class GERBER_LAYER_WIDGET;
 class GBR_LAYER_BOX_SELECTOR;
 class GERBER_DRAW_ITEM;
@@ -196,6 +197,19 @@ private:
     /// Updates the GAL with display settings changes
     void applyDisplaySettingsToGAL();
 
+    /**
+     * Put a Gerber image read from a file on the active layer, replacing the current image
+     * of this layer, show its errors and add its items to the view.
+     */
+    void attachGerberImage( GERBER_FILE_IMAGE* aGerber );
+
+    /**
+     * Put a drill image read from an Excellon file on the active layer, like
+     * attachGerberImage().
+     * @return false if the image cannot be put on a layer; it is then deleted.
+     */
+    bool attachExcellonImage( EXCELLON_IMAGE* aDrillLayer );
+
 public:
     GERBVIEW_FRAME( KIWAY* aKiway, wxWindow* aParent );
     ~GERBVIEW_FRAME();
@@ -391,6 +405,16 @@ public:
     /// Handles the changing of the highlighted component/net/attribute
     void OnSelectHighlightChoice( wxCommandEvent& event );
 
+    /**
+     * Updates the color of the items after a change of the highlighted component, net or
+     * aperture attribute. Only the items matching the previous or the new highlight strings
+     * are updated, not all the items of all the images.
+     * @param aPrevComponent, aPrevNet, aPrevAttribute = the highlight strings of the render
+     * settings before the change
+     */
+    void UpdateHighlightedItems( const wxString& aPrevComponent, const wxString& aPrevNet,
+                                 const wxString& aPrevAttribute );
+
     /**
      * Function OnSelectActiveDCode
      * Selects the active DCode for the current active layer.
@@ -426,7 +426,7 @@ void GERBVIEW_PAINTER::draw( /*const*/ GERBER_DRAW_ITEM* aItem, int aLayer )
 
 
 void GERBVIEW_PAINTER::drawPolygon(
-        GERBER_DRAW_ITEM* aParent, const SHAPE_POLY_SET& aPolygon, bool aFilled, bool aShift )
+        GERBER_DRAW_ITEM* aParent, const SHAPE_POLY_SET& aPolygon, bool aFilled )
 {
     wxASSERT( aPolygon.OutlineCount() == 1 );
 
@@ -436,10 +436,9 @@ void GERBVIEW_PAINTER::drawPolygon(
     SHAPE_POLY_SET poly;
     poly.NewOutline();
     const std::vector<VECTOR2I> pts = aPolygon.COutline( 0 ).CPoints();
-    VECTOR2I       offset = aShift ? VECTOR2I( aParent->m_Start ) : VECTOR2I( 0, 0 );
 
     for( auto& pt : pts )
-        poly.Append( aParent->GetABPosition( pt + offset ) );
+        poly.Append( aParent->GetABPosition( pt ) );
 
     if( !m_gerbviewSettings.m_polygonFill )
         m_gal->SetLineWidth( m_gerbviewSettings.m_outlineWidth );
@@ -479,10 +478,7 @@ void GERBVIEW_PAINTER::drawFlashedShape( GERBER_DRAW_ITEM* aItem, bool aFilled )
         }
         else    // rectangular hole
         {
-            if( code->m_Polygon.OutlineCount() == 0 )
-                code->ConvertShapeToPolygon();
-
-            drawPolygon( aItem, code->m_Polygon, aFilled, true );
+            drawFlashedPolygon( aItem, aFilled );
         }
 
         break;
@@ -504,10 +500,7 @@ void GERBVIEW_PAINTER::drawFlashedShape( GERBER_DRAW_ITEM* aItem, bool aFilled )
         }
         else
         {
-            if( code->m_Polygon.OutlineCount() == 0 )
-                code->ConvertShapeToPolygon();
-
-            drawPolygon( aItem, code->m_Polygon, aFilled, true );
+            drawFlashedPolygon( aItem, aFilled );
         }
         break;
     }
@@ -543,25 +536,14 @@ void GERBVIEW_PAINTER::drawFlashedShape( GERBER_DRAW_ITEM* aItem, bool aFilled )
         }
         else
         {
-            if( code->m_Polygon.OutlineCount() == 0 )
-                code->ConvertShapeToPolygon();
-
-            drawPolygon( aItem, code->m_Polygon, aFilled, true );
+            drawFlashedPolygon( aItem, aFilled );
         }
         break;
     }
 
     case GBR_SPOT_POLY:
-    {
-        if( code->m_Polygon.OutlineCount() == 0 )
-            code->ConvertShapeToPolygon();
-
-        drawPolygon( aItem, code->m_Polygon, aFilled, true );
-        break;
-    }
-
     case GBR_SPOT_MACRO:
-        drawApertureMacro( aItem, aFilled );
+        drawFlashedPolygon( aItem, aFilled );
         break;
 
     default:
@@ -571,23 +553,30 @@ void GERBVIEW_PAINTER::drawFlashedShape( GERBER_DRAW_ITEM* aItem, bool aFilled )
 }
 
 
-void GERBVIEW_PAINTER::drawApertureMacro( GERBER_DRAW_ITEM* aParent, bool aFilled )
+void GERBVIEW_PAINTER::drawFlashedPolygon( GERBER_DRAW_ITEM* aItem, bool aFilled )
 {
-    D_CODE* code = aParent->GetDcodeDescr();
-    APERTURE_MACRO* macro = code->GetMacro();
+    // All the flashes of a D_CODE share the same shape: it is only translated to the
+    // flash position, and its triangulation is reused
+    const SHAPE_POLY_SET& shape = aItem->GetDcodeDescr()->GetFlashShape( aItem );
 
-    SHAPE_POLY_SET* macroShape = macro->GetApertureMacroShape( aParent, aParent->m_Start );
+    if( shape.OutlineCount() == 0 )
+        return;
 
     if( !m_gerbviewSettings.m_polygonFill )
         m_gal->SetLineWidth( m_gerbviewSettings.m_outlineWidth );
 
+    m_gal->Save();
+    m_gal->Translate( VECTOR2D( aItem->GetABPosition( aItem->m_Start ) ) );
+
     if( !aFilled )
     {
-        for( int i = 0; i < macroShape->OutlineCount(); i++ )
-            m_gal->DrawPolyline( macroShape->COutline( i ) );
+        for( int i = 0; i < shape.OutlineCount(); i++ )
+            m_gal->DrawPolyline( shape.COutline( i ) );
     }
     else
-        m_gal->DrawPolygon( *macroShape );
+        m_gal->DrawPolygon( shape );
+
+    m_gal->Restore();
 }
 
 
@@ -195,16 +195,16 @@ protected:
      * @param aParent Pointer to the draw item for AB Position calculation
      * @param aPolygon the polygon to draw
      * @param aFilled If true, draw the polygon as filled, otherwise only outline
-     * @param aShift If true, draw the polygon relative to the parent item position
      */
     void drawPolygon( GERBER_DRAW_ITEM* aParent, const SHAPE_POLY_SET& aPolygon,
-                      bool aFilled, bool aShift = false );
+                      bool aFilled );
 
     /// Helper to draw a flashed shape (aka spot)
     void drawFlashedShape( GERBER_DRAW_ITEM* aItem, bool aFilled );
 
-    /// Helper to draw an aperture macro shape
-    void drawApertureMacro( GERBER_DRAW_ITEM* aParent, bool aFilled );
+    /// Helper to draw a flashed shape stored as a polygon by its D_CODE (macros,
+    /// polygons and apertures with a hole)
+    void drawFlashedPolygon( GERBER_DRAW_ITEM* aItem, bool aFilled );
 
     /**
      * Function getLineThickness()
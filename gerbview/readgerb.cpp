@@ -32,6 +32,8 @@
 #include <html_messagebox.h>
 #include <macros.h>
 
+#include <memory>
+
 /* Read a gerber file, RS274D, RS274X or RS274X2 format.
  */
 bool GERBVIEW_FRAME::Read_GERBER_File( const wxString& GERBER_FullFileName )
@@ -39,7 +41,6 @@ bool GERBVIEW_FRAME::Read_GERBER_File( const wxString& GERBER_FullFileName )
     wxString msg;
 
     int layer = GetActiveLayer();
-    GERBER_FILE_IMAGE_LIST* images = GetImagesList();
     GERBER_FILE_IMAGE* gerber = GetGbrImage( layer );
 
     if( gerber != NULL )
@@ -61,13 +62,31 @@ bool GERBVIEW_FRAME::Read_GERBER_File( const wxString& GERBER_FullFileName )
         return false;
     }
 
-    images->AddGbrImage( gerber, layer );
+    attachGerberImage( gerber );
+
+    return true;
+}
+
+
+void GERBVIEW_FRAME::attachGerberImage( GERBER_FILE_IMAGE* aGerber )
+{
+    wxString msg;
+
+    int layer = GetActiveLayer();
+    GERBER_FILE_IMAGE_LIST* images = GetImagesList();
+
+    if( GetGbrImage( layer ) != NULL )
+        Erase_Current_DrawLayer( false );
+
+    // The image can be read before knowing its layer
+    aGerber->m_GraphicLayer = layer;
+    images->AddGbrImage( aGerber, layer );
 
     // Display errors list
-    if( gerber->GetMessages().size() > 0 )
+    if( aGerber->GetMessages().size() > 0 )
     {
         HTML_MESSAGE_BOX dlg( this, _("Errors") );
-        dlg.ListSet(gerber->GetMessages());
+        dlg.ListSet(aGerber->GetMessages());
         dlg.ShowModal();
     }
 
@@ -76,9 +95,9 @@ bool GERBVIEW_FRAME::Read_GERBER_File( const wxString& GERBER_FullFileName )
      * or has missing definitions,
      * warn the user:
      */
-    if( gerber->GetItemsCount() && gerber->m_Has_MissingDCode )
+    if( aGerber->GetItemsCount() && aGerber->m_Has_MissingDCode )
     {
-        if( !gerber->m_Has_DCode )
+        if( !aGerber->m_Has_DCode )
             msg = _("Warning: this file has no D-Code definition\n"
                     "Therefore the size of some items is undefined");
         else
@@ -90,17 +109,15 @@ bool GERBVIEW_FRAME::Read_GERBER_File( const wxString& GERBER_FullFileName )
 
     if( GetCanvas() )
     {
-        if( gerber->m_ImageNegative )
+        if( aGerber->m_ImageNegative )
         {
             // TODO: find a way to handle negative images
             // (maybe convert geometry into positives?)
         }
 
-        for( auto item : gerber->GetItems() )
+        for( auto item : aGerber->GetItems() )
             GetCanvas()->GetView()->Add( (KIGFX::VIEW_ITEM*) item );
     }
-
-    return true;
 }
 
 
@@ -108,8 +125,6 @@ bool GERBVIEW_FRAME::Read_GERBER_File( const wxString& GERBER_FullFileName )
 // size of a single line of text from a gerber file.
 // warning: some files can have *very long* lines, so the buffer must be large.
 #define GERBER_BUFZ 1000000
-// A large buffer to store one line
-static char lineBuffer[GERBER_BUFZ+1];
 
 bool GERBER_FILE_IMAGE::LoadGerberFile( const wxString& aFullFileName )
 {
@@ -117,6 +132,10 @@ bool GERBER_FILE_IMAGE::LoadGerberFile( const wxString& aFullFileName )
     int      D_commande = 0;       // command number for D commands like D02
     char*    text;
 
+    // A large buffer to store one line. It is owned by this call, so several files
+    // can be read at the same time
+    std::unique_ptr<char[]> lineBuffer( new char[GERBER_BUFZ + 1] );
+
     ClearMessageList( );
     ResetDefaultValues();
 
@@ -134,11 +153,11 @@ bool GERBER_FILE_IMAGE::LoadGerberFile( const wxString& aFullFileName )
 
     while( true )
     {
-        if( fgets( lineBuffer, GERBER_BUFZ, m_Current_File ) == NULL )
+        if( fgets( lineBuffer.get(), GERBER_BUFZ, m_Current_File ) == NULL )
             break;
 
         m_LineNum++;
-        text = StrPurge( lineBuffer );
+        text = StrPurge( lineBuffer.get() );
 
         while( text && *text )
         {
@@ -195,7 +214,7 @@ bool GERBER_FILE_IMAGE::LoadGerberFile( const wxString& aFullFileName )
                 if( m_CommandState != ENTER_RS274X_CMD )
                 {
                     m_CommandState = ENTER_RS274X_CMD;
-                    ReadRS274XCommand( lineBuffer, GERBER_BUFZ, text );
+                    ReadRS274XCommand( lineBuffer.get(), GERBER_BUFZ, text );
                 }
                 else        //Error
                 {
@@ -216,6 +235,9 @@ bool GERBER_FILE_IMAGE::LoadGerberFile( const wxString& aFullFileName )
 
     fclose( m_Current_File );
 
+    // Index the items now: this is done on the loader thread, not at the first click
+    UpdateItemsTree();
+
     m_InUse = true;
 
     return true;
@@ -134,8 +134,8 @@ void fillFlashedGBRITEM(  GERBER_DRAW_ITEM* aGbrItem,
     case APT_MACRO:
         aGbrItem->m_Shape = GBR_SPOT_MACRO;
 
-        // Cache the bounding box for aperture macros
-        aGbrItem->GetDcodeDescr()->GetMacro()->GetApertureMacroShape( aGbrItem, aPos );
+        // Build the flash shape shared by all the flashes of this aperture macro
+        aGbrItem->GetDcodeDescr()->GetFlashShape( aGbrItem );
         break;
     }
 }
@@ -337,7 +337,7 @@ static void fillArcPOLY(  GERBER_DRAW_ITEM* aGbrItem,
     /* in order to calculate arc parameters, we use fillArcGBRITEM
      * so we muse create a dummy track and use its geometric parameters
      */
-    static GERBER_DRAW_ITEM dummyGbrItem( NULL );
+    GERBER_DRAW_ITEM dummyGbrItem( NULL );
 
     aGbrItem->SetLayerPolarity( aLayerNegative );
 
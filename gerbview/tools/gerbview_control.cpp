@@ -151,6 +151,9 @@ int GERBVIEW_CONTROL::HighlightControl( const TOOL_EVENT& aEvent )
     auto settings = static_cast<KIGFX::GERBVIEW_PAINTER*>( getView()->GetPainter() )->GetSettings();
     const auto& selection = m_toolMgr->GetTool<GERBVIEW_SELECTION_TOOL>()->GetSelection();
     GERBER_DRAW_ITEM* item = nullptr;
+    wxString prevComponent = settings->m_componentHighlightString;
+    wxString prevNet = settings->m_netHighlightString;
+    wxString prevAttribute = settings->m_attributeHighlightString;
 
     if( selection.Size() == 1 )
     {
@@ -190,8 +193,7 @@ int GERBVIEW_CONTROL::HighlightControl( const TOOL_EVENT& aEvent )
         }
     }
 
-    canvas()->GetView()->UpdateAllItems( KIGFX::COLOR );
-    canvas()->Refresh();
+    m_frame->UpdateHighlightedItems( prevComponent, prevNet, prevAttribute );
 
     return 0;
 }
@@ -147,6 +147,12 @@ public:
      */
     bool m_SkipBoundingBoxOnFpLoad;
 
+    /**
+     * Split the Cairo canvas into horizontal tiles and rasterize cached layers on several
+     * threads.
+     */
+    bool m_CairoTiledRendering;
+
 private:
     ADVANCED_CFG();
 
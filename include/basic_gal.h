@@ -118,6 +118,12 @@ public:
      */
     virtual void DrawPolyline( const std::deque<VECTOR2D>& aPointList ) override;
 
+    /**
+     * @brief Draw multiple polylines (used by the stroke font to draw a text line)
+     * @param aPointLists are the polylines to be drawn.
+     */
+    virtual void DrawPolylines( const std::vector<std::vector<VECTOR2D>>& aPointLists ) override;
+
     /** Start and end points are defined as 2D-Vectors.
      * @param aStartPoint   is the start point of the line.
      * @param aEndPoint     is the end point of the line.
@@ -149,6 +155,9 @@ private:
     // Apply the roation/translation transform to aPoint
     const VECTOR2D transform( const VECTOR2D& aPoint ) const;
 
+    // Draws a polyline given in already transformed coordinates
+    void doDrawPolyline( const std::vector<wxPoint>& aCorners );
+
     // A clip box, to clip drawings in a wxDC (mandatory to avoid draw issues)
     EDA_RECT  m_clipBox;        // The clip box
     bool      m_isClipped;      // Allows/disallows clipping
@@ -165,6 +174,7 @@ private:
 };
 
 
-extern BASIC_GAL basic_gal;
+/// One instance per thread: its state is set by each text conversion, so it is not shared.
+extern thread_local BASIC_GAL basic_gal;
 
 #endif      // define BASIC_GAL_H
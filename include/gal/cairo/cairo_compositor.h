@@ -108,6 +108,19 @@ public:
         cairo_get_matrix( m_mainContext, &m_matrix );
     }
 
+    /**
+     * Function CreateTileContext()
+     * creates a context drawing to a horizontal band of rows of the current buffer. The context
+     * uses the current transformation matrix shifted by the band offset, so the same commands
+     * render the same pixels as with the buffer context. Contexts created for disjoint bands do
+     * not share any pixel storage and may be used from different threads.
+     *
+     * @param aTop is the first row of the band.
+     * @param aHeight is the number of rows in the band.
+     * @return the new context, to be released by the caller with cairo_destroy().
+     */
+    cairo_t* CreateTileContext( unsigned int aTop, unsigned int aHeight );
+
 protected:
     typedef uint32_t* BitmapPtr;
     typedef struct
@@ -311,6 +311,44 @@ protected:
     void flushPath();
     void storePath();                           ///< Store the actual path
 
+    /// Drawing attributes modified by the commands stored in groups
+    struct GROUP_STATE
+    {
+        bool    isFill;
+        bool    isStroke;
+        COLOR4D fillColor;
+        COLOR4D strokeColor;
+    };
+
+    /**
+     * Executes the commands stored in a group.  Only \a aContext and \a aState are modified,
+     * so a group may be replayed to several contexts at once.
+     *
+     * @param aContext is the Cairo context to draw to.
+     * @param aState holds the drawing attributes, updated by the replayed commands.
+     * @param aGroupNumber is the group to replay.
+     */
+    void replayGroup( cairo_t* aContext, GROUP_STATE& aState, int aGroupNumber ) const;
+
+    /**
+     * Computes the device space rows covered by a group without drawing it.  \a aContext and
+     * \a aState are updated as replayGroup() would do.
+     *
+     * @param aContext is the Cairo context providing the transformation and line width.
+     * @param aState holds the drawing attributes, updated by the group commands.
+     * @param aGroupNumber is the group to measure.
+     * @param aTop is lowered to the topmost row touched by the group.
+     * @param aBottom is raised to the bottommost row touched by the group.
+     */
+    void groupExtents( cairo_t* aContext, GROUP_STATE& aState, int aGroupNumber,
+                       double& aTop, double& aBottom ) const;
+
+    /**
+     * Draws the groups whose rasterization was deferred.  Called before any immediate mode
+     * drawing, so the deferred groups stay below everything issued after them.
+     */
+    virtual void drawPendingGroups() {}
+
     /**
      * @brief Blits cursor into the current screen.
      */
@@ -376,6 +414,8 @@ public:
 
     void EndGroup() override;
 
+    void DrawGroup( int aGroupNumber ) override;
+
     void SetTarget( RENDER_TARGET aTarget ) override;
 
     RENDER_TARGET GetTarget() const override;
@@ -408,6 +448,10 @@ protected:
     RENDER_TARGET           currentTarget;          ///< Current rendering target
     bool                    validCompositor;        ///< Compositor initialization flag
 
+    // Tiled rendering of the cached target
+    bool                    tiledRendering;         ///< Rasterize cached groups in tiles
+    std::vector<int>        pendingGroups;          ///< Groups waiting to be rasterized
+
     // Variables related to wxWidgets
     wxWindow*               parentWindow;           ///< Parent window
     wxEvtHandler*           mouseListener;          ///< Mouse listener
@@ -443,6 +487,13 @@ protected:
     /// Prepare the compositor
     void setCompositor();
 
+    /**
+     * Rasterize the groups collected by DrawGroup() in tiled mode.  The current buffer is split
+     * into horizontal bands that are drawn on separate threads; each band replays the pending
+     * groups that intersect its own rows.
+     */
+    void drawPendingGroups() override;
+
     // Event handlers
     /**
      * @brief Paint event handler.
@@ -115,6 +115,22 @@ public:
     virtual void DrawPolyline( const VECTOR2D aPointList[], int aListSize ) {};
     virtual void DrawPolyline( const SHAPE_LINE_CHAIN& aLineChain ) {};
 
+    /**
+     * @brief Draw multiple polylines at once, e.g. all the strokes of a text line.
+     *
+     * Backends may override it to submit the whole set in a single batch.
+     *
+     * @param aPointLists are the polylines to be drawn.
+     */
+    virtual void DrawPolylines( const std::vector<std::vector<VECTOR2D>>& aPointLists )
+    {
+        for( const std::vector<VECTOR2D>& pointList : aPointLists )
+        {
+            if( pointList.size() >= 2 )
+                DrawPolyline( pointList.data(), pointList.size() );
+        }
+    }
+
     /**
      * @brief Draw a circle using world coordinates.
      *
@@ -138,6 +138,9 @@ public:
     void DrawPolyline( const VECTOR2D aPointList[], int aListSize ) override;
     void DrawPolyline( const SHAPE_LINE_CHAIN& aLineChain ) override;
 
+    /// @copydoc GAL::DrawPolylines()
+    void DrawPolylines( const std::vector<std::vector<VECTOR2D>>& aPointLists ) override;
+
     /// @copydoc GAL::DrawPolygon()
     void DrawPolygon( const std::deque<VECTOR2D>& aPointList ) override;
     void DrawPolygon( const VECTOR2D aPointList[], int aListSize ) override;
@@ -358,8 +361,11 @@ private:
      *
      * @param aStartPoint is the start point of the line.
      * @param aEndPoint is the end point of the line.
+     * @param aReserve tells whether vertex space has to be reserved for the quad, or it has
+     *                 already been reserved by the caller.
      */
-    void drawLineQuad( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint );
+    void drawLineQuad( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint,
+                       bool aReserve = true );
 
     /**
      * @brief Draw a semicircle. Depending on settings (isStrokeEnabled & isFilledEnabled) it runs
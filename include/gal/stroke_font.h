@@ -31,6 +31,10 @@
 
 #include <deque>
 #include <algorithm>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
 
 #include <utf8.h>
 
@@ -45,6 +49,16 @@ class GAL;
 typedef std::vector<std::vector<VECTOR2D>*> GLYPH;
 typedef std::vector<GLYPH*>                 GLYPH_LIST;
 
+/**
+ * Transformed stroke geometry of a single line of text, in coordinates local to the line
+ * origin (i.e. before justification is applied).
+ */
+struct GLYPH_RUN
+{
+    std::vector<std::vector<VECTOR2D>> m_strokes;     ///< Glyph strokes, overbars and underlines
+    VECTOR2D                           m_size;        ///< Text line size
+};
+
 /**
  * @brief Class STROKE_FONT implements stroke font drawing.
  *
@@ -110,13 +124,70 @@ public:
      */
     static double GetInterline( double aGlyphHeight );
 
-
+    /**
+     * Drops all cached glyph runs and string sizes.
+     */
+    void ClearCache();
 
 private:
+    /**
+     * Key used to look up cached glyph runs and string sizes.  Everything that changes the
+     * stroke geometry of a text line (but not its placement) is part of the key.
+     */
+    struct RUN_KEY
+    {
+        std::string m_text;
+        VECTOR2D    m_glyphSize;
+        double      m_thickness;
+        int         m_flags;
+
+        bool operator==( const RUN_KEY& aOther ) const
+        {
+            return m_flags == aOther.m_flags && m_thickness == aOther.m_thickness
+                   && m_glyphSize == aOther.m_glyphSize && m_text == aOther.m_text;
+        }
+    };
+
+    struct RUN_KEY_HASH
+    {
+        std::size_t operator()( const RUN_KEY& aKey ) const;
+    };
+
+    /**
+     * @brief Builds the cache key for a text line using the current GAL text attributes.
+     */
+    RUN_KEY makeRunKey( const std::string& aText, const VECTOR2D& aGlyphSize,
+                        double aGlyphThickness ) const;
+
+    /**
+     * @brief Returns the (possibly cached) transformed geometry of a single line of text.
+     * The run is shared with the cache, so it stays valid if the cache is flushed.
+     *
+     * @param aText is the text string (one line).
+     */
+    std::shared_ptr<const GLYPH_RUN> getGlyphRun( const UTF8& aText );
+
+    /**
+     * @brief Computes the transformed geometry of a single line of text.
+     *
+     * @param aText is the text string (one line).
+     * @param aRun is the run to be filled.
+     */
+    void buildGlyphRun( const UTF8& aText, GLYPH_RUN& aRun ) const;
+
     GAL*                      m_gal;                  ///< Pointer to the GAL
     const GLYPH_LIST*         m_glyphs;               ///< Glyph list
     const std::vector<BOX2D>* m_glyphBoundingBoxes;   ///< Bounding boxes of the glyphs
 
+    ///> Cache of transformed text lines
+    std::unordered_map<RUN_KEY, std::shared_ptr<const GLYPH_RUN>, RUN_KEY_HASH> m_runCache;
+
+    ///> Cache of string boundary limits
+    mutable std::unordered_map<RUN_KEY, VECTOR2D, RUN_KEY_HASH>    m_sizeCache;
+
+    ///> Guards both caches: the font of BASIC_GAL is shared by the threads computing text sizes
+    mutable std::mutex m_cacheMutex;
+
     /**
      * @brief Compute the X and Y size of a given text. The text is expected to be
      * a only one line text.
@@ -182,6 +253,9 @@ private:
 
     ///> Factor that determines the pitch between 2 lines.
     static const double INTERLINE_PITCH_RATIO;
+
+    ///> Maximum number of entries kept in each of the caches before they are flushed.
+    static const size_t MAX_CACHE_ENTRIES;
 };
 } // namespace KIGFX
 
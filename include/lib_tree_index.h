@@ -0,0 +1,155 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef LIB_TREE_INDEX_H
+#define LIB_TREE_INDEX_H
+
+#include <lib_tree_item.h>
+
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+
+/**
+ * A persistent index of the items of a set of libraries.
+ *
+ * It stores what the library tree needs to show and search the items of each library (names,
+ * descriptions, keywords, units, pad count and fields), so a chooser can be filled without
+ * parsing the libraries.  Each library is stored with a timestamp given by its library table;
+ * the entries of a library are only used when the timestamp still matches.  The full items are
+ * then loaded from their library on demand, from their LIB_ID.
+ *
+ * The index is saved in a versioned binary file; a file of another version is ignored.
+ */
+class APIEXPORT LIB_TREE_INDEX
+{
+public:
+    /**
+     * The indexed metadata of a library item.  It can be added to a LIB_TREE_MODEL in place
+     * of the library item itself.
+     */
+    class APIEXPORT ITEM : public LIB_TREE_ITEM
+    {
+    public:
+        ITEM() :
+                m_isRoot( true ),
+                m_isPower( false ),
+                m_padCount( 0 )
+        {}
+
+        /**
+         * Copy the tree metadata (name, description, search text, units) of \a aItem.
+         */
+        ITEM( LIB_TREE_ITEM* aItem );
+
+        LIB_ID GetLibId() const override { return m_libId; }
+
+        wxString GetName() const override { return m_libId.GetLibItemName(); }
+        wxString GetLibNickname() const override { return m_libId.GetLibNickname(); }
+
+        wxString GetDescription() override { return m_description; }
+
+        wxString GetSearchText() override { return m_searchText; }
+
+        bool IsRoot() const override { return m_isRoot; }
+
+        int GetUnitCount() const override { return (int) m_unitReferences.size(); }
+
+        wxString GetUnitReference( int aUnit ) override;
+
+        LIB_ID    m_libId;
+        wxString  m_description;
+        wxString  m_keywords;
+        wxString  m_searchText;
+        bool      m_isRoot;
+        bool      m_isPower;           ///< a power symbol
+        unsigned  m_padCount;          ///< pads of a footprint, pins of a symbol
+
+        std::vector<wxString>                       m_unitReferences;   ///< one per unit
+        std::vector<std::pair<wxString, wxString>>  m_fields;           ///< name, text
+    };
+
+    /**
+     * The indexed items of a library.
+     */
+    struct LIBRARY
+    {
+        long long                           m_Timestamp;
+        std::vector<std::unique_ptr<ITEM>>  m_Items;
+    };
+
+    LIB_TREE_INDEX() :
+            m_modified( false )
+    {}
+
+    /**
+     * Replace the index by the content of \a aFileName.
+     * A missing, damaged or outdated file gives an empty index.
+     *
+     * @return true if the file was read.
+     */
+    bool Load( const wxString& aFileName );
+
+    /**
+     * Write the index to \a aFileName.
+     *
+     * @return true on success.
+     */
+    bool Save( const wxString& aFileName ) const;
+
+    /**
+     * @return the indexed library \a aNickname, or nullptr if it is not indexed or if its
+     *         index is older than \a aTimestamp.
+     */
+    const LIBRARY* FindLibrary( const wxString& aNickname, long long aTimestamp ) const;
+
+    /**
+     * Start the index of the library \a aNickname, replacing the previous one.
+     *
+     * @return the library, with no item, to add the items to.
+     */
+    LIBRARY& SetLibrary( const wxString& aNickname, long long aTimestamp );
+
+    /**
+     * Remove the libraries which are not in \a aNicknames.
+     */
+    void KeepLibraries( const std::vector<wxString>& aNicknames );
+
+    /**
+     * @return true if the index was changed since it was loaded.
+     */
+    bool IsModified() const { return m_modified; }
+
+    size_t GetLibraryCount() const { return m_libraries.size(); }
+
+    static const unsigned INDEX_VERSION;
+
+private:
+    std::map<wxString, LIBRARY> m_libraries;
+    bool                        m_modified;
+};
+
+
+#endif // LIB_TREE_INDEX_H
@@ -104,6 +104,24 @@ public:
      */
     virtual bool Draw( const VIEW_ITEM* aItem, int aLayer ) = 0;
 
+    /**
+     * Function Prepare
+     * Computes the drawing-independent data of an item (e.g. effective shapes or polygon
+     * triangulations) ahead of Draw(), so that Draw() only has to emit the primitives.
+     * The VIEW calls it from worker threads for many items at once, so implementations must
+     * not use the GAL and must only modify the item they are given.
+     * @param aItem is an item that is going to be drawn.
+     */
+    virtual void Prepare( const VIEW_ITEM* aItem ) {}
+
+    /**
+     * Function GetDetailLevel
+     * Returns the level of detail used to draw items at the current GAL scale.  The VIEW caches
+     * items separately for every level, so painters may simplify small objects when zoomed out.
+     * @return 0 for full detail, higher values for coarser drawing.
+     */
+    virtual int GetDetailLevel() const { return 0; }
+
 protected:
     /// Instance of graphic abstraction layer that gives an interface to call
     /// commands used to draw (eg. DrawLine, DrawCircle, etc.)
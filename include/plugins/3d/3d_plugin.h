@@ -131,4 +131,15 @@ KICAD_PLUGIN_EXPORT bool CanRender( void );
  */
 KICAD_PLUGIN_EXPORT SCENEGRAPH* Load( char const* aFileName );
 
+/**
+ * Function CanLoadConcurrently
+ *
+ * This function is optional; plugins which do not export it are never
+ * called from more than one thread at a time.
+ *
+ * @return true if Load() may be called from several threads at once,
+ * that is the plugin uses no global state while reading a model
+ */
+KICAD_PLUGIN_EXPORT bool CanLoadConcurrently( void );
+
 #endif  // PLUGIN_3D_H
@@ -774,8 +774,39 @@ protected:
     /// Updates colors that are used for an item to be drawn
     void updateItemColor( VIEW_ITEM* aItem, int aLayer );
 
-    /// Updates all informations needed to draw an item
-    void updateItemGeometry( VIEW_ITEM* aItem, int aLayer );
+    /**
+     * Function updateItemGeometry()
+     * Updates all informations needed to draw an item.
+     * @param aItem is the item to be redrawn.
+     * @param aLayer is the layer to be cached.
+     * @param aKeepOtherLevels is true if the groups cached for other levels of detail are still
+     * valid, i.e. only the current level of detail has to be drawn.
+     */
+    void updateItemGeometry( VIEW_ITEM* aItem, int aLayer, bool aKeepOtherLevels = false );
+
+    /**
+     * Function updateDetailLevel()
+     * Queries the painter for the level of detail at the current scale.
+     */
+    void updateDetailLevel();
+
+    /**
+     * Function updateVisibleDetailLevel()
+     * Requests caching of the visible items that were not drawn at the current level of detail
+     * yet.  Items outside of the screen are cached when they get into view.
+     */
+    void updateVisibleDetailLevel();
+
+    ///* Returns the visible area of the view, in world coordinates
+    BOX2I visibleArea() const;
+
+    /**
+     * Function prepareItems()
+     * Lets the painter compute the drawing-independent data of items (see PAINTER::Prepare())
+     * on several threads, before they are drawn to the GAL from the main thread.
+     * @param aItems are the items that are going to be redrawn.
+     */
+    void prepareItems( const std::vector<VIEW_ITEM*>& aItems );
 
     /// Updates bounding box of an item
     void updateBbox( VIEW_ITEM* aItem );
@@ -831,6 +862,13 @@ protected:
     /// PAINTER contains information how do draw items
     PAINTER* m_painter;
 
+    /// Level of detail reported by the painter for the current scale
+    int m_detailLevel;
+
+    /// Area and level of detail of the last visible items cached by updateVisibleDetailLevel()
+    BOX2I m_detailLevelArea;
+    int   m_detailLevelAreaLevel;
+
     /// Gives interface to PAINTER, that is used to draw items
     GAL* m_gal;
 
@@ -1579,16 +1579,57 @@ public:
      */
     virtual void SetData( const std::vector<double>& xs, const std::vector<double>& ys );
 
+    /** Appends points to the internal data, extending the min/max pyramid of SetData without
+     *  rebuilding it.  Both vectors MUST be of the same length. This method DOES NOT refresh
+     *  the mpWindow; do it manually.
+     * @sa SetData
+     */
+    virtual void AppendData( const std::vector<double>& xs, const std::vector<double>& ys );
+
     /** Clears all the data, leaving the layer empty.
      * @sa SetData
      */
     void Clear();
 
+    /** Layer plot handler.
+     *  Only the points in the visible X range are plotted.  When there are more points than
+     *  pixels in this range, a continuous plot is drawn from the minimum and maximum of the
+     *  points of each pixel column, taken from a precomputed min/max pyramid.
+     */
+    void Plot( wxDC& dc, mpWindow& w ) override;
+
+    /** Gives the indices of the points to draw the X range [aMinX, aMaxX] on aPixels pixel
+     *  columns, in increasing order.  When the X data is sorted, only the points in the range
+     *  (and one more on each side) are given; a range of more than two points per pixel is
+     *  reduced to the first, last, minimum and maximum points of blocks spanning at most a
+     *  pixel, unless aPixels is 0.  Otherwise all the points are given.
+     */
+    void GetPlotIndices( double aMinX, double aMaxX, int aPixels,
+                         std::vector<size_t>& aIndices ) const;
+
 protected:
     /** The internal copy of the set of data to draw.
      */
     std::vector<double> m_xs, m_ys;
 
+    /** True if m_xs is in increasing order, which allows to search the visible points.
+     */
+    bool m_sortedX;
+
+    /** The min/max pyramid, loaded at SetData: the level L (from 1) holds the indices of the
+     *  minimum and maximum Y values of each block of 2^L points.
+     */
+    std::vector<std::vector<size_t>> m_minIndex, m_maxIndex;
+
+    /** Extends the min/max pyramid to the blocks of points added since its last update.
+     */
+    void updatePyramid();
+
+    /** The points to plot, when m_usePlotIndices is set (during Plot).
+     */
+    std::vector<size_t> m_plotIndices;
+    bool                m_usePlotIndices;
+
     /** The internal counter for the "GetNextXY" interface
      */
     size_t m_index;
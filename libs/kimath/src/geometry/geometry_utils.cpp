@@ -71,8 +71,10 @@ int GetArcToSegmentCount( int aRadius, int aErrorMax, double aArcAngleDegree )
 // calculations).
 // So one can disable the shape expansion within a particular scope by allocating
 // a DISABLE_ARC_CORRECTION.
+// The flag is per thread, because the board layers can be plotted from several threads
+// and only the thread which allocated the DISABLE_ARC_CORRECTION must see it.
 
-static bool s_disable_arc_correction = false;
+static thread_local bool s_disable_arc_correction = false;
 
 DISABLE_ARC_RADIUS_CORRECTION::DISABLE_ARC_RADIUS_CORRECTION()
 {
@@ -39,6 +39,7 @@ class BOARD_COMMIT : public COMMIT
 public:
     BOARD_COMMIT( EDA_DRAW_FRAME* aFrame );
     BOARD_COMMIT( PCB_TOOL_BASE *aTool );
+    BOARD_COMMIT( TOOL_MANAGER* aToolMgr );
 
     virtual ~BOARD_COMMIT();
 
@@ -46,6 +46,7 @@
 // These variables are parameters used in addTextSegmToPoly.
 // But addTextSegmToPoly is a call-back function,
 // so we cannot send them as arguments.
+// Each caller owns its instance, so conversions can run from several threads.
 struct TSEGM_2_POLY_PRMS
 {
     int m_textWidth;
@@ -53,8 +54,6 @@ struct TSEGM_2_POLY_PRMS
     SHAPE_POLY_SET* m_cornerBuffer;
 };
 
-TSEGM_2_POLY_PRMS prms;
-
 
 // This is a call back function, used by GRText to draw the 3D text shape:
 static void addTextSegmToPoly( int x0, int y0, int xf, int yf, void* aData )
@@ -264,6 +263,7 @@ void MODULE::TransformGraphicShapesWithClearanceToPolygonSet( SHAPE_POLY_SET& aC
             texts.push_back( &Value() );
     }
 
+    TSEGM_2_POLY_PRMS prms;
     prms.m_cornerBuffer = &aCornerBuffer;
 
     for( FP_TEXT* textmod : texts )
@@ -368,6 +368,7 @@ void PCB_TEXT::TransformShapeWithClearanceToPolygonSet( SHAPE_POLY_SET& aCornerB
     bool forceBold = true;
     int  penWidth = GetEffectiveTextPenWidth();
 
+    TSEGM_2_POLY_PRMS prms;
     prms.m_cornerBuffer = &aCornerBuffer;
     prms.m_textWidth = GetEffectiveTextPenWidth() + ( 2 * aClearanceValue );
     prms.m_error = aError;
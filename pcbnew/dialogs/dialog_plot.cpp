@@ -40,6 +40,7 @@
 #include <tool/tool_manager.h>
 #include <tools/zone_filler_tool.h>
 #include <tools/drc_tool.h>
+#include <widgets/progress_reporter.h>
 #include <math/util.h>      // for KiROUND
 #include <macros.h>
 
@@ -858,6 +859,8 @@ void DIALOG_PLOT::Plot( wxCommandEvent& event )
 
     wxBusyCursor dummy;
 
+    std::vector<PLOT_JOB> jobs;
+
     for( LSEQ seq = m_plotOpts.GetLayerSelection().UIOrder();  seq;  ++seq )
     {
         PCB_LAYER_ID layer = *seq;
@@ -883,32 +886,41 @@ void DIALOG_PLOT::Plot( wxCommandEvent& event )
         wxString fullname = fn.GetFullName();
         jobfile_writer.AddGbrFile( layer, fullname );
 
-        LOCALE_IO toggle;
+        jobs.emplace_back( layer, m_plotOpts, fn.GetFullPath() );
+    }
+
+    // The layers are plotted on several threads
+    std::unique_ptr<WX_PROGRESS_REPORTER> progressReporter;
+
+    if( jobs.size() > 1 )
+    {
+        progressReporter = std::make_unique<WX_PROGRESS_REPORTER>( this, _( "Plotting..." ), 1,
+                                                                   false );
+        progressReporter->SetMaxProgress( jobs.size() );
+    }
 
-        PLOTTER* plotter = StartPlotBoard( board, &m_plotOpts, layer, fn.GetFullPath(), wxEmptyString );
+    PlotBoardLayers( board, jobs, progressReporter.get() );
+    progressReporter.reset();
 
-        // Print diags in messages box:
+    // Print diags in messages box:
+    for( const PLOT_JOB& job : jobs )
+    {
         wxString msg;
 
-        if( plotter )
+        if( job.m_Success )
         {
-            PlotOneBoardLayer( board, plotter, layer, m_plotOpts );
-            plotter->EndPlot();
-            delete plotter->RenderSettings();
-            delete plotter;
-
-            msg.Printf( _( "Plot file \"%s\" created." ), fn.GetFullPath() );
+            msg.Printf( _( "Plot file \"%s\" created." ), job.m_FullFileName );
             reporter.Report( msg, RPT_SEVERITY_ACTION );
         }
         else
         {
-            msg.Printf( _( "Unable to create file \"%s\"." ), fn.GetFullPath() );
+            msg.Printf( _( "Unable to create file \"%s\"." ), job.m_FullFileName );
             reporter.Report( msg, RPT_SEVERITY_ERROR );
         }
-
-        wxSafeYield();      // displays report message.
     }
 
+    wxSafeYield();      // displays report messages.
+
     if( m_plotOpts.GetFormat() == PLOT_FORMAT::GERBER && m_plotOpts.GetCreateGerberJobFile() )
     {
         // Pick the basename from the board file
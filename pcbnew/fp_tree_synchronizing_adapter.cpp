@@ -133,6 +133,7 @@ void FP_TREE_SYNCHRONIZING_ADAPTER::updateLibrary( LIB_TREE_NODE_LIB& aLibNode )
         {
             // node does not exist in the library manager, remove the corresponding node
             nodeIt = aLibNode.m_Children.erase( nodeIt );
+            m_tree.InvalidateSearchIndex();
         }
     }
 
@@ -151,6 +152,7 @@ LIB_TREE_NODE::PTR_VECTOR::iterator FP_TREE_SYNCHRONIZING_ADAPTER::deleteLibrary
     LIB_TREE_NODE* node = aLibNodeIt->get();
     m_libMap.erase( node->m_Name );
     auto it = m_tree.m_Children.erase( aLibNodeIt );
+    m_tree.InvalidateSearchIndex();
     return it;
 }
 
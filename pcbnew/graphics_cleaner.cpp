@@ -29,6 +29,10 @@
 #include <pcb_shape.h>
 #include <fp_shape.h>
 #include <graphics_cleaner.h>
+#include <hash_eda.h>
+
+#include <algorithm>
+#include <unordered_map>
 
 
 GRAPHICS_CLEANER::GRAPHICS_CLEANER( DRAWINGS& aDrawings, MODULE* aParentModule,
@@ -135,12 +139,32 @@ bool GRAPHICS_CLEANER::areEquivalent( PCB_SHAPE* aShape1, PCB_SHAPE* aShape2 )
 
 void GRAPHICS_CLEANER::cleanupSegments()
 {
+    // Only segments can be equivalent to a segment.  Equivalent segments have the same ends,
+    // layer and width, so they share the same hash key.
+    std::vector<PCB_SHAPE*>                            segments;
+    std::unordered_map<size_t, std::vector<size_t>>    segmentsByKey;
+
+    for( BOARD_ITEM* item : m_drawings )
+    {
+        PCB_SHAPE* segment = dynamic_cast<PCB_SHAPE*>( item );
+
+        if( !segment || segment->GetShape() != S_SEGMENT )
+            continue;
+
+        size_t key = hash_val( segment->GetStart().x, segment->GetStart().y,
+                               segment->GetEnd().x, segment->GetEnd().y,
+                               (int) segment->GetLayer(), segment->GetWidth() );
+
+        segmentsByKey[key].push_back( segments.size() );
+        segments.push_back( segment );
+    }
+
     // Remove duplicate segments (2 superimposed identical segments):
-    for( auto it = m_drawings.begin(); it != m_drawings.end(); it++ )
+    for( size_t ii = 0; ii < segments.size(); ++ii )
     {
-        PCB_SHAPE* segment = dynamic_cast<PCB_SHAPE*>( *it );
+        PCB_SHAPE* segment = segments[ii];
 
-        if( !segment || segment->GetShape() != S_SEGMENT || segment->HasFlag( IS_DELETED ) )
+        if( segment->HasFlag( IS_DELETED ) )
             continue;
 
         if( isNullSegment( segment ) )
@@ -155,11 +179,18 @@ void GRAPHICS_CLEANER::cleanupSegments()
             continue;
         }
 
-        for( auto it2 = it + 1; it2 != m_drawings.end(); it2++ )
+        size_t key = hash_val( segment->GetStart().x, segment->GetStart().y,
+                               segment->GetEnd().x, segment->GetEnd().y,
+                               (int) segment->GetLayer(), segment->GetWidth() );
+
+        const std::vector<size_t>& sameKey = segmentsByKey[key];
+
+        for( auto it = std::upper_bound( sameKey.begin(), sameKey.end(), ii );
+             it != sameKey.end(); ++it )
         {
-            PCB_SHAPE* segment2 = dynamic_cast<PCB_SHAPE*>( *it2 );
+            PCB_SHAPE* segment2 = segments[*it];
 
-            if( !segment2 || segment2->HasFlag( IS_DELETED ) )
+            if( segment2->HasFlag( IS_DELETED ) )
                 continue;
 
             if( areEquivalent( segment, segment2 ) )
@@ -197,7 +228,7 @@ void GRAPHICS_CLEANER::mergeRects()
     };
 
     std::vector<SIDE_CANDIDATE*> sides;
-    std::map<wxPoint, std::vector<SIDE_CANDIDATE*>> ptMap;
+    std::unordered_map<wxPoint, std::vector<SIDE_CANDIDATE*>> ptMap;
 
     // First load all the candidates into the side vector and layer maps
     for( BOARD_ITEM* item : m_drawings )
@@ -49,6 +49,7 @@
 #include <geometry/shape_segment.h>
 #include <geometry/shape_simple.h>
 #include <geometry/shape_circle.h>
+#include <trigo.h>
 
 using namespace KIGFX;
 
@@ -357,9 +358,30 @@ COLOR4D PCB_RENDER_SETTINGS::GetColor( const VIEW_ITEM* aItem, int aLayer ) cons
 }
 
 
+/**
+ * Zoom levels (in pixels per millimeter) below which the next coarser level of detail is used.
+ * The coarsest levels cover a large board or panel fitted to the screen.
+ */
+static const double LOD_THRESHOLDS[] = { 40.0, 10.0, 3.0, 1.0 };
+static const int    LOD_COUNT = sizeof( LOD_THRESHOLDS ) / sizeof( LOD_THRESHOLDS[0] ) + 1;
+
+
 PCB_PAINTER::PCB_PAINTER( GAL* aGal ) :
-    PAINTER( aGal )
+    PAINTER( aGal ),
+    m_lodPixelSize( 0.0 )
+{
+}
+
+
+int PCB_PAINTER::GetDetailLevel() const
 {
+    double pixelsPerMM = m_gal->GetWorldScale() * Millimeter2iu( 1.0 );
+    int    level = 0;
+
+    while( level < LOD_COUNT - 1 && pixelsPerMM < LOD_THRESHOLDS[level] )
+        level++;
+
+    return level;
 }
 
 
@@ -400,6 +422,15 @@ bool PCB_PAINTER::Draw( const VIEW_ITEM* aItem, int aLayer )
     if( !item )
         return false;
 
+    // Cached groups are reused for the whole zoom range of a level of detail, so decide what
+    // is too small to be seen using the largest zoom of the range
+    int detailLevel = GetDetailLevel();
+
+    if( detailLevel > 0 )
+        m_lodPixelSize = Millimeter2iu( 1.0 ) / LOD_THRESHOLDS[detailLevel - 1];
+    else
+        m_lodPixelSize = 0.0;
+
     // the "cast" applied in here clarifies which overloaded draw() is called
     switch( item->Type() )
     {
@@ -472,6 +503,54 @@ bool PCB_PAINTER::Draw( const VIEW_ITEM* aItem, int aLayer )
 }
 
 
+void PCB_PAINTER::Prepare( const VIEW_ITEM* aItem )
+{
+    const EDA_ITEM* item = dynamic_cast<const EDA_ITEM*>( aItem );
+
+    if( !item )
+        return;
+
+    switch( item->Type() )
+    {
+    case PCB_PAD_T:
+        // Builds the effective shapes (custom shapes, rounded corners, chamfers...)
+        static_cast<const D_PAD*>( item )->GetEffectiveShape();
+        break;
+
+    case PCB_SHAPE_T:
+    case PCB_FP_SHAPE_T:
+    {
+        PCB_SHAPE* shape = const_cast<PCB_SHAPE*>( static_cast<const PCB_SHAPE*>( item ) );
+
+        // See draw( const PCB_SHAPE* ): only OpenGL uses the triangulation
+        if( shape->GetShape() == S_POLYGON && m_gal->IsOpenGlEngine() )
+        {
+            SHAPE_POLY_SET& poly = shape->GetPolyShape();
+
+            if( poly.OutlineCount() > 0 && !poly.IsTriangulationUpToDate() )
+                poly.CacheTriangulation();
+        }
+
+        break;
+    }
+
+    case PCB_ZONE_AREA_T:
+    case PCB_FP_ZONE_AREA_T:
+        // Without a triangulation, the fill is tesselated by the GAL at draw time
+        if( m_gal->IsOpenGlEngine() )
+        {
+            const ZONE_CONTAINER* zone = static_cast<const ZONE_CONTAINER*>( item );
+            const_cast<ZONE_CONTAINER*>( zone )->CacheTriangulation();
+        }
+
+        break;
+
+    default:
+        break;
+    }
+}
+
+
 void PCB_PAINTER::draw( const TRACK* aTrack, int aLayer )
 {
     VECTOR2D start( aTrack->GetStart() );
@@ -655,6 +734,10 @@ void PCB_PAINTER::draw( const VIA* aVia, int aLayer )
         return;
     }
 
+    // Holes too small to be seen at the current level of detail are not drawn
+    if( aLayer == LAYER_VIAS_HOLES && getDrillSize( aVia ) < m_lodPixelSize )
+        return;
+
     // Choose drawing settings depending on if we are drawing via's pad or hole
     if( aLayer == LAYER_VIAS_HOLES )
         radius = getDrillSize( aVia ) / 2.0;
@@ -672,6 +755,17 @@ void PCB_PAINTER::draw( const VIA* aVia, int aLayer )
     if( color == COLOR4D::CLEAR )
         return;
 
+    // A via of a couple of pixels is drawn as a single quad
+    if( aLayer != LAYER_VIAS_HOLES && aVia->GetWidth() < 2 * m_lodPixelSize )
+    {
+        m_gal->SetIsFill( true );
+        m_gal->SetIsStroke( false );
+        m_gal->SetFillColor( color );
+        m_gal->DrawRectangle( center - VECTOR2D( radius, radius ),
+                              center + VECTOR2D( radius, radius ) );
+        return;
+    }
+
     switch( aVia->GetViaType() )
     {
     case VIATYPE::THROUGH:
@@ -740,7 +834,8 @@ void PCB_PAINTER::draw( const VIA* aVia, int aLayer )
     constexpr int clearanceFlags = PCB_RENDER_SETTINGS::CL_EXISTING | PCB_RENDER_SETTINGS::CL_VIAS;
 
     if( ( m_pcbSettings.m_clearance & clearanceFlags ) == clearanceFlags
-            && aLayer != LAYER_VIAS_HOLES )
+            && aLayer != LAYER_VIAS_HOLES
+            && aVia->GetOwnClearance( m_pcbSettings.GetActiveLayer() ) >= m_lodPixelSize )
     {
         PCB_LAYER_ID activeLayer = m_pcbSettings.GetActiveLayer();
 
@@ -873,6 +968,33 @@ void PCB_PAINTER::draw( const D_PAD* aPad, int aLayer )
     else
         color = m_pcbSettings.GetColor( aPad, aLayer );
 
+    bool isHoleLayer = ( aLayer == LAYER_PADS_PLATEDHOLES || aLayer == LAYER_NON_PLATEDHOLES );
+
+    // Below the current level of detail, pads are drawn as quads and their holes are skipped
+    if( m_lodPixelSize > 0.0 )
+    {
+        if( isHoleLayer )
+        {
+            const SHAPE_SEGMENT* seg = aPad->GetEffectiveHoleShape();
+
+            if( !seg || seg->GetWidth() < m_lodPixelSize )
+                return;
+        }
+        else
+        {
+            EDA_RECT bbox = aPad->GetBoundingBox();
+
+            if( std::max( bbox.GetWidth(), bbox.GetHeight() ) < 2 * m_lodPixelSize )
+            {
+                m_gal->SetIsFill( true );
+                m_gal->SetIsStroke( false );
+                m_gal->SetFillColor( color );
+                m_gal->DrawRectangle( bbox.GetOrigin(), bbox.GetEnd() );
+                return;
+            }
+        }
+    }
+
     if( m_pcbSettings.m_sketchMode[LAYER_PADS_TH] )
     {
         // Outline mode
@@ -890,7 +1012,7 @@ void PCB_PAINTER::draw( const D_PAD* aPad, int aLayer )
     }
 
     // Choose drawing settings depending on if we are drawing a pad itself or a hole
-    if( aLayer == LAYER_PADS_PLATEDHOLES || aLayer == LAYER_NON_PLATEDHOLES )
+    if( isHoleLayer )
     {
         const SHAPE_SEGMENT* seg = aPad->GetEffectiveHoleShape();
 
@@ -1050,7 +1172,8 @@ void PCB_PAINTER::draw( const D_PAD* aPad, int aLayer )
     constexpr int clearanceFlags = PCB_RENDER_SETTINGS::CL_PADS;
 
     if( ( m_pcbSettings.m_clearance & clearanceFlags ) == clearanceFlags
-            && ( aLayer == LAYER_PAD_FR || aLayer == LAYER_PAD_BK || aLayer == LAYER_PADS_TH ) )
+            && ( aLayer == LAYER_PAD_FR || aLayer == LAYER_PAD_BK || aLayer == LAYER_PADS_TH )
+            && aPad->GetOwnClearance( m_pcbSettings.GetActiveLayer() ) >= m_lodPixelSize )
     {
         bool flashActiveLayer = aPad->FlashLayer( m_pcbSettings.GetActiveLayer() );
 
@@ -1233,6 +1356,12 @@ void PCB_PAINTER::draw( const PCB_TEXT* aText, int aLayer )
     const COLOR4D& color = m_pcbSettings.GetColor( aText, aText->GetLayer() );
     VECTOR2D position( aText->GetTextPos().x, aText->GetTextPos().y );
 
+    if( aText->GetTextHeight() < 4 * m_lodPixelSize )
+    {
+        drawTextBox( aText, aText->GetTextAngle(), color );
+        return;
+    }
+
     if( m_pcbSettings.m_sketchText || m_pcbSettings.m_sketchMode[aLayer] )
     {
         // Outline mode
@@ -1262,6 +1391,12 @@ void PCB_PAINTER::draw( const FP_TEXT* aText, int aLayer )
     const COLOR4D& color = m_pcbSettings.GetColor( aText, aLayer );
     VECTOR2D position( aText->GetTextPos().x, aText->GetTextPos().y );
 
+    if( aText->GetTextHeight() < 4 * m_lodPixelSize && !aText->IsSelected() )
+    {
+        drawTextBox( aText, aText->GetDrawRotation(), color );
+        return;
+    }
+
     if( m_pcbSettings.m_sketchText )
     {
         // Outline mode
@@ -1289,6 +1424,54 @@ void PCB_PAINTER::draw( const FP_TEXT* aText, int aLayer )
 }
 
 
+void PCB_PAINTER::drawTextBox( const EDA_TEXT* aText, double aRotation, const COLOR4D& aColor )
+{
+    EDA_RECT             box = aText->GetTextBox();
+    std::deque<VECTOR2D> corners;
+    wxPoint              points[] = { box.GetOrigin(),
+                                      wxPoint( box.GetRight(), box.GetTop() ),
+                                      box.GetEnd(),
+                                      wxPoint( box.GetLeft(), box.GetBottom() ) };
+
+    for( wxPoint& point : points )
+    {
+        RotatePoint( &point, aText->GetTextPos(), aRotation );
+        corners.emplace_back( point );
+    }
+
+    // Strokes cover roughly half of the text box, so use a lighter fill
+    m_gal->SetIsFill( true );
+    m_gal->SetIsStroke( false );
+    m_gal->SetFillColor( aColor.WithAlpha( aColor.a * 0.5 ) );
+    m_gal->DrawPolygon( corners );
+}
+
+
+void PCB_PAINTER::drawDecimatedPolyline( const SHAPE_LINE_CHAIN& aLineChain )
+{
+    if( m_lodPixelSize <= 0.0 )
+    {
+        m_gal->DrawPolyline( aLineChain );
+        return;
+    }
+
+    std::deque<VECTOR2D> points;
+
+    for( int ii = 0; ii < aLineChain.PointCount(); ++ii )
+    {
+        VECTOR2D point( aLineChain.CPoint( ii ) );
+
+        if( points.empty() || ( point - points.back() ).EuclideanNorm() >= m_lodPixelSize )
+            points.push_back( point );
+    }
+
+    if( aLineChain.IsClosed() && aLineChain.PointCount() > 0 )
+        points.emplace_back( aLineChain.CPoint( 0 ) );
+
+    m_gal->DrawPolyline( points );
+}
+
+
 void PCB_PAINTER::draw( const MODULE* aModule, int aLayer )
 {
     if( aLayer == LAYER_ANCHOR )
@@ -1408,13 +1591,13 @@ void PCB_PAINTER::draw( const ZONE_CONTAINER* aZone, int aLayer )
          */
 
         // Draw the main contour
-        m_gal->DrawPolyline( outline->COutline( 0 ) );
+        drawDecimatedPolyline( outline->COutline( 0 ) );
 
         // Draw holes
         int holes_count = outline->HoleCount( 0 );
 
         for( int ii = 0; ii < holes_count; ++ii )
-            m_gal->DrawPolyline( outline->CHole( 0, ii ) );
+            drawDecimatedPolyline( outline->CHole( 0, ii ) );
 
         // Draw hatch lines
         for( const SEG& hatchLine : aZone->GetHatchLines() )
@@ -1441,8 +1624,10 @@ void PCB_PAINTER::draw( const ZONE_CONTAINER* aZone, int aLayer )
 
         if( displayMode == ZONE_DISPLAY_MODE::SHOW_FILLED )
         {
+            // The outline stroke only grows the fill by half of its width, so it can be
+            // skipped when that is not visible at the current level of detail
             m_gal->SetIsFill( true );
-            m_gal->SetIsStroke( outline_thickness > 0 );
+            m_gal->SetIsStroke( outline_thickness > 0 && outline_thickness >= m_lodPixelSize );
         }
         else if( displayMode == ZONE_DISPLAY_MODE::SHOW_OUTLINED )
         {
@@ -50,6 +50,8 @@ class FP_TEXT;
 class DIMENSION;
 class PCB_TARGET;
 class MARKER_PCB;
+class EDA_TEXT;
+class SHAPE_LINE_CHAIN;
 class NET_SETTINGS;
 class NETINFO_LIST;
 
@@ -277,9 +279,19 @@ public:
     /// @copydoc PAINTER::Draw()
     virtual bool Draw( const VIEW_ITEM* aItem, int aLayer ) override;
 
+    /// @copydoc PAINTER::Prepare()
+    virtual void Prepare( const VIEW_ITEM* aItem ) override;
+
+    /// @copydoc PAINTER::GetDetailLevel()
+    virtual int GetDetailLevel() const override;
+
 protected:
     PCB_RENDER_SETTINGS m_pcbSettings;
 
+    ///> Size of the largest pixel (in internal units) of the current level of detail, or 0 when
+    ///> drawing with full detail.  Objects smaller than that are simplified or skipped.
+    double m_lodPixelSize;
+
     // Drawing functions for various types of PCB-specific items
     void draw( const TRACK* aTrack, int aLayer );
     void draw( const ARC* aArc, int aLayer );
@@ -304,6 +316,23 @@ protected:
      */
     int getLineThickness( int aActualThickness ) const;
 
+    /**
+     * Function drawTextBox()
+     * Draws the bounding box of a text too small to be readable at the current level of detail.
+     * @param aText is the text to draw.
+     * @param aRotation is the text rotation in decidegrees.
+     * @param aColor is the color of the box.
+     */
+    void drawTextBox( const EDA_TEXT* aText, double aRotation, const COLOR4D& aColor );
+
+    /**
+     * Function drawDecimatedPolyline()
+     * Draws a line chain, skipping vertices closer than the current level of detail allows to
+     * distinguish.
+     * @param aLineChain is the line chain to draw.
+     */
+    void drawDecimatedPolyline( const SHAPE_LINE_CHAIN& aLineChain );
+
     /**
      * Return drill shape of a pad.
      */
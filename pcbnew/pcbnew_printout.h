@@ -98,6 +98,12 @@ public:
         m_drillMarkSize = aSize;
     }
 
+    /// Printouts are always drawn with full detail
+    int GetDetailLevel() const override
+    {
+        return 0;
+    }
+
 protected:
     int getDrillShape( const D_PAD* aPad ) const override;
 
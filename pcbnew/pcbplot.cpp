@@ -490,6 +490,44 @@ bool PLOT_CONTROLLER::PlotLayer()
 }
 
 
+int PLOT_CONTROLLER::PlotLayers( const LSEQ& aLayers, PLOT_FORMAT aFormat,
+                                 const wxString& aSheetDesc )
+{
+    GetPlotOptions().SetFormat( aFormat );
+
+    // Ensure that the previous plot is closed
+    ClosePlot();
+
+    wxString outputDirName = GetPlotOptions().GetOutputDirectory();
+    wxFileName outputDir = wxFileName::DirName( outputDirName );
+    wxString boardFilename = m_board->GetFileName();
+
+    if( !EnsureFileDirectoryExists( &outputDir, boardFilename ) )
+        return 0;
+
+    std::vector<PLOT_JOB> jobs;
+
+    for( PCB_LAYER_ID layer : aLayers )
+    {
+        wxFileName plotFile = boardFilename;
+        wxString   fileExt = GetDefaultPlotExtension( aFormat );
+
+        if( aFormat == PLOT_FORMAT::GERBER && GetPlotOptions().GetUseGerberProtelExtensions() )
+            fileExt = GetGerberProtelExtension( layer );
+
+        BuildPlotFileName( &plotFile, outputDir.GetPath(), m_board->GetLayerName( layer ),
+                           fileExt );
+
+        jobs.emplace_back( layer, GetPlotOptions(), plotFile.GetFullPath(), aSheetDesc );
+
+        // Keep the last name for GetPlotFileName() and GetPlotDirName()
+        m_plotFile = plotFile;
+    }
+
+    return PlotBoardLayers( m_board, jobs );
+}
+
+
 void PLOT_CONTROLLER::SetColorMode( bool aColorMode )
 {
     if( !m_plotter )
@@ -38,6 +38,8 @@
 #include <settings/settings_manager.h>
 #include <wx/filename.h>
 
+#include <vector>
+
 class PLOTTER;
 class PCB_TEXT;
 class D_PAD;
@@ -50,6 +52,7 @@ class FP_TEXT;
 class ZONE_CONTAINER;
 class BOARD;
 class REPORTER;
+class PROGRESS_REPORTER;
 
 
 // Define min and max reasonable values for plot/print scale
@@ -155,6 +158,42 @@ PLOTTER* StartPlotBoard( BOARD* aBoard,
                          const wxString& aFullFileName,
                          const wxString& aSheetDesc );
 
+/**
+ * PLOT_JOB
+ * describes the plot of one board layer in one file, for PlotBoardLayers().
+ */
+struct PLOT_JOB
+{
+    PLOT_JOB( PCB_LAYER_ID aLayer, const PCB_PLOT_PARAMS& aPlotOpts,
+              const wxString& aFullFileName, const wxString& aSheetDesc = wxEmptyString ) :
+            m_Layer( aLayer ),
+            m_PlotOpts( aPlotOpts ),
+            m_FullFileName( aFullFileName ),
+            m_SheetDesc( aSheetDesc ),
+            m_Success( false )
+    {}
+
+    PCB_LAYER_ID    m_Layer;
+    PCB_PLOT_PARAMS m_PlotOpts;         ///< the plot options, including the plot format
+    wxString        m_FullFileName;
+    wxString        m_SheetDesc;
+    bool            m_Success;          ///< set by PlotBoardLayers() when the file is plotted
+};
+
+/**
+ * Function PlotBoardLayers
+ * plots a set of board layers, each one in its own file with its own plotter.
+ * The files are opened (and the page frame plotted) one after the other, then the
+ * layers are plotted on several threads, sharing the board: the board must not be
+ * modified during the plot.
+ * @param aBoard = the board to plot
+ * @param aJobs = the layers to plot. m_Success is set for each job.
+ * @param aProgressReporter = an optional progress reporter, advanced once per job
+ * @return the count of successfully plotted files
+ */
+int PlotBoardLayers( BOARD* aBoard, std::vector<PLOT_JOB>& aJobs,
+                     PROGRESS_REPORTER* aProgressReporter = nullptr );
+
 /**
  * Function PlotOneBoardLayer
  * main function to plot one copper or technical layer.
@@ -48,6 +48,12 @@
 #include <pcbplot.h>
 #include <pcb_painter.h>
 #include <gbr_metadata.h>
+#include <widgets/progress_reporter.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
 
 /*
  * Plot a solder mask layer.  Solder mask layers have a minimum thickness value and cannot be
@@ -277,58 +283,64 @@ void PlotStandardLayer( BOARD *aBoard, PLOTTER* aPlotter, LSET aLayerMask,
             // Now offset the pad size by margin + width_adj
             wxSize padPlotsSize = pad->GetSize() + margin * 2 + wxSize( width_adj, width_adj );
 
-            // Store these parameters that can be modified to plot inflated/deflated pads shape
-            PAD_SHAPE_T padShape = pad->GetShape();
-            wxSize      padSize = pad->GetSize();
-            wxSize      padDelta = pad->GetDelta(); // has meaning only for trapezoidal pads
-            double      padCornerRadius = pad->GetRoundRectCornerRadius();
+            wxSize padSize = pad->GetSize();
 
             // Don't draw a null size item :
             if( padPlotsSize.x <= 0 || padPlotsSize.y <= 0 )
                 continue;
 
+            // The board pads are shared by all the layers plotted at the same time (see
+            // PlotBoardLayers()), so an inflated/deflated pad shape is plotted from a copy
+            // of the pad, never by modifying the board pad
+            std::unique_ptr<D_PAD> plotPad;
+
+            if( padPlotsSize != padSize )
+            {
+                plotPad = std::make_unique<D_PAD>( *pad );
+                plotPad->SetSize( padPlotsSize );
+            }
+
             switch( pad->GetShape() )
             {
             case PAD_SHAPE_CIRCLE:
             case PAD_SHAPE_OVAL:
-                pad->SetSize( padPlotsSize );
-
                 if( aPlotOpt.GetSkipPlotNPTH_Pads() &&
                     ( aPlotOpt.GetDrillMarksType() == PCB_PLOT_PARAMS::NO_DRILL_SHAPE ) &&
-                    ( pad->GetSize() == pad->GetDrillSize() ) &&
+                    ( padPlotsSize == pad->GetDrillSize() ) &&
                     ( pad->GetAttribute() == PAD_ATTRIB_NPTH ) )
                     break;
 
-                itemplotter.PlotPad( pad, color, padPlotMode );
+                itemplotter.PlotPad( plotPad ? plotPad.get() : pad, color, padPlotMode );
                 break;
 
             case PAD_SHAPE_RECT:
-                pad->SetSize( padPlotsSize );
-
                 if( margin.x > 0 )
                 {
-                    pad->SetShape( PAD_SHAPE_ROUNDRECT );
-                    pad->SetRoundRectCornerRadius( margin.x );
+                    if( !plotPad )
+                        plotPad = std::make_unique<D_PAD>( *pad );
+
+                    plotPad->SetShape( PAD_SHAPE_ROUNDRECT );
+                    plotPad->SetRoundRectCornerRadius( margin.x );
                 }
 
-                itemplotter.PlotPad( pad, color, padPlotMode );
+                itemplotter.PlotPad( plotPad ? plotPad.get() : pad, color, padPlotMode );
                 break;
 
             case PAD_SHAPE_TRAPEZOID:
-            {
-                wxSize scale( padPlotsSize.x / padSize.x, padPlotsSize.y / padSize.y );
-                pad->SetDelta( wxSize( padDelta.x * scale.x, padDelta.y * scale.y ) );
-                pad->SetSize( padPlotsSize );
+                if( plotPad )
+                {
+                    wxSize padDelta = pad->GetDelta();
+                    wxSize scale( padPlotsSize.x / padSize.x, padPlotsSize.y / padSize.y );
+                    plotPad->SetDelta( wxSize( padDelta.x * scale.x, padDelta.y * scale.y ) );
+                }
 
-                itemplotter.PlotPad( pad, color, padPlotMode );
-            }
+                itemplotter.PlotPad( plotPad ? plotPad.get() : pad, color, padPlotMode );
                 break;
 
             case PAD_SHAPE_ROUNDRECT:
             case PAD_SHAPE_CHAMFERED_RECT:
                 // Chamfer and rounding are stored as a percent and so don't need scaling
-                pad->SetSize( padPlotsSize );
-                itemplotter.PlotPad( pad, color, padPlotMode );
+                itemplotter.PlotPad( plotPad ? plotPad.get() : pad, color, padPlotMode );
                 break;
 
             case PAD_SHAPE_CUSTOM:
@@ -356,12 +368,6 @@ void PlotStandardLayer( BOARD *aBoard, PLOTTER* aPlotter, LSET aLayerMask,
             }
                 break;
             }
-
-            // Restore the pad parameters modified by the plot code
-            pad->SetSize( padSize );
-            pad->SetDelta( padDelta );
-            pad->SetShape( padShape );
-            pad->SetRoundRectCornerRadius( padCornerRadius );
         }
 
         aPlotter->EndBlock( NULL );
@@ -1130,3 +1136,90 @@ PLOTTER* StartPlotBoard( BOARD *aBoard, PCB_PLOT_PARAMS *aPlotOpts, int aLayer,
     delete plotter;
     return NULL;
 }
+
+
+int PlotBoardLayers( BOARD* aBoard, std::vector<PLOT_JOB>& aJobs,
+                     PROGRESS_REPORTER* aProgressReporter )
+{
+    if( aJobs.empty() )
+        return 0;
+
+    // Each plotter switches to the C locale; keep it for the whole plot so the user
+    // locale is not restored while other layers are plotted
+    LOCALE_IO toggle;
+
+    // The pads build their effective shapes on demand: build them now, before the pads
+    // are shared by the threads
+    for( MODULE* module : aBoard->Modules() )
+    {
+        for( D_PAD* pad : module->Pads() )
+            pad->GetEffectivePolygon();
+    }
+
+    // Opening the files and plotting the page frames use shared data (the board bounding
+    // box, the page layout), so it is done here, one file after the other
+    std::vector<PLOTTER*> plotters( aJobs.size(), nullptr );
+
+    for( size_t ii = 0; ii < aJobs.size(); ++ii )
+    {
+        PLOT_JOB& job = aJobs[ii];
+
+        job.m_Success = false;
+        plotters[ii] = StartPlotBoard( aBoard, &job.m_PlotOpts, job.m_Layer, job.m_FullFileName,
+                                       job.m_SheetDesc );
+    }
+
+    std::atomic<size_t> nextJob( 0 );
+    std::atomic<size_t> threadsFinished( 0 );
+
+    size_t parallelThreadCount = std::min<size_t>(
+            std::max<size_t>( std::thread::hardware_concurrency(), 2 ), aJobs.size() );
+
+    for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+    {
+        std::thread t = std::thread( [&]()
+        {
+            for( size_t i = nextJob.fetch_add( 1 ); i < aJobs.size();
+                 i = nextJob.fetch_add( 1 ) )
+            {
+                if( plotters[i] )
+                {
+                    PlotOneBoardLayer( aBoard, plotters[i], aJobs[i].m_Layer,
+                                       aJobs[i].m_PlotOpts );
+                    plotters[i]->EndPlot();
+                }
+
+                if( aProgressReporter )
+                    aProgressReporter->AdvanceProgress();
+            }
+
+            threadsFinished++;
+        } );
+
+        t.detach();
+    }
+
+    while( threadsFinished < parallelThreadCount )
+    {
+        if( aProgressReporter )
+            aProgressReporter->KeepRefreshing();
+
+        std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+    }
+
+    int successCount = 0;
+
+    for( size_t ii = 0; ii < aJobs.size(); ++ii )
+    {
+        if( !plotters[ii] )
+            continue;
+
+        aJobs[ii].m_Success = true;
+        successCount++;
+
+        delete plotters[ii]->RenderSettings();
+        delete plotters[ii];
+    }
+
+    return successCount;
+}
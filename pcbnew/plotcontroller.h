@@ -83,6 +83,16 @@ public:
      */
     bool PlotLayer();
 
+    /** Plot a set of layers, each one on its own plotfile, the layers being
+     * plotted on several threads. The current plot, if any, is closed first.
+     * The plotfiles are named like in OpenPlotfile, with the layer name as suffix
+     * @param aLayers is the list of layers to plot
+     * @param aFormat is the plot file format identifier
+     * @param aSheetDesc
+     * @return the count of plotfiles successfully created
+     */
+    int PlotLayers( const LSEQ& aLayers, PLOT_FORMAT aFormat, const wxString& aSheetDesc );
+
     /**
      * @return the current plot full filename, set by OpenPlotfile
      */
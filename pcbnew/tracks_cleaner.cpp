@@ -33,6 +33,9 @@
 #include <tools/global_edit_tool.h>
 #include <tracks_cleaner.h>
 
+#include <algorithm>
+#include <unordered_map>
+
 
 TRACKS_CLEANER::TRACKS_CLEANER( BOARD* aPcb, BOARD_COMMIT& aCommit ) :
         m_brd( aPcb ),
@@ -157,9 +160,15 @@ void TRACKS_CLEANER::cleanupVias()
             vias.push_back( static_cast<VIA*>( track ) );
     }
 
-    for( auto via1_it = vias.begin(); via1_it != vias.end(); via1_it++ )
+    // Indices of the vias at each position, in ascending order
+    std::unordered_map<wxPoint, std::vector<size_t>> viasAtPosition;
+
+    for( size_t ii = 0; ii < vias.size(); ++ii )
+        viasAtPosition[ vias[ii]->GetPosition() ].push_back( ii );
+
+    for( size_t ii = 0; ii < vias.size(); ++ii )
     {
-        VIA* via1 = *via1_it;
+        VIA* via1 = vias[ii];
 
         if( via1->IsLocked() )
             continue;
@@ -189,11 +198,15 @@ void TRACKS_CLEANER::cleanupVias()
             }
         }
 
-        for( auto via2_it = via1_it + 1; via2_it != vias.end(); via2_it++ )
+        // Only the vias after via1 at the same position are candidates
+        const std::vector<size_t>& samePosition = viasAtPosition[ via1->GetPosition() ];
+
+        for( auto it = std::upper_bound( samePosition.begin(), samePosition.end(), ii );
+             it != samePosition.end(); ++it )
         {
-            VIA* via2 = *via2_it;
+            VIA* via2 = vias[*it];
 
-            if( via1->GetPosition() != via2->GetPosition() || via2->IsLocked() )
+            if( via2->IsLocked() )
                 continue;
 
             if( via1->GetViaType() == via2->GetViaType() )
@@ -373,16 +386,51 @@ void TRACKS_CLEANER::cleanupSegments()
     std::set<BOARD_ITEM*> toRemove;
 
     // Remove duplicate segments (2 superimposed identical segments):
-    for( auto it = m_brd->Tracks().begin(); it != m_brd->Tracks().end(); it++ )
+    std::vector<TRACK*> tracks( m_brd->Tracks().begin(), m_brd->Tracks().end() );
+
+    // A duplicate of a segment starts at one of its ends.  Index the items by their start
+    // point, in ascending order.
+    std::unordered_map<wxPoint, std::vector<size_t>> tracksAtStart;
+
+    for( size_t ii = 0; ii < tracks.size(); ++ii )
+        tracksAtStart[ tracks[ii]->GetStart() ].push_back( ii );
+
+    std::vector<size_t> candidates;
+
+    auto addCandidatesAt =
+            [&]( const wxPoint& aPoint, size_t aAfter )
+            {
+                auto it = tracksAtStart.find( aPoint );
+
+                if( it == tracksAtStart.end() )
+                    return;
+
+                for( auto idx = std::upper_bound( it->second.begin(), it->second.end(), aAfter );
+                     idx != it->second.end(); ++idx )
+                {
+                    candidates.push_back( *idx );
+                }
+            };
+
+    for( size_t ii = 0; ii < tracks.size(); ++ii )
     {
-        TRACK* track1 = *it;
+        TRACK* track1 = tracks[ii];
 
         if( track1->Type() != PCB_TRACE_T || track1->HasFlag( IS_DELETED ) || track1->IsLocked() )
             continue;
 
-        for( auto it2 = it + 1; it2 != m_brd->Tracks().end(); it2++ )
+        candidates.clear();
+        addCandidatesAt( track1->GetStart(), ii );
+
+        if( track1->GetEnd() != track1->GetStart() )
+        {
+            addCandidatesAt( track1->GetEnd(), ii );
+            std::sort( candidates.begin(), candidates.end() );
+        }
+
+        for( size_t idx : candidates )
         {
-            TRACK* track2 = *it2;
+            TRACK* track2 = tracks[idx];
 
             if( track2->HasFlag( IS_DELETED ) )
                 continue;
@@ -27,10 +27,12 @@
 #include <sstream>
 #include <string>
 #include <cstring>
+#include <atomic>
 #include <map>
+#include <mutex>
+#include <shared_mutex>
 #include <vector>
 #include <wx/filename.h>
-#include <wx/stdpaths.h>
 #include <wx/string.h>
 #include <wx/wfstream.h>
 
@@ -393,8 +395,59 @@ void addItems( SGNODE* parent, std::vector< SGNODE* >* lp )
 }
 
 
+// Models are loaded from several threads at once (see CanLoadConcurrently()), but the
+// OpenCascade translation settings are global: they are left with the STEP values, so STEP
+// files are read concurrently under a shared lock, and an IGES file takes the lock
+// exclusively while it needs its own values.
+static std::shared_timed_mutex readerSettingsLock;
+
+// The XCAF application keeps the list of its documents
+static std::mutex appLock;
+
+
+/**
+ * Sets the translation settings used by the STEP reads.  Must be called with
+ * readerSettingsLock held exclusively.
+ */
+static bool setSTEPSettings()
+{
+    // Enable user-defined shape precision
+    if( !Interface_Static::SetIVal( "read.precision.mode", 1 ) )
+        return false;
+
+    // Set the shape conversion precision to USER_PREC (default 0.0001 has too many triangles)
+    if( !Interface_Static::SetRVal( "read.precision.val", USER_PREC ) )
+        return false;
+
+    return true;
+}
+
+
+/**
+ * Initializes the translators and their settings once, before any concurrent use.
+ */
+static void initReaders()
+{
+    static std::once_flag initialized;
+
+    std::call_once( initialized,
+            []()
+            {
+                std::unique_lock<std::shared_timed_mutex> lock( readerSettingsLock );
+
+                // The reader constructors register the translator controllers
+                STEPCAFControl_Reader stepReader;
+                IGESCAFControl_Reader igesReader;
+
+                setSTEPSettings();
+            } );
+}
+
+
 bool readIGES( Handle(TDocStd_Document)& m_doc, const char* fname )
 {
+    std::unique_lock<std::shared_timed_mutex> lock( readerSettingsLock );
+
     IGESCAFControl_Reader reader;
     IFSelect_ReturnStatus stat  = reader.ReadFile( fname );
     reader.PrintCheckLoad( Standard_False, IFSelect_ItemsByEntity );
@@ -406,6 +459,12 @@ bool readIGES( Handle(TDocStd_Document)& m_doc, const char* fname )
     if( !Interface_Static::SetIVal( "read.precision.mode", 0 ) )
         return false;
 
+    // Restore the settings used by the concurrent STEP reads when done
+    struct RESTORE_STEP_SETTINGS
+    {
+        ~RESTORE_STEP_SETTINGS() { setSTEPSettings(); }
+    } restoreSettings;
+
     // set other translation options
     reader.SetColorMode(true);  // use model colors
     reader.SetNameMode(false);  // don't use IGES label names
@@ -424,20 +483,15 @@ bool readIGES( Handle(TDocStd_Document)& m_doc, const char* fname )
 
 bool readSTEP( Handle(TDocStd_Document)& m_doc, const char* fname )
 {
+    // The precision settings were set by initReaders(), and are restored by readIGES()
+    std::shared_lock<std::shared_timed_mutex> lock( readerSettingsLock );
+
     STEPCAFControl_Reader reader;
     IFSelect_ReturnStatus stat  = reader.ReadFile( fname );
 
     if( stat != IFSelect_RetDone )
         return false;
 
-    // Enable user-defined shape precision
-    if( !Interface_Static::SetIVal( "read.precision.mode", 1 ) )
-        return false;
-
-    // Set the shape conversion precision to USER_PREC (default 0.0001 has too many triangles)
-    if( !Interface_Static::SetRVal( "read.precision.val", USER_PREC ) )
-        return false;
-
     // set other translation options
     reader.SetColorMode(true);  // use model colors
     reader.SetNameMode(false);  // don't use label names
@@ -445,6 +499,7 @@ bool readSTEP( Handle(TDocStd_Document)& m_doc, const char* fname )
 
     if ( !reader.Transfer( m_doc ) )
     {
+        std::lock_guard<std::mutex> appGuard( appLock );
         m_doc->Close();
         return false;
     }
@@ -462,16 +517,14 @@ bool readSTEPZ( Handle(TDocStd_Document)& m_doc, const char* aFileName )
     wxFileName fname( wxString::FromUTF8Unchecked( aFileName ) );
     wxFileInputStream ifile( fname.GetFullPath() );
 
-    wxFileName outFile( fname );
-
-    outFile.SetPath( wxStandardPaths::Get().GetTempDir() );
-    outFile.SetExt( "STEP" );
-
     wxFileOffset size = ifile.GetLength();
 
     if( size == wxInvalidOffset )
         return false;
 
+    // Models with the same name may be expanded at the same time: use a unique file
+    wxFileName outFile( wxFileName::CreateTempFileName( fname.GetName() ) );
+
     {
         wxFileOutputStream ofile( outFile.GetFullPath() );
 
@@ -512,8 +565,14 @@ SCENEGRAPH* LoadModel( char const* filename )
 {
     DATA data;
 
-    Handle(XCAFApp_Application) m_app = XCAFApp_Application::GetApplication();
-    m_app->NewDocument( "MDTV-XCAF", data.m_doc );
+    initReaders();
+
+    {
+        std::lock_guard<std::mutex> appGuard( appLock );
+        Handle(XCAFApp_Application) m_app = XCAFApp_Application::GetApplication();
+        m_app->NewDocument( "MDTV-XCAF", data.m_doc );
+    }
+
     FormatType modelFmt = fileType( filename );
 
     switch( modelFmt )
@@ -625,7 +684,7 @@ bool processSolid( const TopoDS_Shape& shape, DATA& data, SGNODE* parent,
 
     if( !data.m_assy->Search( shape, label, Standard_False ) )
     {
-        static int i = 0;
+        static std::atomic<int> i( 0 );
         std::ostringstream ostr;
         ostr << "KMISC_" << i++;
         partID = ostr.str();
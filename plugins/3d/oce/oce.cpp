@@ -125,6 +125,13 @@ bool CanRender( void )
 }
 
 
+bool CanLoadConcurrently( void )
+{
+    // the OpenCascade settings and documents shared by the loads are guarded in loadmodel.cpp
+    return true;
+}
+
+
 SCENEGRAPH* Load( char const* aFileName )
 {
     if( NULL == aFileName )
@@ -44,6 +44,7 @@ KICAD_PLUGIN_LDR_3D::KICAD_PLUGIN_LDR_3D()
     m_getFileFilter = NULL;
     m_canRender = NULL;
     m_load = NULL;
+    m_canLoadConcurrently = NULL;
 
     return;
 }
@@ -94,6 +95,13 @@ bool KICAD_PLUGIN_LDR_3D::Open( const wxString& aFullFileName )
     LINK_ITEM( m_canRender, PLUGIN_3D_CAN_RENDER, "CanRender" );
     LINK_ITEM( m_load, PLUGIN_3D_LOAD, "Load" );
 
+    // optional function; older plugins do not export it, and looking up a missing
+    // symbol logs an error
+    if( m_PluginLoader.HasSymbol( wxT( "CanLoadConcurrently" ) ) )
+        LINK_ITEM( m_canLoadConcurrently, PLUGIN_3D_CAN_LOAD_CONCURRENTLY, "CanLoadConcurrently" );
+    else
+        m_canLoadConcurrently = NULL;
+
     #ifdef DEBUG
         bool fail = false;
 
@@ -250,6 +258,7 @@ void KICAD_PLUGIN_LDR_3D::Close( void )
     m_getFileFilter = NULL;
     m_canRender = NULL;
     m_load = NULL;
+    m_canLoadConcurrently = NULL;
     close();
 
     return;
@@ -428,6 +437,11 @@ bool KICAD_PLUGIN_LDR_3D::CanRender( void )
 
 SCENEGRAPH* KICAD_PLUGIN_LDR_3D::Load( char const* aFileName )
 {
+    // an open plugin is called directly; the error string is shared by all
+    // callers so it is only touched when the plugin must be reopened
+    if( ok && NULL != m_load )
+        return m_load( aFileName );
+
     m_error.clear();
 
     if( !ok && !reopen() )
@@ -454,3 +468,15 @@ SCENEGRAPH* KICAD_PLUGIN_LDR_3D::Load( char const* aFileName )
 
     return m_load( aFileName );
 }
+
+
+bool KICAD_PLUGIN_LDR_3D::CanLoadConcurrently( void )
+{
+    if( !ok && !reopen() )
+        return false;
+
+    if( NULL == m_canLoadConcurrently )
+        return false;
+
+    return m_canLoadConcurrently();
+}
@@ -47,6 +47,8 @@ typedef bool (*PLUGIN_3D_CAN_RENDER) ( void );
 
 typedef SCENEGRAPH* (*PLUGIN_3D_LOAD) ( char const* aFileName );
 
+typedef bool (*PLUGIN_3D_CAN_LOAD_CONCURRENTLY) ( void );
+
 
 class KICAD_PLUGIN_LDR_3D : public KICAD_PLUGIN_LDR
 {
@@ -58,6 +60,7 @@ private:
     PLUGIN_3D_GET_FILE_FILTER       m_getFileFilter;
     PLUGIN_3D_CAN_RENDER            m_canRender;
     PLUGIN_3D_LOAD                  m_load;
+    PLUGIN_3D_CAN_LOAD_CONCURRENTLY m_canLoadConcurrently;  // optional
 
 public:
     KICAD_PLUGIN_LDR_3D();
@@ -84,7 +87,20 @@ public:
 
     bool CanRender( void );
 
+    /**
+     * Function Load
+     * reads a model with the plugin; once the plugin is open this does not modify
+     * the loader, so it may be called from several threads if CanLoadConcurrently()
+     * returns true
+     */
     SCENEGRAPH* Load( char const* aFileName );
+
+    /**
+     * Function CanLoadConcurrently
+     * @return true if the plugin declares that Load() may be called from several
+     * threads at once; false if the plugin does not export CanLoadConcurrently()
+     */
+    bool CanLoadConcurrently( void );
 };
 
 #endif  // PLUGINMGR3D_H
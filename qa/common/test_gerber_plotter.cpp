@@ -0,0 +1,141 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for the aperture dictionary and the output of GERBER_PLOTTER
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+// Code under test
+#include <plotters_specific.h>
+
+#include <wx/filename.h>
+#include <wx/ffile.h>
+#include <wx/tokenzr.h>
+
+
+/**
+ * Declare the test suite
+ */
+BOOST_AUTO_TEST_SUITE( GerberPlotter )
+
+
+/**
+ * Check the same aperture is found again, and a different one gets the next D code
+ */
+BOOST_AUTO_TEST_CASE( ApertureDictionary )
+{
+    GERBER_PLOTTER plotter;
+
+    const int circle = plotter.GetOrCreateAperture( wxSize( 100, 100 ), 0, 0.0,
+                                                    APERTURE::AT_CIRCLE, 0 );
+    const int rect = plotter.GetOrCreateAperture( wxSize( 100, 200 ), 0, 0.0,
+                                                  APERTURE::AT_RECT, 0 );
+    const int rotRect = plotter.GetOrCreateAperture( wxSize( 100, 200 ), 0, 45.0,
+                                                     APERTURE::AM_ROT_RECT, 0 );
+
+    BOOST_CHECK_EQUAL( circle, 0 );
+    BOOST_CHECK_EQUAL( rect, 1 );
+    BOOST_CHECK_EQUAL( rotRect, 2 );
+
+    BOOST_CHECK_EQUAL( plotter.GetOrCreateAperture( wxSize( 100, 100 ), 0, 0.0,
+                                                    APERTURE::AT_CIRCLE, 0 ), circle );
+    BOOST_CHECK_EQUAL( plotter.GetOrCreateAperture( wxSize( 100, 200 ), 0, -0.0,
+                                                    APERTURE::AT_RECT, 0 ), rect );
+
+    // Any difference makes a new aperture
+    BOOST_CHECK_EQUAL( plotter.GetOrCreateAperture( wxSize( 100, 100 ), 0, 0.0,
+                                                    APERTURE::AT_PLOTTING, 0 ), 3 );
+    BOOST_CHECK_EQUAL( plotter.GetOrCreateAperture( wxSize( 100, 100 ), 0, 0.0,
+                                                    APERTURE::AT_CIRCLE, 1 ), 4 );
+    BOOST_CHECK_EQUAL( plotter.GetOrCreateAperture( wxSize( 100, 200 ), 0, 30.0,
+                                                    APERTURE::AM_ROT_RECT, 0 ), 5 );
+
+    std::vector<wxPoint> corners = { { 0, 0 }, { 100, 0 }, { 100, 100 }, { 0, 100 } };
+
+    const int poly = plotter.GetOrCreateAperture( corners, 0.0, APERTURE::AM_FREE_POLYGON, 0 );
+
+    BOOST_CHECK_EQUAL( poly, 6 );
+    BOOST_CHECK_EQUAL( plotter.GetOrCreateAperture( corners, 0.0, APERTURE::AM_FREE_POLYGON, 0 ),
+                       poly );
+
+    corners[2] = wxPoint( 100, 101 );
+    BOOST_CHECK_EQUAL( plotter.GetOrCreateAperture( corners, 0.0, APERTURE::AM_FREE_POLYGON, 0 ),
+                       7 );
+
+    // Many distinct apertures
+    for( int ii = 0; ii < 10000; ++ii )
+    {
+        plotter.GetOrCreateAperture( wxSize( 1000 + ii, 500 ), 0, ii * 0.1,
+                                     APERTURE::AM_ROT_RECT, 0 );
+    }
+
+    BOOST_CHECK_EQUAL( plotter.GetOrCreateAperture( wxSize( 1000 + 1234, 500 ), 0, 1234 * 0.1,
+                                                    APERTURE::AM_ROT_RECT, 0 ), 8 + 1234 );
+}
+
+
+/**
+ * Check the aperture list is written in the header, before the body using it
+ */
+BOOST_AUTO_TEST_CASE( ApertureListBeforeBody )
+{
+    wxString fileName = wxFileName::CreateTempFileName( "qa_gerber" );
+
+    GERBER_PLOTTER plotter;
+    plotter.SetViewport( wxPoint( 0, 0 ), 1.0, 1.0, false );
+    plotter.SetGerberCoordinatesFormat( 5 );
+    BOOST_REQUIRE( plotter.OpenFile( fileName ) );
+    BOOST_REQUIRE( plotter.StartPlot() );
+
+    for( int ii = 0; ii < 100; ++ii )
+        plotter.FlashPadCircle( wxPoint( ii * 1000, 0 ), 100 + ( ii % 2 ) * 50, FILLED, nullptr );
+
+    BOOST_REQUIRE( plotter.EndPlot() );
+
+    wxString content;
+    wxFFile  file( fileName, "rb" );
+    BOOST_REQUIRE( file.ReadAll( &content ) );
+    file.Close();
+    wxRemoveFile( fileName );
+
+    wxArrayString lines = wxStringTokenize( content, "\r\n", wxTOKEN_STRTOK );
+
+    BOOST_REQUIRE( lines.GetCount() > 0 );
+    BOOST_CHECK( lines.Last() == "M02*" );
+
+    int listStart = lines.Index( "G04 APERTURE LIST*" );
+    int listEnd = lines.Index( "G04 APERTURE END LIST*" );
+    int firstUse = lines.Index( "D10*" );
+
+    BOOST_CHECK( listStart != wxNOT_FOUND );
+    BOOST_CHECK( listStart < listEnd );
+    BOOST_CHECK( listEnd < firstUse );
+    BOOST_CHECK_EQUAL( lines.Index( "%ADD10C,0.254000*%" ), listStart + 1 );
+    BOOST_CHECK_EQUAL( lines.Index( "%ADD11C,0.381000*%" ), listStart + 2 );
+    BOOST_CHECK_EQUAL( listEnd, listStart + 3 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,154 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for LIB_TREE_INDEX
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+// Code under test
+#include <lib_tree_index.h>
+
+#include <wx/ffile.h>
+#include <wx/filename.h>
+
+
+class TEST_LIB_TREE_INDEX_FIXTURE
+{
+public:
+    TEST_LIB_TREE_INDEX_FIXTURE() :
+            m_fileName( wxFileName::CreateTempFileName( "qa_lib_index" ) )
+    {
+    }
+
+    ~TEST_LIB_TREE_INDEX_FIXTURE()
+    {
+        wxRemoveFile( m_fileName );
+    }
+
+    /// Adds an item, with all its metadata set, to the library aNickname
+    void AddItem( LIB_TREE_INDEX::LIBRARY& aLib, const wxString& aNickname,
+                  const wxString& aName )
+    {
+        std::unique_ptr<LIB_TREE_INDEX::ITEM> item( new LIB_TREE_INDEX::ITEM() );
+
+        item->m_libId.SetLibNickname( aNickname );
+        item->m_libId.SetLibItemName( aName );
+        item->m_description = wxString::FromUTF8( "Op amp, 10 µA" );
+        item->m_keywords = "opamp";
+        item->m_searchText = "opamp        Op amp";
+        item->m_isRoot = false;
+        item->m_isPower = true;
+        item->m_padCount = 8;
+        item->m_unitReferences = { "A", "B" };
+        item->m_fields.emplace_back( "Footprint", "Package_SO:SOIC-8" );
+
+        aLib.m_Items.push_back( std::move( item ) );
+    }
+
+    wxString m_fileName;
+};
+
+
+/**
+ * Declare the test suite
+ */
+BOOST_FIXTURE_TEST_SUITE( LibTreeIndex, TEST_LIB_TREE_INDEX_FIXTURE )
+
+
+/**
+ * Check an index is read back as it was written
+ */
+BOOST_AUTO_TEST_CASE( RoundTrip )
+{
+    LIB_TREE_INDEX index;
+
+    LIB_TREE_INDEX::LIBRARY& lib = index.SetLibrary( "Amplifier", 1234567890123LL );
+    AddItem( lib, "Amplifier", "LM358" );
+    AddItem( lib, "Amplifier", "TL072" );
+    index.SetLibrary( "Empty", 42 );
+
+    BOOST_CHECK( index.IsModified() );
+    BOOST_REQUIRE( index.Save( m_fileName ) );
+
+    LIB_TREE_INDEX loaded;
+    BOOST_REQUIRE( loaded.Load( m_fileName ) );
+    BOOST_CHECK( !loaded.IsModified() );
+    BOOST_CHECK_EQUAL( loaded.GetLibraryCount(), 2 );
+
+    // Another timestamp means the library changed
+    BOOST_CHECK( loaded.FindLibrary( "Amplifier", 1234567890124LL ) == nullptr );
+    BOOST_CHECK( loaded.FindLibrary( "Missing", 42 ) == nullptr );
+    BOOST_CHECK( loaded.FindLibrary( "Empty", 42 ) != nullptr );
+
+    const LIB_TREE_INDEX::LIBRARY* found = loaded.FindLibrary( "Amplifier", 1234567890123LL );
+    BOOST_REQUIRE( found != nullptr );
+    BOOST_REQUIRE_EQUAL( found->m_Items.size(), 2 );
+
+    LIB_TREE_INDEX::ITEM& item = *found->m_Items[1];
+
+    BOOST_CHECK( item.GetName() == "TL072" );
+    BOOST_CHECK( item.GetLibNickname() == "Amplifier" );
+    BOOST_CHECK( item.GetDescription() == wxString::FromUTF8( "Op amp, 10 µA" ) );
+    BOOST_CHECK( item.m_keywords == "opamp" );
+    BOOST_CHECK( item.GetSearchText() == "opamp        Op amp" );
+    BOOST_CHECK( !item.IsRoot() );
+    BOOST_CHECK( item.m_isPower );
+    BOOST_CHECK_EQUAL( item.m_padCount, 8 );
+    BOOST_CHECK_EQUAL( item.GetUnitCount(), 2 );
+    BOOST_CHECK( item.GetUnitReference( 2 ) == "B" );
+    BOOST_REQUIRE_EQUAL( item.m_fields.size(), 1 );
+    BOOST_CHECK( item.m_fields[0].second == "Package_SO:SOIC-8" );
+
+    loaded.KeepLibraries( { "Amplifier" } );
+    BOOST_CHECK( loaded.IsModified() );
+    BOOST_CHECK_EQUAL( loaded.GetLibraryCount(), 1 );
+}
+
+
+/**
+ * Check a truncated file gives an empty index
+ */
+BOOST_AUTO_TEST_CASE( TruncatedFile )
+{
+    LIB_TREE_INDEX index;
+    AddItem( index.SetLibrary( "Amplifier", 1 ), "Amplifier", "LM358" );
+    BOOST_REQUIRE( index.Save( m_fileName ) );
+
+    wxString content;
+    wxFFile  in( m_fileName, "rb" );
+    BOOST_REQUIRE( in.ReadAll( &content, wxConvISO8859_1 ) );
+    in.Close();
+
+    wxFFile out( m_fileName, "wb" );
+    BOOST_REQUIRE( out.Write( content.Left( content.length() - 3 ), wxConvISO8859_1 ) );
+    out.Close();
+
+    LIB_TREE_INDEX loaded;
+    BOOST_CHECK( !loaded.Load( m_fileName ) );
+    BOOST_CHECK_EQUAL( loaded.GetLibraryCount(), 0 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,186 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for the search scores of LIB_TREE_NODE_ROOT
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+// Code under test
+#include <common/lib_tree_model.h>
+
+#include <eda_pattern_match.h>
+
+#include <wx/tokenzr.h>
+
+
+/**
+ * A library item with no unit
+ */
+class TEST_TREE_ITEM : public LIB_TREE_ITEM
+{
+public:
+    TEST_TREE_ITEM( const wxString& aLib, const wxString& aName, const wxString& aDesc ) :
+            m_libId( aLib, aName ),
+            m_desc( aDesc )
+    {}
+
+    LIB_ID GetLibId() const override { return m_libId; }
+    wxString GetName() const override { return m_libId.GetLibItemName(); }
+    wxString GetLibNickname() const override { return m_libId.GetLibNickname(); }
+    wxString GetDescription() override { return m_desc; }
+    wxString GetSearchText() override { return m_desc; }
+
+private:
+    LIB_ID   m_libId;
+    wxString m_desc;
+};
+
+
+class TEST_LIB_TREE_MODEL_FIXTURE
+{
+public:
+    TEST_LIB_TREE_MODEL_FIXTURE()
+    {
+        const std::vector<wxString> words = { "Amplifier", "OpAmp", "Resistor", "Capacitor",
+                                              "LED", "Diode", "Connector", "R=10k", "C=100n",
+                                              "dual", "Quad", "Regulator", "SOIC-8", "TO-220" };
+
+        for( const wxString& lib : { "Device", "Amplifier_Operational", "Regulator_Linear" } )
+        {
+            for( int ii = 0; ii < 200; ++ii )
+            {
+                wxString name = wxString::Format( "%s_%d", words[ii % words.size()], ii );
+                wxString desc = words[( ii * 7 ) % words.size()] + " "
+                                + words[( ii * 3 + 1 ) % words.size()];
+
+                m_items.emplace_back( new TEST_TREE_ITEM( lib, name, desc ) );
+            }
+        }
+
+        fill( m_indexed );
+        fill( m_reference );
+    }
+
+    void fill( LIB_TREE_NODE_ROOT& aTree )
+    {
+        LIB_TREE_NODE_LIB* lib = nullptr;
+
+        for( const std::unique_ptr<TEST_TREE_ITEM>& item : m_items )
+        {
+            if( !lib || lib->m_Name != item->GetLibNickname() )
+                lib = &aTree.AddLib( item->GetLibNickname(), wxEmptyString );
+
+            lib->AddItem( item.get() );
+        }
+
+        aTree.AssignIntrinsicRanks();
+    }
+
+    /// The scores of a full search, scoring every node for every term
+    void referenceSearch( const wxString& aSearch )
+    {
+        m_reference.ResetScore();
+
+        wxStringTokenizer tokenizer( aSearch.Lower() );
+
+        while( tokenizer.HasMoreTokens() )
+        {
+            EDA_COMBINED_MATCHER matcher( tokenizer.GetNextToken() );
+
+            for( auto& lib : m_reference.m_Children )
+                lib->UpdateScore( matcher );
+        }
+    }
+
+    void checkSameScores( const wxString& aSearch )
+    {
+        m_indexed.UpdateSearchScores( aSearch );
+        referenceSearch( aSearch );
+
+        BOOST_TEST_CONTEXT( "Search \"" << aSearch << "\"" )
+        {
+            BOOST_REQUIRE_EQUAL( m_indexed.m_Children.size(), m_reference.m_Children.size() );
+
+            for( size_t ii = 0; ii < m_indexed.m_Children.size(); ++ii )
+            {
+                LIB_TREE_NODE* indexedLib = m_indexed.m_Children[ii].get();
+                LIB_TREE_NODE* referenceLib = m_reference.m_Children[ii].get();
+
+                BOOST_CHECK_EQUAL( indexedLib->m_Score, referenceLib->m_Score );
+
+                for( size_t jj = 0; jj < indexedLib->m_Children.size(); ++jj )
+                {
+                    BOOST_CHECK_EQUAL( indexedLib->m_Children[jj]->m_Score,
+                                       referenceLib->m_Children[jj]->m_Score );
+                }
+            }
+        }
+    }
+
+    std::vector<std::unique_ptr<TEST_TREE_ITEM>> m_items;
+    LIB_TREE_NODE_ROOT                           m_indexed;
+    LIB_TREE_NODE_ROOT                           m_reference;
+};
+
+
+/**
+ * Declare the test suite
+ */
+BOOST_FIXTURE_TEST_SUITE( LibTreeModel, TEST_LIB_TREE_MODEL_FIXTURE )
+
+
+/**
+ * Check the indexed search gives the scores of a full search, while typing
+ */
+BOOST_AUTO_TEST_CASE( IndexedScores )
+{
+    for( const wxString& search : { "o", "op", "opa", "opam", "opamp", "opamp d", "opamp du",
+                                    "opamp dua", "opamp dual", "opamp duo", "regul", "regulator",
+                                    "amp", "r=", "r>1k", "r<1k", "op*", "o?amp", "soic-8",
+                                    "to-22", "xyz", "device", "led 1", "" } )
+    {
+        checkSameScores( search );
+    }
+}
+
+
+/**
+ * Check the search index follows the changes of the tree
+ */
+BOOST_AUTO_TEST_CASE( IndexedScoresAfterChange )
+{
+    checkSameScores( "zener" );
+
+    TEST_TREE_ITEM zener( "Device", "D_Zener", "Zener diode" );
+
+    for( LIB_TREE_NODE_ROOT* tree : { &m_indexed, &m_reference } )
+        static_cast<LIB_TREE_NODE_LIB*>( tree->m_Children[0].get() )->AddItem( &zener );
+
+    checkSameScores( "zener" );
+    checkSameScores( "zener d" );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,199 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for the decimated plot of mpFXYVector
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+// Code under test
+#include <widgets/mathplot.h>
+
+#include <algorithm>
+#include <cmath>
+
+
+class TEST_MATHPLOT_FIXTURE
+{
+public:
+    /// Fills the layer with a noisy sine of aCount points, one per microsecond
+    void SetSine( size_t aCount )
+    {
+        m_xs.resize( aCount );
+        m_ys.resize( aCount );
+
+        for( size_t ii = 0; ii < aCount; ++ii )
+        {
+            m_xs[ii] = ii * 1e-6;
+            m_ys[ii] = sin( ii * 1e-3 ) + ( ( ii * 7919 ) % 101 ) * 1e-3;
+        }
+
+        m_layer.SetData( m_xs, m_ys );
+    }
+
+    /**
+     * Checks the indices are in increasing order, start and end at the points around
+     * [aMinX, aMaxX] and keep the extreme points of this range.
+     */
+    void CheckIndices( double aMinX, double aMaxX, const std::vector<size_t>& aIndices )
+    {
+        BOOST_REQUIRE( !aIndices.empty() );
+        BOOST_CHECK( std::is_sorted( aIndices.begin(), aIndices.end() ) );
+        BOOST_CHECK( std::adjacent_find( aIndices.begin(), aIndices.end() ) == aIndices.end() );
+
+        size_t first = std::lower_bound( m_xs.begin(), m_xs.end(), aMinX ) - m_xs.begin();
+        size_t last = std::upper_bound( m_xs.begin(), m_xs.end(), aMaxX ) - m_xs.begin();
+        first = first > 0 ? first - 1 : 0;
+        last = std::min( last, m_xs.size() - 1 );
+
+        BOOST_CHECK_EQUAL( aIndices.front(), first );
+        BOOST_CHECK_EQUAL( aIndices.back(), last );
+
+        size_t minIdx = std::min_element( m_ys.begin() + first, m_ys.begin() + last + 1 )
+                        - m_ys.begin();
+        size_t maxIdx = std::max_element( m_ys.begin() + first, m_ys.begin() + last + 1 )
+                        - m_ys.begin();
+
+        BOOST_CHECK( std::binary_search( aIndices.begin(), aIndices.end(), minIdx ) );
+        BOOST_CHECK( std::binary_search( aIndices.begin(), aIndices.end(), maxIdx ) );
+    }
+
+    std::vector<double> m_xs, m_ys;
+    mpFXYVector         m_layer;
+};
+
+
+/**
+ * Declare the test suite
+ */
+BOOST_FIXTURE_TEST_SUITE( Mathplot, TEST_MATHPLOT_FIXTURE )
+
+
+/**
+ * Check a view of many points per pixel is reduced to a few points per pixel
+ */
+BOOST_AUTO_TEST_CASE( DecimatedRange )
+{
+    const int pixels = 1000;
+
+    SetSine( 1000003 );
+
+    std::vector<size_t> indices;
+
+    for( double start : { -0.1, 0.0, 0.123456, 0.5 } )
+    {
+        for( double width : { 0.01, 0.3, 2.0 } )
+        {
+            BOOST_TEST_CONTEXT( "Range " << start << " + " << width )
+            {
+                m_layer.GetPlotIndices( start, start + width, pixels, indices );
+                CheckIndices( start, start + width, indices );
+
+                BOOST_CHECK_LE( indices.size(), 16 * pixels );
+            }
+        }
+    }
+
+    // A reversed range is the same range
+    std::vector<size_t> reversed;
+    m_layer.GetPlotIndices( 0.3, 0.1, pixels, reversed );
+    m_layer.GetPlotIndices( 0.1, 0.3, pixels, indices );
+    BOOST_CHECK( reversed == indices );
+}
+
+
+/**
+ * Check all the points of the range are given when there are few of them, or no pixel count
+ */
+BOOST_AUTO_TEST_CASE( FullRange )
+{
+    SetSine( 1000 );
+
+    std::vector<size_t> indices;
+
+    m_layer.GetPlotIndices( 0.0002, 0.0005, 1000, indices );
+    CheckIndices( 0.0002, 0.0005, indices );
+    BOOST_CHECK_EQUAL( indices.size(), 302 );
+
+    SetSine( 100000 );
+
+    m_layer.GetPlotIndices( 0.01, 0.05, 0, indices );
+    CheckIndices( 0.01, 0.05, indices );
+    BOOST_CHECK_EQUAL( indices.size(), 40003 );
+}
+
+
+/**
+ * Check data appended in chunks is plotted as the same data set at once
+ */
+BOOST_AUTO_TEST_CASE( AppendedData )
+{
+    SetSine( 300007 );
+
+    mpFXYVector appended;
+
+    size_t size = 1;
+
+    for( size_t start = 0; start < m_xs.size(); start += size )
+    {
+        size = size * 3 % 1001 + 1;
+        size_t end = std::min( m_xs.size(), start + size );
+
+        appended.AppendData( std::vector<double>( m_xs.begin() + start, m_xs.begin() + end ),
+                             std::vector<double>( m_ys.begin() + start, m_ys.begin() + end ) );
+    }
+
+    BOOST_CHECK_EQUAL( appended.GetMinY(), m_layer.GetMinY() );
+    BOOST_CHECK_EQUAL( appended.GetMaxY(), m_layer.GetMaxY() );
+    BOOST_CHECK_EQUAL( appended.GetMaxX(), m_layer.GetMaxX() );
+
+    std::vector<size_t> expected, found;
+
+    for( double start : { 0.0, 0.0123, 0.2 } )
+    {
+        m_layer.GetPlotIndices( start, start + 0.1, 500, expected );
+        appended.GetPlotIndices( start, start + 0.1, 500, found );
+
+        BOOST_CHECK( found == expected );
+    }
+}
+
+
+/**
+ * Check unsorted data (a locus) is given as a whole
+ */
+BOOST_AUTO_TEST_CASE( UnsortedData )
+{
+    std::vector<double> xs = { 0.0, 2.0, 1.0, 3.0 };
+    std::vector<double> ys = { 0.0, 1.0, 2.0, 3.0 };
+    std::vector<size_t> indices;
+
+    m_layer.SetData( xs, ys );
+    m_layer.GetPlotIndices( 1.5, 1.6, 1, indices );
+
+    BOOST_CHECK( indices == std::vector<size_t>( { 0, 1, 2, 3 } ) );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,88 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for the points streamed by NGSPICE while a simulation runs
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+#include <string>
+#include <vector>
+
+// Code under test
+#include <sim/ngspice.h>
+
+
+/**
+ * Declare the test suite
+ */
+BOOST_AUTO_TEST_SUITE( Ngspice )
+
+
+/**
+ * Check the vectors requested the way SIM_PLOT_FRAME::setupLiveUpdate() does (the X axis,
+ * then the vectors given by NETLIST_EXPORTER_PSPICE_SIM::ComponentToVector()) receive the
+ * points of a transient analysis, as SIM_PLOT_FRAME::onLiveUpdate() reads them.
+ */
+BOOST_AUTO_TEST_CASE( StreamedTransientVectors )
+{
+    const std::string netlist =
+            "* Streaming test\n"
+            "V1 in 0 PULSE( 0 1 0 1u 1u 1m 2m )\n"
+            "R1 in Out 1k\n"
+            "C1 Out 0 1u\n"
+            ".tran 10u 2m\n"
+            ".end\n";
+
+    NGSPICE sim;
+    sim.Init();
+    sim.LoadNetlist( netlist );
+
+    const std::vector<std::string> vectors = { sim.GetXAxis( ST_TRANSIENT ), "V(Out)" };
+    sim.SetStreamedVectors( vectors );
+
+    // A foreground run calls the data callbacks the same way as the background one
+    sim.Command( "run" );
+
+    std::vector<std::vector<double>> points;
+    sim.GetNewPoints( vectors, points );
+
+    BOOST_REQUIRE_EQUAL( points.size(), vectors.size() );
+    BOOST_REQUIRE( !points[0].empty() );
+
+    // The voltage trace gets a point for each point of the X axis
+    BOOST_CHECK_EQUAL( points[1].size(), points[0].size() );
+
+    std::vector<double> expected = sim.GetRealPlot( "V(Out)" );
+
+    BOOST_REQUIRE_EQUAL( points[1].size(), expected.size() );
+    BOOST_CHECK_CLOSE( points[1].back(), expected.back(), 1e-6 );
+
+    // The points are handed over once
+    sim.GetNewPoints( vectors, points );
+    BOOST_CHECK( points[0].empty() && points[1].empty() );
+
+    sim.SetStreamedVectors( std::vector<std::string>() );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
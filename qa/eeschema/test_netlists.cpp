@@ -26,6 +26,8 @@
 #include <netlist_reader/pcb_netlist.h>
 #include <project.h>
 #include <sch_io_mgr.h>
+#include <sch_line.h>
+#include <sch_screen.h>
 #include <sch_sheet.h>
 #include <schematic.h>
 #include <settings/settings_manager.h>
@@ -54,6 +56,8 @@ public:
 
     void doNetlistTest( const wxString& aBaseName );
 
+    void doIncrementalNetlistTest( const wxString& aBaseName );
+
     ///> Schematic to load
     SCHEMATIC m_schematic;
 
@@ -208,6 +212,89 @@ void TEST_NETLISTS_FIXTURE::doNetlistTest( const wxString& aBaseName )
 }
 
 
+/// The code of each net of a connection graph, by net name
+static std::map<wxString, int> getNetCodes( CONNECTION_GRAPH* aGraph )
+{
+    std::map<wxString, int> codes;
+
+    for( const auto& net : aGraph->GetNetMap() )
+        codes[net.first.first] = net.first.second;
+
+    return codes;
+}
+
+
+void TEST_NETLISTS_FIXTURE::doIncrementalNetlistTest( const wxString& aBaseName )
+{
+    loadSchematic( aBaseName );
+
+    CONNECTION_GRAPH*       graph = m_schematic.ConnectionGraph();
+    SCH_SHEET_LIST          sheets = m_schematic.GetSheets();
+    SCH_SCREEN*             screen = sheets.back().LastScreen();
+    std::map<wxString, int> fullCodes = getNetCodes( graph );
+
+    SCH_LINE* wire = nullptr;
+
+    for( SCH_ITEM* item : screen->Items().OfType( SCH_LINE_T ) )
+    {
+        if( static_cast<SCH_LINE*>( item )->IsWire() )
+        {
+            wire = static_cast<SCH_LINE*>( item );
+            break;
+        }
+    }
+
+    BOOST_REQUIRE( wire );
+
+    // Delete a wire of the last sheet, and update that sheet only
+    screen->Remove( wire );
+    graph->Recalculate( sheets, false );
+
+    std::map<wxString, int> removedCodes = getNetCodes( graph );
+
+    // The nets which still exist keep their code
+    for( const auto& net : removedCodes )
+    {
+        auto fullNet = fullCodes.find( net.first );
+
+        if( fullNet != fullCodes.end() )
+            BOOST_CHECK_MESSAGE( net.second == fullNet->second, net.first );
+    }
+
+    // The same nets as after a full update
+    graph->Recalculate( sheets, true );
+    std::map<wxString, int> removedFullCodes = getNetCodes( graph );
+
+    BOOST_REQUIRE_EQUAL( removedCodes.size(), removedFullCodes.size() );
+
+    for( const auto& net : removedFullCodes )
+        BOOST_CHECK_MESSAGE( removedCodes.count( net.first ), net.first );
+
+    // Put the wire back: the nets are the original ones, and the unchanged nets keep
+    // their code
+    screen->Append( wire );
+    graph->Recalculate( sheets, false );
+
+    std::map<wxString, int> restoredCodes = getNetCodes( graph );
+
+    BOOST_REQUIRE_EQUAL( restoredCodes.size(), fullCodes.size() );
+
+    for( const auto& net : restoredCodes )
+    {
+        auto removedNet = removedFullCodes.find( net.first );
+
+        BOOST_CHECK_MESSAGE( fullCodes.count( net.first ), net.first );
+
+        if( removedNet != removedFullCodes.end() )
+            BOOST_CHECK_MESSAGE( net.second == removedNet->second, net.first );
+    }
+
+    writeNetlist();
+    compareNetlists();
+    cleanup();
+}
+
+
 BOOST_FIXTURE_TEST_SUITE( Netlists, TEST_NETLISTS_FIXTURE )
 
 
@@ -247,5 +334,17 @@ BOOST_AUTO_TEST_CASE( WeakVectorBusDisambiguation )
 }
 
 
+BOOST_AUTO_TEST_CASE( IncrementalComplexHierarchy )
+{
+    doIncrementalNetlistTest( "complex_hierarchy" );
+}
+
+
+BOOST_AUTO_TEST_CASE( IncrementalVideo )
+{
+    doIncrementalNetlistTest( "video" );
+}
+
+
 
 BOOST_AUTO_TEST_SUITE_END()
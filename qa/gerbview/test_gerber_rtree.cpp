@@ -0,0 +1,240 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for the spatial index of GERBER_FILE_IMAGE
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <profile.h>
+
+// Code under test
+#include <gerber_file_image.h>
+
+#include <algorithm>
+
+
+class TEST_GERBER_RTREE_FIXTURE
+{
+public:
+    TEST_GERBER_RTREE_FIXTURE() : m_image( 0 )
+    {
+        D_CODE* pad = m_image.GetDCODEOrCreate( 10 );
+        pad->m_Shape = APT_CIRCLE;
+        pad->m_Size = wxSize( m_pitch / 2, m_pitch / 2 );
+        pad->m_Defined = true;
+
+        D_CODE* track = m_image.GetDCODEOrCreate( 11 );
+        track->m_Shape = APT_CIRCLE;
+        track->m_Size = wxSize( m_pitch / 10, m_pitch / 10 );
+        track->m_Defined = true;
+    }
+
+    /**
+     * Fills the image with a grid of aCount x aCount flashed pads, and a diagonal track
+     * on each row.
+     */
+    void BuildGrid( int aCount )
+    {
+        for( int row = 0; row < aCount; ++row )
+        {
+            for( int col = 0; col < aCount; ++col )
+            {
+                GERBER_DRAW_ITEM* item = new GERBER_DRAW_ITEM( &m_image );
+                item->m_Shape = GBR_SPOT_CIRCLE;
+                item->m_Flashed = true;
+                item->m_DCode = 10;
+                item->m_Size = wxSize( m_pitch / 2, m_pitch / 2 );
+                item->m_Start = item->m_End = wxPoint( col * m_pitch, row * m_pitch );
+                m_image.AddItemToList( item );
+            }
+
+            GERBER_DRAW_ITEM* item = new GERBER_DRAW_ITEM( &m_image );
+            item->m_Shape = GBR_SEGMENT;
+            item->m_DCode = 11;
+            item->m_Size = wxSize( m_pitch / 10, m_pitch / 10 );
+            item->m_Start = wxPoint( 0, row * m_pitch + m_pitch / 2 );
+            item->m_End = wxPoint( aCount * m_pitch, ( row + 1 ) * m_pitch );
+            m_image.AddItemToList( item );
+        }
+    }
+
+    /// Items hit at aPos, found by testing all the items
+    std::vector<GERBER_DRAW_ITEM*> HitAll( const wxPoint& aPos )
+    {
+        std::vector<GERBER_DRAW_ITEM*> hits;
+
+        for( GERBER_DRAW_ITEM* item : m_image.GetItems() )
+        {
+            if( item->HitTest( aPos ) )
+                hits.push_back( item );
+        }
+
+        std::sort( hits.begin(), hits.end() );
+        return hits;
+    }
+
+    /// Items hit at aPos, found from the spatial index
+    std::vector<GERBER_DRAW_ITEM*> HitIndexed( const wxPoint& aPos )
+    {
+        std::vector<GERBER_DRAW_ITEM*> hits;
+
+        m_image.QueryItems( EDA_RECT( aPos, wxSize( 0, 0 ) ),
+                [&]( GERBER_DRAW_ITEM* aItem )
+                {
+                    if( aItem->HitTest( aPos ) )
+                        hits.push_back( aItem );
+
+                    return true;
+                } );
+
+        std::sort( hits.begin(), hits.end() );
+        return hits;
+    }
+
+    /**
+     * A pseudo random position in the grid area, reproducible between runs.  The grid is
+     * built in XY coordinates, but clicks are in the AB coordinates used by HitTest().
+     */
+    wxPoint ClickPosition( int aIndex, int aCount )
+    {
+        const int range = aCount * m_pitch;
+        wxPoint   xyPos( ( aIndex * 7919LL * 1009 ) % range, ( aIndex * 6271LL * 3037 ) % range );
+
+        return m_image.GetItems().front()->GetABPosition( xyPos );
+    }
+
+    const int         m_pitch = 1000000;
+    GERBER_FILE_IMAGE m_image;
+};
+
+
+/**
+ * Declare the test suite
+ */
+BOOST_FIXTURE_TEST_SUITE( GerberRtree, TEST_GERBER_RTREE_FIXTURE )
+
+
+/**
+ * Check the index finds the same items as a test of all the items
+ */
+BOOST_AUTO_TEST_CASE( SameHitsAsFullScan )
+{
+    const int count = 100;
+
+    BuildGrid( count );
+
+    int hitClicks = 0;
+
+    for( int ii = 0; ii < 1000; ++ii )
+    {
+        wxPoint pos = ClickPosition( ii, count );
+
+        BOOST_TEST_CONTEXT( "Click at " << pos.x << ", " << pos.y )
+        {
+            std::vector<GERBER_DRAW_ITEM*> expected = HitAll( pos );
+            std::vector<GERBER_DRAW_ITEM*> found = HitIndexed( pos );
+
+            BOOST_CHECK_EQUAL_COLLECTIONS( found.begin(), found.end(),
+                                           expected.begin(), expected.end() );
+
+            if( !expected.empty() )
+                hitClicks++;
+        }
+    }
+
+    // Comparing empty sets proves nothing: make sure the clicks actually land on items
+    BOOST_CHECK_GT( hitClicks, 100 );
+
+    // Clicking the centre of a pad always finds it
+    for( GERBER_DRAW_ITEM* pad : m_image.GetItems() )
+    {
+        if( !pad->m_Flashed )
+            continue;
+
+        wxPoint pos = pad->GetABPosition( pad->m_Start );
+
+        BOOST_TEST_CONTEXT( "Click at " << pos.x << ", " << pos.y )
+        {
+            std::vector<GERBER_DRAW_ITEM*> found = HitIndexed( pos );
+
+            BOOST_CHECK( std::find( found.begin(), found.end(), pad ) != found.end() );
+        }
+    }
+
+    // Items added after a query are indexed at the next query
+    GERBER_DRAW_ITEM* item = new GERBER_DRAW_ITEM( &m_image );
+    item->m_Shape = GBR_SPOT_CIRCLE;
+    item->m_Flashed = true;
+    item->m_DCode = 10;
+    item->m_Start = item->m_End = wxPoint( -10 * m_pitch, -10 * m_pitch );
+    m_image.AddItemToList( item );
+
+    std::vector<GERBER_DRAW_ITEM*> found = HitIndexed( item->GetABPosition( item->m_Start ) );
+    BOOST_CHECK( found.size() == 1 && found[0] == item );
+}
+
+
+/**
+ * Click latency on a million-item image, with and without the index.
+ * Disabled by default (it needs about a GB of memory), run it with
+ * qa_gerbview --run_test=GerberRtree/ClickLatency --log_level=message
+ */
+BOOST_AUTO_TEST_CASE( ClickLatency, *boost::unit_test::disabled() )
+{
+    const int count = 1000;
+    const int clicks = 20;
+
+    BuildGrid( count );
+
+    PROF_COUNTER indexTimer;
+    m_image.UpdateItemsTree();
+    BOOST_TEST_MESSAGE( m_image.GetItemsCount() << " items indexed in "
+                        << indexTimer.msecs() << " ms" );
+
+    double fullScanMs = 0.0;
+    double indexedMs = 0.0;
+
+    for( int ii = 0; ii < clicks; ++ii )
+    {
+        wxPoint pos = ClickPosition( ii, count );
+
+        PROF_COUNTER fullScanTimer;
+        std::vector<GERBER_DRAW_ITEM*> expected = HitAll( pos );
+        fullScanMs += fullScanTimer.msecs();
+
+        PROF_COUNTER indexedTimer;
+        std::vector<GERBER_DRAW_ITEM*> found = HitIndexed( pos );
+        indexedMs += indexedTimer.msecs();
+
+        BOOST_CHECK_EQUAL_COLLECTIONS( found.begin(), found.end(),
+                                       expected.begin(), expected.end() );
+    }
+
+    BOOST_TEST_MESSAGE( "Click latency: full scan " << fullScanMs / clicks << " ms, indexed "
+                        << indexedMs / clicks << " ms" );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,342 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for TRACKS_CLEANER and GRAPHICS_CLEANER: the redundant items found on synthetic
+ * boards are compared with the ones found by testing all the pairs of items.
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <board_commit.h>
+#include <class_board.h>
+#include <class_track.h>
+#include <cleanup_item.h>
+#include <graphics_cleaner.h>
+#include <pcb_shape.h>
+#include <tool/tool_manager.h>
+#include <tracks_cleaner.h>
+
+#include <set>
+
+
+/**
+ * A cleanup item, reduced to its error code and items
+ */
+struct CLEANUP_RESULT
+{
+    int  m_code;
+    KIID m_main;
+    KIID m_aux;
+
+    bool operator==( const CLEANUP_RESULT& aOther ) const
+    {
+        return m_code == aOther.m_code && m_main == aOther.m_main && m_aux == aOther.m_aux;
+    }
+};
+
+
+std::ostream& operator<<( std::ostream& os, const CLEANUP_RESULT& aResult )
+{
+    os << "CLEANUP_RESULT[ " << aResult.m_code << ": " << aResult.m_main.AsString() << ", "
+       << aResult.m_aux.AsString() << " ]";
+    return os;
+}
+
+
+class TEST_CLEANERS_FIXTURE
+{
+public:
+    TEST_CLEANERS_FIXTURE() :
+            m_commit( &m_toolMgr ),
+            m_seed( 1 )
+    {
+    }
+
+    /// A reproducible pseudo random number in [0, aRange)
+    int Random( int aRange )
+    {
+        m_seed = m_seed * 1103515245 + 12345;
+        return (int) ( ( m_seed >> 16 ) % aRange );
+    }
+
+    /// A point on a coarse grid, so that many items share their positions
+    wxPoint RandomPoint()
+    {
+        return wxPoint( Random( 30 ) * 100000, Random( 30 ) * 100000 );
+    }
+
+    /**
+     * Fill the board with vias and tracks: some vias are superimposed, some tracks are
+     * duplicated (possibly reversed), null or locked.
+     */
+    void FillTracks( int aCount )
+    {
+        const VIATYPE viaTypes[] = { VIATYPE::THROUGH, VIATYPE::MICROVIA, VIATYPE::BLIND_BURIED };
+
+        for( int ii = 0; ii < aCount; ++ii )
+        {
+            VIA* via = new VIA( &m_board );
+            via->SetPosition( RandomPoint() );
+            via->SetViaType( viaTypes[Random( 3 )] );
+            via->SetLayerPair( F_Cu, B_Cu );
+            via->SetWidth( 600000 );
+            via->SetLocked( Random( 10 ) == 0 );
+            m_board.Add( via );
+        }
+
+        for( int ii = 0; ii < aCount; ++ii )
+        {
+            TRACK* track = new TRACK( &m_board );
+            wxPoint start = RandomPoint();
+
+            track->SetStart( start );
+            track->SetEnd( Random( 20 ) == 0 ? start : RandomPoint() );
+            track->SetWidth( Random( 2 ) ? 250000 : 500000 );
+            track->SetLayer( Random( 2 ) ? F_Cu : B_Cu );
+            track->SetLocked( Random( 10 ) == 0 );
+            m_board.Add( track );
+
+            if( Random( 4 ) == 0 )
+            {
+                TRACK* duplicate = static_cast<TRACK*>( track->Duplicate() );
+                duplicate->SetLocked( false );
+
+                if( Random( 2 ) )
+                {
+                    duplicate->SetStart( track->GetEnd() );
+                    duplicate->SetEnd( track->GetStart() );
+                }
+
+                m_board.Add( duplicate );
+            }
+        }
+
+        m_board.BuildConnectivity();
+    }
+
+    /**
+     * Fill the board with graphic segments, some duplicated or null.
+     */
+    void FillDrawings( int aCount )
+    {
+        for( int ii = 0; ii < aCount; ++ii )
+        {
+            PCB_SHAPE* shape = new PCB_SHAPE( &m_board );
+            wxPoint    start = RandomPoint();
+
+            shape->SetShape( S_SEGMENT );
+            shape->SetStart( start );
+            shape->SetEnd( Random( 20 ) == 0 ? start : RandomPoint() );
+            shape->SetWidth( Random( 2 ) ? 150000 : 100000 );
+            shape->SetLayer( Random( 2 ) ? F_SilkS : Edge_Cuts );
+            m_board.Add( shape );
+
+            if( Random( 4 ) == 0 )
+            {
+                PCB_SHAPE* duplicate = static_cast<PCB_SHAPE*>( shape->Duplicate() );
+                m_board.Add( duplicate );
+            }
+        }
+    }
+
+    /// The cleanup items of the given codes
+    static std::vector<CLEANUP_RESULT> Filter(
+            const std::vector<std::shared_ptr<CLEANUP_ITEM>>& aItems, const std::set<int>& aCodes )
+    {
+        std::vector<CLEANUP_RESULT> results;
+
+        for( const std::shared_ptr<CLEANUP_ITEM>& item : aItems )
+        {
+            if( aCodes.count( item->GetErrorCode() ) )
+                results.push_back( { item->GetErrorCode(), item->GetMainItemID(),
+                                     item->GetAuxItemID() } );
+        }
+
+        return results;
+    }
+
+    /// The redundant vias and duplicated tracks found by testing all the pairs of items
+    std::vector<CLEANUP_RESULT> PairwiseTracks()
+    {
+        std::vector<CLEANUP_RESULT> results;
+        std::vector<VIA*>           vias;
+
+        for( TRACK* track : m_board.Tracks() )
+        {
+            if( track->Type() == PCB_VIA_T )
+                vias.push_back( static_cast<VIA*>( track ) );
+        }
+
+        for( size_t ii = 0; ii < vias.size(); ++ii )
+        {
+            if( vias[ii]->IsLocked() )
+                continue;
+
+            for( size_t jj = ii + 1; jj < vias.size(); ++jj )
+            {
+                if( vias[ii]->GetPosition() != vias[jj]->GetPosition() || vias[jj]->IsLocked() )
+                    continue;
+
+                if( vias[ii]->GetViaType() == vias[jj]->GetViaType() )
+                {
+                    results.push_back( { CLEANUP_REDUNDANT_VIA, vias[ii]->m_Uuid,
+                                         vias[jj]->m_Uuid } );
+                    break;
+                }
+            }
+        }
+
+        std::vector<TRACK*> tracks( m_board.Tracks().begin(), m_board.Tracks().end() );
+        std::set<TRACK*>    deleted;
+
+        for( size_t ii = 0; ii < tracks.size(); ++ii )
+        {
+            TRACK* track1 = tracks[ii];
+
+            if( track1->Type() != PCB_TRACE_T || deleted.count( track1 ) || track1->IsLocked() )
+                continue;
+
+            for( size_t jj = ii + 1; jj < tracks.size(); ++jj )
+            {
+                TRACK* track2 = tracks[jj];
+
+                if( deleted.count( track2 ) )
+                    continue;
+
+                if( track1->IsPointOnEnds( track2->GetStart() )
+                        && track1->IsPointOnEnds( track2->GetEnd() )
+                        && track1->GetWidth() == track2->GetWidth()
+                        && track1->GetLayer() == track2->GetLayer() )
+                {
+                    results.push_back( { CLEANUP_DUPLICATE_TRACK, track2->m_Uuid, niluuid } );
+                    deleted.insert( track2 );
+                }
+            }
+        }
+
+        return results;
+    }
+
+    /// The null and duplicated graphic segments found by testing all the pairs of items
+    std::vector<CLEANUP_RESULT> PairwiseDrawings()
+    {
+        std::vector<CLEANUP_RESULT> results;
+        std::vector<PCB_SHAPE*>     shapes;
+        std::set<PCB_SHAPE*>        deleted;
+
+        for( BOARD_ITEM* item : m_board.Drawings() )
+            shapes.push_back( static_cast<PCB_SHAPE*>( item ) );
+
+        for( size_t ii = 0; ii < shapes.size(); ++ii )
+        {
+            PCB_SHAPE* shape1 = shapes[ii];
+
+            if( deleted.count( shape1 ) )
+                continue;
+
+            if( shape1->GetStart() == shape1->GetEnd() )
+            {
+                results.push_back( { CLEANUP_NULL_GRAPHIC, shape1->m_Uuid, niluuid } );
+                continue;
+            }
+
+            for( size_t jj = ii + 1; jj < shapes.size(); ++jj )
+            {
+                PCB_SHAPE* shape2 = shapes[jj];
+
+                if( deleted.count( shape2 ) )
+                    continue;
+
+                if( shape1->GetStart() == shape2->GetStart()
+                        && shape1->GetEnd() == shape2->GetEnd()
+                        && shape1->GetLayer() == shape2->GetLayer()
+                        && shape1->GetWidth() == shape2->GetWidth() )
+                {
+                    results.push_back( { CLEANUP_DUPLICATE_GRAPHIC, shape2->m_Uuid, niluuid } );
+                    deleted.insert( shape2 );
+                }
+            }
+        }
+
+        return results;
+    }
+
+    BOARD        m_board;
+    TOOL_MANAGER m_toolMgr;
+    BOARD_COMMIT m_commit;
+    unsigned     m_seed;
+};
+
+
+/**
+ * Declare the test suite
+ */
+BOOST_FIXTURE_TEST_SUITE( Cleaners, TEST_CLEANERS_FIXTURE )
+
+
+/**
+ * Check the redundant vias and duplicated tracks are the ones found pairwise
+ */
+BOOST_AUTO_TEST_CASE( TracksCleanerSameAsPairwise )
+{
+    FillTracks( 1000 );
+
+    std::vector<std::shared_ptr<CLEANUP_ITEM>> items;
+    TRACKS_CLEANER                             cleaner( &m_board, m_commit );
+
+    // Dry run: clean vias and merge segments only
+    cleaner.CleanupBoard( true, &items, false, true, true, false, false, false );
+
+    std::vector<CLEANUP_RESULT> found = Filter( items, { CLEANUP_REDUNDANT_VIA,
+                                                         CLEANUP_DUPLICATE_TRACK } );
+    std::vector<CLEANUP_RESULT> expected = PairwiseTracks();
+
+    BOOST_CHECK( !expected.empty() );
+    BOOST_CHECK_EQUAL_COLLECTIONS( found.begin(), found.end(), expected.begin(), expected.end() );
+}
+
+
+/**
+ * Check the null and duplicated graphic segments are the ones found pairwise
+ */
+BOOST_AUTO_TEST_CASE( GraphicsCleanerSameAsPairwise )
+{
+    FillDrawings( 2000 );
+
+    std::vector<std::shared_ptr<CLEANUP_ITEM>> items;
+    GRAPHICS_CLEANER                           cleaner( m_board.Drawings(), nullptr, m_commit );
+
+    // Dry run: delete redundant graphics only
+    cleaner.CleanupBoard( true, &items, false, true );
+
+    std::vector<CLEANUP_RESULT> found = Filter( items, { CLEANUP_NULL_GRAPHIC,
+                                                         CLEANUP_DUPLICATE_GRAPHIC } );
+    std::vector<CLEANUP_RESULT> expected = PairwiseDrawings();
+
+    BOOST_CHECK( !expected.empty() );
+    BOOST_CHECK_EQUAL_COLLECTIONS( found.begin(), found.end(), expected.begin(), expected.end() );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
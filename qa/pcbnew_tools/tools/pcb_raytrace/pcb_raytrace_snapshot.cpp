@@ -0,0 +1,264 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file pcb_raytrace_snapshot.cpp
+ * Headless 3D snapshots: renders a board with the raytracer from fixed camera views, with no
+ * window and no OpenGL context, reports timings and optionally writes the images to PNG.
+ */
+
+#include <pcbnew_utils/board_file_utils.h>
+
+#include <qa_utils/utility_registry.h>
+
+#include <class_board.h>
+#include <profile.h>
+#include <settings/color_settings.h>
+
+#include <3d_canvas/board_adapter.h>
+#include <3d_rendering/3d_render_raytracing/c3d_render_raytracing.h>
+#include <3d_rendering/ctrack_ball.h>
+
+#include <wx/cmdline.h>
+#include <wx/image.h>
+#include <wx/tokenzr.h>
+
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+
+
+/**
+ * Sets the camera for one of the named views.
+ * @return false if the view name is unknown.
+ */
+static bool setCameraView( CCAMERA& aCamera, const wxString& aView )
+{
+    aCamera.Reset();
+
+    if( aView == wxT( "top" ) )
+    {
+        // Reset() is the top view
+    }
+    else if( aView == wxT( "bottom" ) )
+    {
+        aCamera.RotateY( glm::radians( 179.999f ) );    // Rotation = 180 - epsilon
+    }
+    else if( aView == wxT( "iso" ) )
+    {
+        aCamera.RotateX( glm::radians( -45.0f ) );
+        aCamera.RotateZ( glm::radians( -30.0f ) );
+    }
+    else
+    {
+        return false;
+    }
+
+    return true;
+}
+
+
+/**
+ * Writes a rendered buffer (RGBA, bottom row first) to a PNG file.
+ */
+static bool writeSnapshot( const std::vector<unsigned char>& aBuffer, const SFVEC2UI& aSize,
+                           const wxString& aFileName )
+{
+    wxImage image( aSize.x, aSize.y, false );
+    unsigned char* rgb = image.GetData();
+
+    for( unsigned int y = 0; y < aSize.y; ++y )
+    {
+        // The raytracer uses the OpenGL row order
+        const unsigned char* src = &aBuffer[( aSize.y - 1 - y ) * aSize.x * 4];
+        unsigned char*       dst = rgb + y * aSize.x * 3;
+
+        for( unsigned int x = 0; x < aSize.x; ++x, src += 4, dst += 3 )
+            memcpy( dst, src, 3 );
+    }
+
+    return image.SaveFile( aFileName, wxBITMAP_TYPE_PNG );
+}
+
+
+static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
+    { wxCMD_LINE_SWITCH, "h", "help", _( "displays help on the command line parameters" ).mb_str(),
+            wxCMD_LINE_VAL_NONE, wxCMD_LINE_OPTION_HELP },
+    { wxCMD_LINE_SWITCH, "f", "fast", _( "disable post processing and anti-aliasing" ).mb_str() },
+    { wxCMD_LINE_OPTION, "s", "size", _( "image size in pixels (default 1280x960)" ).mb_str(),
+            wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL },
+    { wxCMD_LINE_OPTION, "w", "views",
+            _( "comma separated views: top, bottom, iso (default top,bottom,iso)" ).mb_str(),
+            wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL },
+    { wxCMD_LINE_OPTION, "o", "output", _( "write <prefix>_<view>.png snapshots" ).mb_str(),
+            wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL },
+    { wxCMD_LINE_PARAM, nullptr, nullptr, _( "input board file" ).mb_str(),
+            wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL },
+    { wxCMD_LINE_NONE }
+};
+
+
+enum RAYTRACE_SNAPSHOT_RET_CODES
+{
+    LOAD_FAILED = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+    WRITE_FAILED,
+};
+
+
+int pcb_raytrace_snapshot_main( int argc, char** argv )
+{
+    wxMessageOutput::Set( new wxMessageOutputStderr );
+    wxCmdLineParser cl_parser( argc, argv );
+    cl_parser.SetDesc( g_cmdLineDesc );
+    cl_parser.AddUsageText(
+            _( "This program renders a PCB file with the 3D raytracer, without any window "
+               "or OpenGL context, from a set of fixed camera views. It reports the scene "
+               "building and rendering times and can write the images to PNG files." ) );
+
+    int cmd_parsed_ok = cl_parser.Parse();
+
+    if( cmd_parsed_ok != 0 )
+    {
+        // Help and invalid input both stop here
+        return ( cmd_parsed_ok == -1 ) ? KI_TEST::RET_CODES::OK : KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    long width = 1280;
+    long height = 960;
+    wxString size;
+
+    if( cl_parser.Found( "size", &size ) )
+    {
+        wxString w = size.BeforeFirst( 'x' );
+        wxString h = size.AfterFirst( 'x' );
+
+        if( !w.ToLong( &width ) || !h.ToLong( &height ) || width <= 0 || height <= 0 )
+            return KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    wxArrayString views;
+    wxString      viewList = wxT( "top,bottom,iso" );
+    cl_parser.Found( "views", &viewList );
+
+    wxStringTokenizer tokenizer( viewList, wxT( "," ) );
+    CTRACK_BALL       camera( RANGE_SCALE_3D );
+
+    while( tokenizer.HasMoreTokens() )
+    {
+        wxString view = tokenizer.GetNextToken();
+
+        if( !setCameraView( camera, view ) )
+            return KI_TEST::RET_CODES::BAD_CMDLINE;
+
+        views.Add( view );
+    }
+
+    wxString outputPrefix;
+    cl_parser.Found( "output", &outputPrefix );
+
+    if( !outputPrefix.IsEmpty() && !wxImage::FindHandler( wxBITMAP_TYPE_PNG ) )
+        wxImage::AddHandler( new wxPNGHandler );
+
+    std::string filename;
+
+    if( cl_parser.GetParamCount() )
+        filename = cl_parser.GetParam( 0 ).ToStdString();
+
+    PROF_COUNTER loadTimer;
+    std::unique_ptr<BOARD> board = KI_TEST::ReadBoardFromFileOrStream( filename );
+
+    if( !board )
+        return RAYTRACE_SNAPSHOT_RET_CODES::LOAD_FAILED;
+
+    std::cout << "Board loaded in " << loadTimer.msecs() << " ms" << std::endl;
+
+    const bool     fast = cl_parser.Found( "fast" );
+    COLOR_SETTINGS colors;
+    BOARD_ADAPTER  adapter;
+
+    colors.ResetToDefaults();
+    adapter.SetBoard( board.get() );
+    adapter.SetColorSettings( &colors );
+    adapter.RenderEngineSet( RENDER_ENGINE::RAYTRACING );
+
+    // The same layers as the default realistic view of the 3D viewer
+    for( DISPLAY3D_FLG flag : { FL_ZONE, FL_SILKSCREEN, FL_SOLDERMASK, FL_SOLDERPASTE,
+                                FL_SHOW_BOARD_BODY, FL_USE_REALISTIC_MODE,
+                                FL_SUBTRACT_MASK_FROM_SILK, FL_CLIP_SILK_ON_VIA_ANNULUS,
+                                FL_RENDER_PLATED_PADS_AS_PLATED,
+                                FL_MODULE_ATTRIBUTES_NORMAL, FL_MODULE_ATTRIBUTES_NORMAL_INSERT,
+                                FL_RENDER_RAYTRACING_SHADOWS,
+                                FL_RENDER_RAYTRACING_PROCEDURAL_TEXTURES } )
+    {
+        adapter.SetFlag( flag, true );
+    }
+
+    adapter.SetFlag( FL_RENDER_RAYTRACING_POST_PROCESSING, !fast );
+    adapter.SetFlag( FL_RENDER_RAYTRACING_ANTI_ALIASING, !fast );
+
+    C3D_RENDER_RAYTRACING renderer( adapter, camera );
+
+    PROF_COUNTER sceneTimer;
+    renderer.Reload( nullptr, nullptr, false );
+    std::cout << "Scene built in " << sceneTimer.msecs() << " ms" << std::endl;
+
+    bool                       writeOk = true;
+    std::vector<unsigned char> buffer;
+
+    for( const wxString& view : views )
+    {
+        setCameraView( camera, view );
+
+        PROF_COUNTER renderTimer;
+        SFVEC2UI     imageSize = renderer.RenderToBuffer( wxSize( width, height ), buffer,
+                                                          nullptr, nullptr );
+        double       renderMs = renderTimer.msecs();
+
+        std::cout << std::fixed << std::setprecision( 2 ) << view.ToStdString() << ": "
+                  << imageSize.x << "x" << imageSize.y << " rendered in " << renderMs << " ms"
+                  << std::endl;
+
+        if( !outputPrefix.IsEmpty() )
+        {
+            wxString outFile = outputPrefix + wxT( "_" ) + view + wxT( ".png" );
+
+            if( !writeSnapshot( buffer, imageSize, outFile ) )
+            {
+                std::cerr << "Cannot write " << outFile.ToStdString() << std::endl;
+                writeOk = false;
+            }
+        }
+    }
+
+    if( !writeOk )
+        return RAYTRACE_SNAPSHOT_RET_CODES::WRITE_FAILED;
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+static bool registered = UTILITY_REGISTRY::Register( {
+        "pcb_raytrace_snapshot",
+        "Render a PCB with the 3D raytracer, without OpenGL, and report timings",
+        pcb_raytrace_snapshot_main,
+} );
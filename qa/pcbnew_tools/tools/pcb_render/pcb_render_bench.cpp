@@ -0,0 +1,408 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file pcb_render_bench.cpp
+ * Headless rendering benchmark: draws a board with PCB_PAINTER into an offscreen Cairo
+ * image surface, reports timings and optionally writes/compares PNG snapshots.
+ */
+
+#include <pcbnew_utils/board_file_utils.h>
+
+#include <qa_utils/utility_registry.h>
+
+#include <class_board.h>
+#include <layers_id_colors_and_visibility.h>
+#include <pcb_painter.h>
+#include <pcb_view.h>
+#include <profile.h>
+#include <settings/color_settings.h>
+
+#include <gal/cairo/cairo_gal.h>
+#include <gal/gal_display_options.h>
+
+#include <wx/cmdline.h>
+#include <wx/tokenzr.h>
+
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <map>
+
+
+/**
+ * A Cairo GAL drawing into an image surface in memory, with no window and no compositor.
+ */
+class OFFSCREEN_CAIRO_GAL : public KIGFX::CAIRO_GAL_BASE
+{
+public:
+    OFFSCREEN_CAIRO_GAL( KIGFX::GAL_DISPLAY_OPTIONS& aOptions, int aWidth, int aHeight ) :
+            CAIRO_GAL_BASE( aOptions )
+    {
+        surface = cairo_image_surface_create( GAL_FORMAT, aWidth, aHeight );
+        context = currentContext = cairo_create( surface );
+        ResizeScreen( aWidth, aHeight );
+    }
+
+    ~OFFSCREEN_CAIRO_GAL()
+    {
+        // The cached groups are freed while the context is still valid
+        ClearCache();
+
+        cairo_destroy( context );
+        cairo_surface_destroy( surface );
+
+        // Released here, so CAIRO_GAL_BASE does not destroy them again
+        context = currentContext = nullptr;
+        surface = nullptr;
+    }
+
+    cairo_surface_t* GetSurface() const
+    {
+        return surface;
+    }
+};
+
+
+struct FRAME_STATS
+{
+    double m_painterMs = 0.0;   ///< Time spent by the painter (re)building the cached groups
+    double m_backendMs = 0.0;   ///< Time spent by Cairo rasterizing the groups
+};
+
+
+/**
+ * Counts the items that intersect the current viewport, per view layer.
+ */
+static std::map<int, int> countItemsPerLayer( const KIGFX::VIEW& aView )
+{
+    std::vector<KIGFX::VIEW::LAYER_ITEM_PAIR> items;
+    std::map<int, int>                        counts;
+    BOX2D                                     viewport = aView.GetViewport();
+
+    aView.Query( BOX2I( viewport.GetPosition(), viewport.GetSize() ), items );
+
+    for( const KIGFX::VIEW::LAYER_ITEM_PAIR& item : items )
+        counts[item.second]++;
+
+    return counts;
+}
+
+
+/**
+ * Renders one frame: recaches all the items through the painter, then redraws the view.
+ */
+static FRAME_STATS renderFrame( KIGFX::VIEW& aView, OFFSCREEN_CAIRO_GAL& aGal )
+{
+    FRAME_STATS stats;
+
+    // Recaching and updating the items covers all the painter work
+    PROF_COUNTER painterTimer;
+    aView.RecacheAllItems();
+    aView.UpdateItems();
+    stats.m_painterMs = painterTimer.msecs();
+
+    PROF_COUNTER backendTimer;
+
+    {
+        KIGFX::GAL_DRAWING_CONTEXT ctx( &aGal );
+        aView.Redraw();
+    }
+
+    cairo_surface_flush( aGal.GetSurface() );
+    stats.m_backendMs = backendTimer.msecs();
+
+    return stats;
+}
+
+
+/**
+ * Compares the rendered image with a reference PNG.
+ * @return the fraction of pixels that differ (by more than a small tolerance per channel),
+ * or a negative value if the reference cannot be used.
+ */
+static double compareWithReference( cairo_surface_t* aImage, const std::string& aReference )
+{
+    cairo_surface_t* ref = cairo_image_surface_create_from_png( aReference.c_str() );
+    double           result = -1.0;
+
+    if( cairo_surface_status( ref ) == CAIRO_STATUS_SUCCESS
+            && cairo_image_surface_get_format( ref ) == cairo_image_surface_get_format( aImage )
+            && cairo_image_surface_get_width( ref ) == cairo_image_surface_get_width( aImage )
+            && cairo_image_surface_get_height( ref ) == cairo_image_surface_get_height( aImage ) )
+    {
+        const int TOLERANCE = 8;
+        int       width = cairo_image_surface_get_width( aImage );
+        int       height = cairo_image_surface_get_height( aImage );
+        int       strideA = cairo_image_surface_get_stride( aImage );
+        int       strideB = cairo_image_surface_get_stride( ref );
+        long      differing = 0;
+
+        cairo_surface_flush( ref );
+        const unsigned char* dataA = cairo_image_surface_get_data( aImage );
+        const unsigned char* dataB = cairo_image_surface_get_data( ref );
+
+        for( int y = 0; y < height; ++y )
+        {
+            const unsigned char* rowA = dataA + y * strideA;
+            const unsigned char* rowB = dataB + y * strideB;
+
+            for( int x = 0; x < width * 4; x += 4 )
+            {
+                for( int c = 0; c < 4; ++c )
+                {
+                    if( std::abs( rowA[x + c] - rowB[x + c] ) > TOLERANCE )
+                    {
+                        differing++;
+                        break;
+                    }
+                }
+            }
+        }
+
+        result = (double) differing / ( (double) width * height );
+    }
+
+    cairo_surface_destroy( ref );
+
+    return result;
+}
+
+
+static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
+    { wxCMD_LINE_SWITCH, "h", "help", _( "displays help on the command line parameters" ).mb_str(),
+            wxCMD_LINE_VAL_NONE, wxCMD_LINE_OPTION_HELP },
+    { wxCMD_LINE_SWITCH, "v", "verbose", _( "print per-layer item counts" ).mb_str() },
+    { wxCMD_LINE_OPTION, "s", "size", _( "image size in pixels (default 1920x1080)" ).mb_str(),
+            wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL },
+    { wxCMD_LINE_OPTION, "z", "zoom",
+            _( "comma separated zoom levels, relative to zoom to fit (default 1,4,16)" ).mb_str(),
+            wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL },
+    { wxCMD_LINE_OPTION, "n", "frames", _( "frames rendered per zoom level (default 3)" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER, wxCMD_LINE_PARAM_OPTIONAL },
+    { wxCMD_LINE_OPTION, "o", "output", _( "write <prefix>_z<zoom>.png snapshots" ).mb_str(),
+            wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL },
+    { wxCMD_LINE_OPTION, "r", "reference",
+            _( "compare snapshots with <prefix>_z<zoom>.png reference images" ).mb_str(),
+            wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL },
+    { wxCMD_LINE_PARAM, nullptr, nullptr, _( "input board file" ).mb_str(),
+            wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL },
+    { wxCMD_LINE_NONE }
+};
+
+
+enum RENDER_BENCH_RET_CODES
+{
+    LOAD_FAILED = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+    IMAGE_MISMATCH,
+};
+
+
+int pcb_render_bench_main( int argc, char** argv )
+{
+    wxMessageOutput::Set( new wxMessageOutputStderr );
+    wxCmdLineParser cl_parser( argc, argv );
+    cl_parser.SetDesc( g_cmdLineDesc );
+    cl_parser.AddUsageText(
+            _( "This program renders a PCB file through the PCB painter into an offscreen "
+               "Cairo image and reports the rendering times. It can write the images to PNG "
+               "files and compare them with reference images." ) );
+
+    int cmd_parsed_ok = cl_parser.Parse();
+
+    if( cmd_parsed_ok != 0 )
+    {
+        // Help and invalid input both stop here
+        return ( cmd_parsed_ok == -1 ) ? KI_TEST::RET_CODES::OK : KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    const bool verbose = cl_parser.Found( "verbose" );
+
+    long width = 1920;
+    long height = 1080;
+    wxString size;
+
+    if( cl_parser.Found( "size", &size ) )
+    {
+        wxString w = size.BeforeFirst( 'x' );
+        wxString h = size.AfterFirst( 'x' );
+
+        if( !w.ToLong( &width ) || !h.ToLong( &height ) || width <= 0 || height <= 0 )
+            return KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    std::vector<double> zoomLevels;
+    wxString            zoomList = wxT( "1,4,16" );
+    cl_parser.Found( "zoom", &zoomList );
+
+    wxStringTokenizer tokenizer( zoomList, wxT( "," ) );
+
+    while( tokenizer.HasMoreTokens() )
+    {
+        double zoom;
+
+        if( !tokenizer.GetNextToken().ToCDouble( &zoom ) || zoom <= 0.0 )
+            return KI_TEST::RET_CODES::BAD_CMDLINE;
+
+        zoomLevels.push_back( zoom );
+    }
+
+    long frames = 3;
+    cl_parser.Found( "frames", &frames );
+    frames = std::max( frames, 1L );
+
+    wxString outputPrefix;
+    wxString referencePrefix;
+    cl_parser.Found( "output", &outputPrefix );
+    cl_parser.Found( "reference", &referencePrefix );
+
+    std::string filename;
+
+    if( cl_parser.GetParamCount() )
+        filename = cl_parser.GetParam( 0 ).ToStdString();
+
+    PROF_COUNTER loadTimer;
+    std::unique_ptr<BOARD> board = KI_TEST::ReadBoardFromFileOrStream( filename );
+
+    if( !board )
+        return RENDER_BENCH_RET_CODES::LOAD_FAILED;
+
+    std::cout << "Board loaded in " << loadTimer.msecs() << " ms" << std::endl;
+
+    KIGFX::GAL_DISPLAY_OPTIONS options;
+    OFFSCREEN_CAIRO_GAL        gal( options, width, height );
+    KIGFX::PCB_PAINTER         painter( &gal );
+    KIGFX::PCB_VIEW            view( true );
+    COLOR_SETTINGS             colors;
+
+    colors.ResetToDefaults();
+    painter.GetSettings()->LoadColors( &colors );
+    gal.SetClearColor( painter.GetSettings()->GetBackgroundColor() );
+
+    view.SetGAL( &gal );
+    view.SetPainter( &painter );
+    view.SetScaleLimits( 10e9, 1e-9 );
+
+    for( BOARD_ITEM* drawing : board->Drawings() )
+        view.Add( drawing );
+
+    for( TRACK* track : board->Tracks() )
+        view.Add( track );
+
+    for( MODULE* module : board->Modules() )
+        view.Add( module );
+
+    for( ZONE_CONTAINER* zone : board->Zones() )
+        view.Add( zone );
+
+    // Zoom to fit the board
+    EDA_RECT bbox = board->ComputeBoundingBox();
+    view.SetScale( 1.0 );
+    VECTOR2D screenSize = view.ToWorld( gal.GetScreenPixelSize(), false );
+    double   fitScale = 1.0;
+
+    if( bbox.GetWidth() > 0 && bbox.GetHeight() > 0 )
+    {
+        fitScale = std::min( std::fabs( screenSize.x / bbox.GetWidth() ),
+                             std::fabs( screenSize.y / bbox.GetHeight() ) );
+    }
+
+    bool imagesMatch = true;
+
+    for( double zoom : zoomLevels )
+    {
+        view.SetScale( fitScale * zoom );
+        view.SetCenter( VECTOR2D( bbox.Centre() ) );
+
+        FRAME_STATS total;
+
+        for( long i = 0; i < frames; ++i )
+        {
+            FRAME_STATS stats = renderFrame( view, gal );
+            total.m_painterMs += stats.m_painterMs;
+            total.m_backendMs += stats.m_backendMs;
+        }
+
+        std::cout << std::fixed << std::setprecision( 2 ) << "zoom " << zoom << ": "
+                  << ( total.m_painterMs + total.m_backendMs ) / frames << " ms/frame (painter "
+                  << total.m_painterMs / frames << " ms, backend "
+                  << total.m_backendMs / frames << " ms)" << std::endl;
+
+        if( verbose )
+        {
+            for( const std::pair<const int, int>& layerCount : countItemsPerLayer( view ) )
+            {
+                std::cout << "    layer " << std::setw( 3 ) << layerCount.first << ": "
+                          << layerCount.second << " items" << std::endl;
+            }
+        }
+
+        wxString suffix = wxString::Format( wxT( "_z%g.png" ), zoom );
+
+        if( !outputPrefix.IsEmpty() )
+        {
+            std::string outFile = ( outputPrefix + suffix ).ToStdString();
+
+            if( cairo_surface_write_to_png( gal.GetSurface(), outFile.c_str() )
+                    != CAIRO_STATUS_SUCCESS )
+            {
+                std::cerr << "Cannot write " << outFile << std::endl;
+            }
+        }
+
+        if( !referencePrefix.IsEmpty() )
+        {
+            std::string refFile = ( referencePrefix + suffix ).ToStdString();
+            double      diff = compareWithReference( gal.GetSurface(), refFile );
+
+            // Allow a tiny amount of antialiasing noise
+            if( diff < 0.0 || diff > 0.001 )
+            {
+                std::cerr << "Image differs from " << refFile;
+
+                if( diff >= 0.0 )
+                    std::cerr << " (" << diff * 100.0 << "% of the pixels)";
+
+                std::cerr << std::endl;
+                imagesMatch = false;
+            }
+        }
+    }
+
+    // Board items unregister themselves from the view when deleted, so the board has to go
+    // first
+    board.reset();
+
+    if( !imagesMatch )
+        return RENDER_BENCH_RET_CODES::IMAGE_MISMATCH;
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+static bool registered = UTILITY_REGISTRY::Register( {
+        "pcb_render_bench",
+        "Render a PCB offscreen with Cairo and report timings",
+        pcb_render_bench_main,
+} );